@@ -39,6 +39,7 @@
 #include <vector>
 #include <stdio.h>
 #include <fcntl.h>
+#include <chrono>
 
 #include "DecApp.h"
 #include "DecoderLib/AnnexBread.h"
@@ -109,6 +110,8 @@ uint32_t DecApp::decode()
   // create & initialize internal classes
   xCreateDecLib();
 
+  const auto parseStartTime = std::chrono::steady_clock::now();
+
   m_iPOCLastDisplay += m_iSkipFrame;      // set the last displayed POC correctly for skip forward.
 
   // clear contents of colour-remap-information-SEI output file
@@ -334,6 +337,13 @@ uint32_t DecApp::decode()
   // get the number of checksum errors
   uint32_t nRet = m_cDecLib.getNumberOfChecksumErrorsDetected();
 
+  if( m_parseOnly )
+  {
+    const double   parseTime = std::chrono::duration<double>( std::chrono::steady_clock::now() - parseStartTime ).count();
+    const uint64_t numBins   = m_cDecLib.getNumBinsDecoded();
+    msg( INFO, "\nParsed %llu bins in %.3f sec. (%.3f Mbins/sec.)\n", (unsigned long long)numBins, parseTime, parseTime > 0 ? numBins / parseTime * 1e-6 : 0.0 );
+  }
+
   // delete buffers
   m_cDecLib.deletePicBuffer();
   // destroy internal classes
@@ -764,6 +774,7 @@ void DecApp::xCreateDecLib()
 #endif
   );
   m_cDecLib.setDecodedPictureHashSEIEnabled(m_decodedPictureHashSEIEnabled);
+  m_cDecLib.setParseOnly(m_parseOnly);
 
 
   if (!m_outputDecodedSEIMessagesFilename.empty())
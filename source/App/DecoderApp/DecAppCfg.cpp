@@ -121,6 +121,7 @@ bool DecAppCfg::parseCfg( int argc, char* argv[] )
   ("targetSubPicIdx",          m_targetSubPicIdx,                     0,           "Specify which subpicture shall be written to output, using subpic index, 0: disabled, subpicIdx=m_targetSubPicIdx-1 \n" )
 #endif
   ( "UpscaledOutput",          m_upscaledOutput,                          0,       "Upscaled output for RPR" )
+  ("ParseOnly",                m_parseOnly,                           false,       "Benchmark mode: only parse the bitstream (no reconstruction, loop filters or output) and report the CABAC bins/second")
   ;
 
   po::setDefaults(opts);
@@ -158,6 +159,15 @@ bool DecAppCfg::parseCfg( int argc, char* argv[] )
 #endif
 
   g_mctsDecCheckEnabled = m_mctsCheck;
+  if( m_parseOnly )
+  {
+    if( !m_reconFileName.empty() )
+    {
+      msg( WARNING, "ReconFile is ignored in parse-only mode\n" );
+      m_reconFileName.clear();
+    }
+    m_decodedPictureHashSEIEnabled = 0;
+  }
   // Chroma output bit-depth
   if( m_outputBitDepth[CHANNEL_TYPE_LUMA] != 0 && m_outputBitDepth[CHANNEL_TYPE_CHROMA] == 0 )
   {
@@ -245,6 +255,7 @@ DecAppCfg::DecAppCfg()
 , m_packedYUVMode(false)
 , m_statMode(0)
 , m_mctsCheck(false)
+, m_parseOnly(false)
 {
   for (uint32_t channelTypeIndex = 0; channelTypeIndex < MAX_NUM_CHANNEL_TYPE; channelTypeIndex++)
   {
@@ -81,6 +81,7 @@ protected:
   std::string   m_cacheCfgFile;                       ///< Config file of cache model
   int           m_statMode;                           ///< Config statistic mode (0 - bit stat, 1 - tool stat, 3 - both)
   bool          m_mctsCheck;
+  bool          m_parseOnly;                          ///< parse the bitstream without reconstruction and report the CABAC bin throughput
 
   int          m_upscaledOutput;                     ////< Output upscaled (2), decoded but in full resolution buffer (1) or decoded cropped (0, default) picture for RPR.
 #if JVET_O1143_SUBPIC_BOUNDARY
@@ -45,6 +45,9 @@
 #include "EncApp.h"
 #include "EncoderLib/AnnexBwrite.h"
 #include "EncoderLib/EncLibCommon.h"
+#include "LambdaModifierSearch.h"
+
+#include <thread>
 
 // Arthur
 #include "EncoderLib/MemoryTracer.h"
@@ -70,6 +73,8 @@ EncApp::EncApp( fstream& bitStream, EncLibCommon* encLibCommon )
 #endif
   m_numEncoded = 0;
   m_flush = false;
+  m_trainingOrgPics = nullptr;
+  m_trainingTrueOrgPics = nullptr;
 }
 
 EncApp::~EncApp()
@@ -408,6 +413,7 @@ void EncApp::xInitLibCfg()
 #else
   m_cEncLib.setDeltaQpRD                                         ( m_uiDeltaQpRD  );
 #endif
+  m_cEncLib.setDeltaQpRDEarlyTerm                                ( m_deltaQpRDEarlyTerm );
   m_cEncLib.setFastDeltaQp                                       ( m_bFastDeltaQP  );
   m_cEncLib.setUseASR                                            ( m_bUseASR      );
   m_cEncLib.setUseHADME                                          ( m_bUseHADME    );
@@ -914,21 +920,24 @@ void EncApp::xInitLibCfg()
 
 void EncApp::xCreateLib( std::list<PelUnitBuf*>& recBufList, const int layerId )
 {
-  // Video I/O
-  m_cVideoIOYuvInputFile.open( m_inputFileName,     false, m_inputBitDepth, m_MSBExtendedBitDepth, m_internalBitDepth );  // read  mode
+  // Video I/O, trial encodings of the lambda modifier search read preloaded pictures and write no reconstruction
+  if( m_trainingOrgPics == nullptr )
+  {
+    m_cVideoIOYuvInputFile.open( m_inputFileName,     false, m_inputBitDepth, m_MSBExtendedBitDepth, m_internalBitDepth );  // read  mode
 
 // Arthur
 #if MEM_TRACE_EN
-  MemoryTracer::setVideoSequence(m_inputFileName);
+    MemoryTracer::setVideoSequence(m_inputFileName);
 #endif
 
 #if EXTENSION_360_VIDEO
-  m_cVideoIOYuvInputFile.skipFrames(m_FrameSkip, m_inputFileWidth, m_inputFileHeight, m_InputChromaFormatIDC);
+    m_cVideoIOYuvInputFile.skipFrames(m_FrameSkip, m_inputFileWidth, m_inputFileHeight, m_InputChromaFormatIDC);
 #else
-  const int sourceHeight = m_isField ? m_iSourceHeightOrg : m_iSourceHeight;
-  m_cVideoIOYuvInputFile.skipFrames(m_FrameSkip, m_iSourceWidth - m_aiPad[0], sourceHeight - m_aiPad[1], m_InputChromaFormatIDC);
+    const int sourceHeight = m_isField ? m_iSourceHeightOrg : m_iSourceHeight;
+    m_cVideoIOYuvInputFile.skipFrames(m_FrameSkip, m_iSourceWidth - m_aiPad[0], sourceHeight - m_aiPad[1], m_InputChromaFormatIDC);
 #endif
-  if (!m_reconFileName.empty())
+  }
+  if (!m_reconFileName.empty() && m_trainingOrgPics == nullptr)
   {
     if (m_packedYUVMode && ((m_outputBitDepth[CH_L] != 10 && m_outputBitDepth[CH_L] != 12)
         || ((m_iSourceWidth & (1 + (m_outputBitDepth[CH_L] & 3))) != 0)))
@@ -996,7 +1005,7 @@ void EncApp::createLib( const int layerIdx )
   m_orgPic->create( unitArea );
   m_trueOrgPic->create( unitArea );
 
-  if( !m_bitstream.is_open() )
+  if( !m_bitstream.is_open() && m_trainingOrgPics == nullptr )
   {
     m_bitstream.open( m_bitstreamFileName.c_str(), fstream::binary | fstream::out );
     if( !m_bitstream )
@@ -1035,13 +1044,26 @@ void EncApp::createLib( const int layerIdx )
       m_inputColourSpaceConvert, m_iQP, m_gopBasedTemporalFilterStrengths,
       m_gopBasedTemporalFilterFutureReference );
   }
+
+  if( m_RCEnableRateControl && m_RCLookahead > 0 )
+  {
+    m_rcLookahead.init( m_FrameSkip, m_temporalSubsampleRatio, m_inputBitDepth, m_MSBExtendedBitDepth, m_internalBitDepth, m_iSourceWidth, m_iSourceHeight,
+      m_aiPad, m_bClipInputVideoToRec709Range, m_inputFileName, m_chromaFormatIDC, m_InputChromaFormatIDC,
+      m_inputColourSpaceConvert, m_uiCTUSize, m_framesToBeEncoded, m_RCLookahead );
+    m_cEncLib.setRCLookahead( &m_rcLookahead );
+  }
 }
 
 void EncApp::destroyLib()
 {
-  printf( "\nLayerId %2d", m_cEncLib.getLayerId() );
+  if( m_trainingOrgPics == nullptr )
+  {
+    printf( "\nLayerId %2d", m_cEncLib.getLayerId() );
+
+    m_cEncLib.printSummary( m_isField );
+  }
 
-  m_cEncLib.printSummary( m_isField );
+  m_rcLookahead.destroy();
 
   // delete used buffers in encoder class
   m_cEncLib.deletePicBuffer();
@@ -1067,7 +1089,10 @@ void EncApp::destroyLib()
   delete m_ext360;
 #endif
 
-  printRateSummary();
+  if( m_trainingOrgPics == nullptr )
+  {
+    printRateSummary();
+  }
 
   // Arthur
   #if MEM_TRACE_EN
@@ -1082,18 +1107,29 @@ bool EncApp::encodePrep( bool& eos )
   const InputColourSpaceConversion snrCSC = ( !m_snrInternalColourSpace ) ? m_inputColourSpaceConvert : IPCOLOURSPACE_UNCHANGED;
 
   // read input YUV file
-#if EXTENSION_360_VIDEO
-  if( m_ext360->isEnabled() )
+  if( m_trainingOrgPics )
   {
-    m_ext360->read( m_cVideoIOYuvInputFile, *m_orgPic, *m_trueOrgPic, ipCSC );
+    if( m_iFrameRcvd < (int)m_trainingOrgPics->size() )
+    {
+      m_orgPic->copyFrom( *( *m_trainingOrgPics )[m_iFrameRcvd] );
+      m_trueOrgPic->copyFrom( *( *m_trainingTrueOrgPics )[m_iFrameRcvd] );
+    }
   }
   else
   {
-    m_cVideoIOYuvInputFile.read( *m_orgPic, *m_trueOrgPic, ipCSC, m_aiPad, m_InputChromaFormatIDC, m_bClipInputVideoToRec709Range );
-  }
+#if EXTENSION_360_VIDEO
+    if( m_ext360->isEnabled() )
+    {
+      m_ext360->read( m_cVideoIOYuvInputFile, *m_orgPic, *m_trueOrgPic, ipCSC );
+    }
+    else
+    {
+      m_cVideoIOYuvInputFile.read( *m_orgPic, *m_trueOrgPic, ipCSC, m_aiPad, m_InputChromaFormatIDC, m_bClipInputVideoToRec709Range );
+    }
 #else
-  m_cVideoIOYuvInputFile.read( *m_orgPic, *m_trueOrgPic, ipCSC, m_aiPad, m_InputChromaFormatIDC, m_bClipInputVideoToRec709Range );
+    m_cVideoIOYuvInputFile.read( *m_orgPic, *m_trueOrgPic, ipCSC, m_aiPad, m_InputChromaFormatIDC, m_bClipInputVideoToRec709Range );
 #endif
+  }
 
   if( m_gopBasedTemporalFilterEnabled )
   {
@@ -1106,7 +1142,7 @@ bool EncApp::encodePrep( bool& eos )
   eos = ( m_isField && ( m_iFrameRcvd == ( m_framesToBeEncoded >> 1 ) ) ) || ( !m_isField && ( m_iFrameRcvd == m_framesToBeEncoded ) );
 
   // if end of file (which is only detected on a read failure) flush the encoder of any queued pictures
-  if( m_cVideoIOYuvInputFile.isEof() )
+  if( m_trainingOrgPics ? m_iFrameRcvd > (int)m_trainingOrgPics->size() : m_cVideoIOYuvInputFile.isEof() )
   {
     m_flush = true;
     eos = true;
@@ -1149,7 +1185,7 @@ bool EncApp::encode()
 #endif
 
   // output when the entire GOP was proccessed
-  if( !keepDoing )
+  if( !keepDoing && m_trainingOrgPics == nullptr )
   {
     // write bistream to file if necessary
     if( m_numEncoded > 0 )
@@ -1171,6 +1207,193 @@ bool EncApp::encode()
   return keepDoing;
 }
 
+/**
+  Searches the lambda modifiers of the temporal layers that reach LMSearchTargetBits, like the BitrateTargeting
+  utility but in-process: the training window is read once and the candidate modifiers of every iteration are
+  encoded concurrently by trial encoders parsed from the same command line.
+  \param argc  number of arguments the encoder was configured with
+  \param argv  arguments the encoder was configured with
+ */
+void EncApp::searchLambdaModifiers( int argc, char* argv[] )
+{
+  if( m_lmSearchTargetBits.empty() )
+  {
+    return;
+  }
+
+  // training window: the first intra picture followed by two GOPs unless given
+  const int numFrames = std::min( m_lmSearchFrames > 0 ? m_lmSearchFrames : 2 * m_iGOPSize + 1, m_framesToBeEncoded );
+  const UnitArea unitArea( m_chromaFormatIDC, Area( 0, 0, m_iSourceWidth, m_iSourceHeight ) );
+  std::vector<PelStorage*> orgPics;
+  std::vector<PelStorage*> trueOrgPics;
+
+  VideoIOYuv inputFile;
+  inputFile.open( m_inputFileName, false, m_inputBitDepth, m_MSBExtendedBitDepth, m_internalBitDepth );
+  inputFile.skipFrames( m_FrameSkip, m_iSourceWidth - m_aiPad[0], m_iSourceHeight - m_aiPad[1], m_InputChromaFormatIDC );
+  while( (int)orgPics.size() < numFrames )
+  {
+    orgPics.push_back( new PelStorage );
+    trueOrgPics.push_back( new PelStorage );
+    orgPics.back()->create( unitArea );
+    trueOrgPics.back()->create( unitArea );
+    inputFile.read( *orgPics.back(), *trueOrgPics.back(), m_inputColourSpaceConvert, m_aiPad, m_InputChromaFormatIDC, m_bClipInputVideoToRec709Range );
+    if( inputFile.isEof() )
+    {
+      orgPics.back()->destroy();
+      trueOrgPics.back()->destroy();
+      delete orgPics.back();
+      delete trueOrgPics.back();
+      orgPics.pop_back();
+      trueOrgPics.pop_back();
+      break;
+    }
+    if( m_temporalSubsampleRatio > 1 )
+    {
+      inputFile.skipFrames( m_temporalSubsampleRatio - 1, m_iSourceWidth - m_aiPad[0], m_iSourceHeight - m_aiPad[1], m_InputChromaFormatIDC );
+    }
+  }
+  inputFile.close();
+
+  // the trial encoders take the regular configuration, limited to the training window and without logging
+  std::vector<std::string> overrides;
+  overrides.push_back( "--FramesToBeEncoded=" + std::to_string( (int)orgPics.size() * m_temporalSubsampleRatio ) );
+  overrides.push_back( "--Verbosity=" + std::to_string( (int)ERROR ) );
+  std::vector<char*> trialArgv( argv, argv + argc );
+  for( std::string& option : overrides )
+  {
+    trialArgv.push_back( &option[0] );
+  }
+
+  const int numLayers = (int)m_lmSearchTargetBits.size();
+  const std::vector<double> initialLambdaModifiers( m_adLambdaModifier, m_adLambdaModifier + MAX_TLAYER );
+  LambdaModifierSearch search( m_lmSearchTargetBits, m_lmSearchTolerance );
+  std::mutex libMutex;
+
+  msg( INFO, "\nLambda modifier search on %d frames with %d trials per iteration\n", (int)orgPics.size(), m_lmSearchThreads );
+
+  for( int iter = 0; iter < m_lmSearchIterations && !search.isConverged(); iter++ )
+  {
+    std::vector<std::vector<double>> candidates;
+    search.getCandidates( initialLambdaModifiers, m_lmSearchThreads, candidates );
+
+    // trial encoders are set up sequentially, the configuration parser and the verbosity are shared
+    std::vector<std::fstream> bitstreams( candidates.size() );
+    std::vector<EncLibCommon> encLibCommons( candidates.size() );
+    std::vector<EncApp*>      trials( candidates.size() );
+    std::vector<std::thread>  threads;
+
+    for( int cand = 0; cand < (int)candidates.size(); cand++ )
+    {
+      trials[cand] = new EncApp( bitstreams[cand], &encLibCommons[cand] );
+      trials[cand]->create();
+      if( !trials[cand]->parseCfg( (int)trialArgv.size(), &trialArgv[0] ) )
+      {
+        EXIT( "Failed to configure the lambda modifier search trial encoder\n" );
+      }
+      std::copy( candidates[cand].begin(), candidates[cand].end(), trials[cand]->m_adLambdaModifier );
+      trials[cand]->m_trainingOrgPics     = &orgPics;
+      trials[cand]->m_trainingTrueOrgPics = &trueOrgPics;
+    }
+    for( EncApp* trial : trials )
+    {
+      threads.push_back( std::thread( &EncApp::xEncodeTrial, trial, std::ref( libMutex ) ) );
+    }
+    for( std::thread& thread : threads )
+    {
+      thread.join();
+    }
+    g_verbosity = MsgLevel( m_verbosity );
+
+    for( int cand = 0; cand < (int)candidates.size(); cand++ )
+    {
+      EncApp* trial = trials[cand];
+      if( !trial->m_trainingError.empty() )
+      {
+        EXIT( "Lambda modifier search trial failed: " << trial->m_trainingError );
+      }
+      if( (int)trial->m_trainingNumPics.size() != numLayers
+        || std::find( trial->m_trainingNumPics.begin(), trial->m_trainingNumPics.end(), 0 ) != trial->m_trainingNumPics.end() )
+      {
+        EXIT( "LMSearchTargetBits needs one target per temporal layer, the training window codes inter pictures in " << trial->m_trainingNumPics.size() << " layers\n" );
+      }
+
+      LambdaModifierSearch::Trial result;
+      result.lambdaModifiers = candidates[cand];
+      for( int layer = 0; layer < numLayers; layer++ )
+      {
+        result.bits.push_back( trial->m_trainingBits[layer] / trial->m_trainingNumPics[layer] );
+      }
+      search.addTrial( result );
+
+      trial->destroy();
+      delete trial;
+    }
+    search.finishIteration();
+
+    const LambdaModifierSearch::Trial& best = search.getBestTrial();
+    msg( INFO, "Iteration %2d:", iter + 1 );
+    for( int layer = 0; layer < numLayers; layer++ )
+    {
+      msg( INFO, "  LM%d %.6f (%+.2f%%)", layer, best.lambdaModifiers[layer], 100.0 * search.getDeviation( best, layer ) );
+    }
+    msg( INFO, "\n" );
+  }
+
+  if( !search.isConverged() )
+  {
+    msg( WARNING, "Lambda modifier search did not reach the target bits within %.2f%%, using the closest trial\n", 100.0 * m_lmSearchTolerance );
+  }
+
+  const LambdaModifierSearch::Trial& best = search.getBestTrial();
+  std::copy( best.lambdaModifiers.begin(), best.lambdaModifiers.end(), m_adLambdaModifier );
+  for( int layer = 0; layer < numLayers; layer++ )
+  {
+    msg( INFO, "LambdaModifier%d : %.6f\n", layer, m_adLambdaModifier[layer] );
+  }
+
+  for( int i = 0; i < (int)orgPics.size(); i++ )
+  {
+    orgPics[i]->destroy();
+    trueOrgPics[i]->destroy();
+    delete orgPics[i];
+    delete trueOrgPics[i];
+  }
+}
+
+void EncApp::xEncodeTrial( std::mutex& libMutex )
+{
+  try
+  {
+    {
+      // the encoder library initializes shared function tables on creation
+      std::lock_guard<std::mutex> lock( libMutex );
+      createLib( 0 );
+    }
+
+    bool eos = false;
+    while( !eos )
+    {
+      while( encodePrep( eos ) )
+      {
+      }
+      while( encode() )
+      {
+      }
+    }
+
+    std::lock_guard<std::mutex> lock( libMutex );
+    destroyLib();
+  }
+  catch( Exception& e )
+  {
+    m_trainingError = e.what();
+  }
+  catch( const std::bad_alloc& e )
+  {
+    m_trainingError = std::string( "Memory allocation failed: " ) + e.what();
+  }
+}
+
 // ====================================================================================================================
 // Protected member functions
 // ====================================================================================================================
@@ -1236,7 +1459,13 @@ void EncApp::xWriteOutput( int iNumEncoded, std::list<PelUnitBuf*>& recBufList )
 
 void EncApp::outputAU( const AccessUnit& au )
 {
+  // the bitstream of a trial encoding is not opened, only the Annex B sizes are used
   const vector<uint32_t>& stats = writeAnnexB(m_bitstream, au);
+  if( m_trainingOrgPics )
+  {
+    xTrainingStatsAccum( au, stats );
+    return;
+  }
   rateStatsAccum(au, stats);
   m_bitstream.flush();
 }
@@ -1283,6 +1512,39 @@ void EncApp::rateStatsAccum(const AccessUnit& au, const std::vector<uint32_t>& a
   }
 }
 
+/**
+ * accumulates the bits of the inter pictures per temporal layer in a lambda modifier search trial
+ */
+void EncApp::xTrainingStatsAccum( const AccessUnit& au, const std::vector<uint32_t>& annexBsizes )
+{
+  uint32_t bits = 0;
+  int temporalId = -1;
+  bool isIrap = false;
+  AccessUnit::const_iterator it_au = au.begin();
+  vector<uint32_t>::const_iterator it_stats = annexBsizes.begin();
+
+  for (; it_au != au.end(); it_au++, it_stats++)
+  {
+    bits += 8 * *it_stats;
+    if( (*it_au)->m_nalUnitType <= NAL_UNIT_CODED_SLICE_GDR )
+    {
+      temporalId = temporalId < 0 ? (*it_au)->m_temporalId : temporalId;
+      isIrap |= (*it_au)->m_nalUnitType >= NAL_UNIT_CODED_SLICE_IDR_W_RADL;
+    }
+  }
+
+  if( temporalId >= 0 && !isIrap )
+  {
+    if( temporalId >= (int)m_trainingBits.size() )
+    {
+      m_trainingBits.resize( temporalId + 1, 0.0 );
+      m_trainingNumPics.resize( temporalId + 1, 0 );
+    }
+    m_trainingBits[temporalId] += bits;
+    m_trainingNumPics[temporalId]++;
+  }
+}
+
 void EncApp::printRateSummary()
 {
   double time = (double) m_iFrameRcvd / m_iFrameRate * m_temporalSubsampleRatio;
@@ -39,6 +39,7 @@
 #define __ENCAPP__
 
 #include <list>
+#include <mutex>
 #include <ostream>
 
 #include "EncoderLib/EncLib.h"
@@ -49,6 +50,7 @@
 #include "AppEncHelper360/TExt360AppEncTop.h"
 #endif
 #include "EncoderLib/EncTemporalFilter.h"
+#include "EncoderLib/EncRCLookahead.h"
 
 #if JVET_O0756_CALCULATE_HDRMETRICS
 #include <chrono>
@@ -90,6 +92,7 @@ private:
   void xWriteOutput     ( int iNumEncoded, std::list<PelUnitBuf*>& recBufList
                          );                      ///< write bitstream to file
   void rateStatsAccum   ( const AccessUnit& au, const std::vector<uint32_t>& stats);
+  void xTrainingStatsAccum( const AccessUnit& au, const std::vector<uint32_t>& stats );
   void printRateSummary ();
   void printChromaFormat();
 
@@ -101,8 +104,18 @@ private:
   TExt360AppEncTop*      m_ext360;
 #endif
   EncTemporalFilter      m_temporalFilter;
+  EncRCLookahead         m_rcLookahead;
   bool m_flush;
 
+  // lambda modifier search trial
+  const std::vector<PelStorage*>* m_trainingOrgPics;      ///< preloaded source pictures of a trial encoding, nullptr: regular encoding
+  const std::vector<PelStorage*>* m_trainingTrueOrgPics;
+  std::vector<double>    m_trainingBits;                  ///< bits of the non-IRAP access units per temporal layer
+  std::vector<int>       m_trainingNumPics;               ///< number of non-IRAP access units per temporal layer
+  std::string            m_trainingError;
+
+  void xEncodeTrial     ( std::mutex& libMutex );       ///< encodes the training window, run in a worker thread
+
 public:
   EncApp( fstream& bitStream, EncLibCommon* encLibCommon );
   virtual ~EncApp();
@@ -115,6 +128,8 @@ public:
 
   void  outputAU( const AccessUnit& au );
 
+  void  searchLambdaModifiers( int argc, char* argv[] );  ///< sets the lambda modifiers reaching LMSearchTargetBits on a training window
+
 #if JVET_O0756_CALCULATE_HDRMETRICS
   std::chrono::duration<long long, ratio<1, 1000000000>> getMetricTime()    const { return m_metricTime; };
 #endif
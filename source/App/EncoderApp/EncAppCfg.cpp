@@ -651,6 +651,7 @@ bool EncAppCfg::parseCfg( int argc, char* argv[] )
 
 
   SMultiValueInput<double> cfg_adIntraLambdaModifier         (0, std::numeric_limits<double>::max(), 0, MAX_TLAYER); ///< Lambda modifier for Intra pictures, one for each temporal layer. If size>temporalLayer, then use [temporalLayer], else if size>0, use [size()-1], else use m_adLambdaModifier.
+  SMultiValueInput<double> cfg_lmSearchTargetBits            (0, std::numeric_limits<double>::max(), 0, MAX_TLAYER);
 
 #if SHARP_LUMA_DELTA_QP
   const int defaultLumaLevelTodQp_QpChangePoints[]   =  {-3,  -2,  -1,   0,   1,   2,   3,   4,   5,   6};
@@ -1045,6 +1046,11 @@ bool EncAppCfg::parseCfg( int argc, char* argv[] )
   ("LambdaModifier6,-LM6",                            m_adLambdaModifier[ 6 ],                  ( double )1.0, "Lambda modifier for temporal layer 6. If LambdaModifierI is used, this will not affect intra pictures")
   ("LambdaModifierI,-LMI",                            cfg_adIntraLambdaModifier,    cfg_adIntraLambdaModifier, "Lambda modifiers for Intra pictures, comma separated, up to one the number of temporal layer. If entry for temporalLayer exists, then use it, else if some are specified, use the last, else use the standard LambdaModifiers.")
   ("IQPFactor,-IQF",                                  m_dIntraQpFactor,                                  -1.0, "Intra QP Factor for Lambda Computation. If negative, the default will scale lambda based on GOP size (unless LambdaFromQpEnable then IntraQPOffset is used instead)")
+  ("LMSearchTargetBits",                              cfg_lmSearchTargetBits,          cfg_lmSearchTargetBits, "Lambda modifier search: target average bits per non-intra picture of each temporal layer, comma separated. The LambdaModifiers reaching them on a training window are searched before encoding (empty: no search)")
+  ("LMSearchFrames",                                  m_lmSearchFrames,                                     0, "Lambda modifier search: number of frames of the training window (0: first intra picture and two GOPs)")
+  ("LMSearchIterations",                              m_lmSearchIterations,                                 8, "Lambda modifier search: maximum number of iterations")
+  ("LMSearchThreads",                                 m_lmSearchThreads,                                    4, "Lambda modifier search: number of candidate lambda modifier sets encoded in parallel per iteration")
+  ("LMSearchTolerance",                               m_lmSearchTolerance,                               0.02, "Lambda modifier search: accepted relative deviation from the target bits")
 
   /* Quantization parameters */
 #if QP_SWITCHING_FOR_PARALLEL
@@ -1058,6 +1064,7 @@ bool EncAppCfg::parseCfg( int argc, char* argv[] )
   ("LambdaFromQpEnable",                              m_lambdaFromQPEnable,                             false, "Enable flag for derivation of lambda from QP")
 #endif
   ("DeltaQpRD,-dqr",                                  m_uiDeltaQpRD,                                       0u, "max dQp offset for slice")
+  ("DeltaQpRDEarlyTerm",                              m_deltaQpRDEarlyTerm,                             false, "Stop the DeltaQpRD slice QP trials in a direction once a QP step does not lower the RD cost")
   ("MaxDeltaQP,d",                                    m_iMaxDeltaQP,                                        0, "max dQp offset for block")
   ("MaxCuDQPSubdiv,-dqd",                             m_cuQpDeltaSubdiv,                                    0, "Maximum subdiv for CU luma Qp adjustment")
   ("MaxCuChromaQpOffsetSubdiv",                       m_cuChromaQpOffsetSubdiv,                            -1, "Maximum subdiv for CU chroma Qp adjustment - set less than 0 to disable")
@@ -1226,6 +1233,7 @@ bool EncAppCfg::parseCfg( int argc, char* argv[] )
   ( "RCLCUSeparateModel",                             m_RCUseLCUSeparateModel,                           true, "Rate control: use CTU level separate R-lambda model" )
   ( "InitialQP",                                      m_RCInitialQP,                                        0, "Rate control: initial QP" )
   ( "RCForceIntraQP",                                 m_RCForceIntraQP,                                 false, "Rate control: force intra QP to be equal to initial QP" )
+  ( "RCLookahead",                                    m_RCLookahead,                                        0, "Rate control: number of input frames analysed ahead of the current GOP for bit allocation (0: off)" )
 #if U0132_TARGET_BITS_SATURATION
   ( "RCCpbSaturation",                                m_RCCpbSaturationEnabled,                         false, "Rate control: enable target bits saturation to avoid CPB overflow and underflow" )
   ( "RCCpbSize",                                      m_RCCpbSize,                                         0u, "Rate control: CPB size" )
@@ -1614,6 +1622,7 @@ bool EncAppCfg::parseCfg( int argc, char* argv[] )
 
   m_framesToBeEncoded = ( m_framesToBeEncoded + m_temporalSubsampleRatio - 1 ) / m_temporalSubsampleRatio;
   m_adIntraLambdaModifier = cfg_adIntraLambdaModifier.values;
+  m_lmSearchTargetBits = cfg_lmSearchTargetBits.values;
   if(m_isField)
   {
     //Frame height
@@ -3540,6 +3549,8 @@ bool EncAppCfg::xCheckParameter()
       }
     }
     xConfirmPara( m_uiDeltaQpRD > 0, "Rate control cannot be used together with slice level multiple-QP optimization!\n" );
+    xConfirmPara( m_RCLookahead < 0, "RCLookahead must be greater than or equal to 0" );
+    xConfirmPara( m_RCLookahead > 0 && ( m_isField || m_compositeRefEnabled ), "RCLookahead is not supported with field coding or composite reference pictures" );
 #if U0132_TARGET_BITS_SATURATION
     if ((m_RCCpbSaturationEnabled) && (m_level!=Level::NONE) && (m_profile!=Profile::NONE))
     {
@@ -3556,6 +3567,22 @@ bool EncAppCfg::xCheckParameter()
   }
 #endif
 
+  xConfirmPara( !m_RCEnableRateControl && m_RCLookahead != 0, "RCLookahead cannot be used without Rate control" );
+
+  if( !m_lmSearchTargetBits.empty() )
+  {
+    xConfirmPara( m_RCEnableRateControl, "The lambda modifier search cannot be used together with rate control" );
+    xConfirmPara( m_isField || m_maxLayers > 1, "The lambda modifier search supports single layer frame coding only" );
+    xConfirmPara( m_lmSearchFrames < 0, "LMSearchFrames must be greater than or equal to 0" );
+    xConfirmPara( m_lmSearchIterations < 1, "LMSearchIterations must be greater than 0" );
+    xConfirmPara( m_lmSearchThreads < 1, "LMSearchThreads must be greater than 0" );
+    xConfirmPara( m_lmSearchTolerance <= 0.0, "LMSearchTolerance must be greater than 0" );
+    for( const double bits : m_lmSearchTargetBits )
+    {
+      xConfirmPara( bits <= 0.0, "LMSearchTargetBits must be greater than 0" );
+    }
+  }
+
   if (m_framePackingSEIEnabled)
   {
     xConfirmPara(m_framePackingSEIType < 3 || m_framePackingSEIType > 5 , "SEIFramePackingType must be in rage 3 to 5");
@@ -3790,6 +3817,7 @@ void EncAppCfg::xPrintParameter()
     msg( DETAILS, "UseLCUSeparateModel                    : %d\n", m_RCUseLCUSeparateModel );
     msg( DETAILS, "InitialQP                              : %d\n", m_RCInitialQP );
     msg( DETAILS, "ForceIntraQP                           : %d\n", m_RCForceIntraQP );
+    msg( DETAILS, "Lookahead                              : %d\n", m_RCLookahead );
 #if U0132_TARGET_BITS_SATURATION
     msg( DETAILS, "CpbSaturation                          : %d\n", m_RCCpbSaturationEnabled );
     if (m_RCCpbSaturationEnabled)
@@ -3800,6 +3828,20 @@ void EncAppCfg::xPrintParameter()
 #endif
   }
 
+  if( !m_lmSearchTargetBits.empty() )
+  {
+    msg( DETAILS, "LMSearchTargetBits                     :" );
+    for( const double bits : m_lmSearchTargetBits )
+    {
+      msg( DETAILS, " %g", bits );
+    }
+    msg( DETAILS, "\n" );
+    msg( DETAILS, "LMSearchFrames                         : %d\n", m_lmSearchFrames );
+    msg( DETAILS, "LMSearchIterations                     : %d\n", m_lmSearchIterations );
+    msg( DETAILS, "LMSearchThreads                        : %d\n", m_lmSearchThreads );
+    msg( DETAILS, "LMSearchTolerance                      : %g\n", m_lmSearchTolerance );
+  }
+
   msg( DETAILS, "Max Num Merge Candidates               : %d\n", m_maxNumMergeCand );
   msg( DETAILS, "Max Num Affine Merge Candidates        : %d\n", m_maxNumAffineMergeCand );
 #if !JVET_Q0806
@@ -3820,6 +3862,10 @@ void EncAppCfg::xPrintParameter()
   msg( VERBOSE, "LQP:%d ", m_lumaLevelToDeltaQPMapping.mode     );
 #endif
   msg( VERBOSE, "SQP:%d ", m_uiDeltaQpRD                        );
+  if( m_uiDeltaQpRD > 0 )
+  {
+    msg( VERBOSE, "SQPEarlyTerm:%d ", m_deltaQpRDEarlyTerm      );
+  }
   msg( VERBOSE, "ASR:%d ", m_bUseASR                            );
   msg( VERBOSE, "MinSearchWindow:%d ", m_minSearchWindow        );
   msg( VERBOSE, "RestrictMESampling:%d ", m_bRestrictMESampling );
@@ -90,6 +90,13 @@ protected:
   std::vector<double> m_adIntraLambdaModifier;                ///< Lambda modifier for Intra pictures, one for each temporal layer. If size>temporalLayer, then use [temporalLayer], else if size>0, use [size()-1], else use m_adLambdaModifier.
   double    m_dIntraQpFactor;                                 ///< Intra Q Factor. If negative, use a default equation: 0.57*(1.0 - Clip3( 0.0, 0.5, 0.05*(double)(isField ? (GopSize-1)/2 : GopSize-1) ))
 
+  // Lambda modifier search
+  std::vector<double> m_lmSearchTargetBits;                   ///< target average bits per non-intra picture of each temporal layer, empty: no search
+  int       m_lmSearchFrames;                                 ///< number of frames of the training window, 0: first intra picture and two GOPs
+  int       m_lmSearchIterations;                             ///< maximum number of search iterations
+  int       m_lmSearchThreads;                                ///< number of candidate lambda modifier sets encoded in parallel per iteration
+  double    m_lmSearchTolerance;                              ///< accepted relative deviation from the target bits
+
   // source specification
   int       m_iFrameRate;                                     ///< source frame-rates (Hz)
   uint32_t      m_FrameSkip;                                      ///< number of skipped frames from the beginning
@@ -250,6 +257,7 @@ protected:
   int*      m_aidQP;                                          ///< array of slice QP values
   int       m_iMaxDeltaQP;                                    ///< max. |delta QP|
   uint32_t      m_uiDeltaQpRD;                                    ///< dQP range for multi-pass slice QP optimization
+  bool      m_deltaQpRDEarlyTerm;                             ///< stop the slice QP trials in a direction once the cost increases
   int       m_cuQpDeltaSubdiv;                                ///< Maximum subdiv for CU luma Qp adjustment (0:default)
   int       m_cuChromaQpOffsetSubdiv;                         ///< If negative, then do not apply chroma qp offsets.
   bool      m_bFastDeltaQP;                                   ///< Fast Delta QP (false:default)
@@ -679,6 +687,7 @@ protected:
   bool      m_RCUseLCUSeparateModel;              ///< use separate R-lambda model at LCU level                        NOTE: code-tidy - rename to m_RCUseCtuSeparateModel
   int       m_RCInitialQP;                        ///< inital QP for rate control
   bool      m_RCForceIntraQP;                     ///< force all intra picture to use initial QP or not
+  int       m_RCLookahead;                        ///< number of input frames analysed ahead of the current GOP, 0: no lookahead
 #if U0132_TARGET_BITS_SATURATION
   bool      m_RCCpbSaturationEnabled;             ///< enable target bits saturation to avoid CPB overflow and underflow
   uint32_t      m_RCCpbSize;                          ///< CPB size
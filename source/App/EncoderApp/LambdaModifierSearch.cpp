@@ -0,0 +1,170 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2020, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     LambdaModifierSearch.cpp
+    \brief    Search of per-temporal-layer lambda modifiers reaching target bits
+*/
+
+#include "LambdaModifierSearch.h"
+
+#include <algorithm>
+#include <cmath>
+
+//! \ingroup EncoderApp
+//! \{
+
+const double LambdaModifierSearch::m_initialAdjustment   = -0.5;
+const double LambdaModifierSearch::m_interDampening      = 50.0;
+const double LambdaModifierSearch::m_innerToleranceRatio = 0.75;
+
+LambdaModifierSearch::LambdaModifierSearch( const std::vector<double>& targetBits, const double tolerance )
+  : m_targetBits( targetBits )
+  , m_tolerance ( tolerance )
+{
+}
+
+void LambdaModifierSearch::getCandidates( const std::vector<double>& initialLambdaModifiers, const int numCandidates, std::vector<std::vector<double>>& candidates ) const
+{
+  const int numLayers = (int)m_targetBits.size();
+
+  std::vector<double> guess( initialLambdaModifiers.begin(), initialLambdaModifiers.begin() + numLayers );
+  int    numKept = 0;
+  double spread  = 0.1;
+
+  if( !m_history.empty() )
+  {
+    // the leading layers that are already close to their targets keep their modifiers, the others are guessed from
+    // the two latest trials, damped by the changes of the lower layers they reference
+    const Trial& last     = m_history.back();
+    double cumulativeDelta = 0.0;
+    double maxDeviation    = 0.0;
+
+    numKept = xIsInRange( last, m_tolerance * m_innerToleranceRatio, numLayers );
+    guess   = last.lambdaModifiers;
+
+    for( int layer = numKept; layer < numLayers; layer++ )
+    {
+      guess[layer]     = xGuessLambdaModifier( layer, 1.0 / ( m_interDampening * cumulativeDelta + 1.0 ) );
+      cumulativeDelta += std::abs( guess[layer] - last.lambdaModifiers[layer] ) / last.lambdaModifiers[layer];
+      maxDeviation     = std::max( maxDeviation, std::abs( getDeviation( last, layer ) ) );
+    }
+    spread = std::min( 0.1, std::max( 0.01, 0.5 * maxDeviation ) );
+  }
+
+  candidates.resize( numCandidates );
+
+  for( int cand = 0; cand < numCandidates; cand++ )
+  {
+    // 0, +1, -1, +2, -2, ... steps of the relative spread around the guess
+    const int step = ( cand + 1 ) / 2 * ( ( cand & 1 ) ? 1 : -1 );
+
+    candidates[cand] = guess;
+    for( int layer = numKept; layer < numLayers; layer++ )
+    {
+      const double lambdaModifier = guess[layer] * std::pow( 1.0 + spread, step );
+      candidates[cand][layer]     = std::max( 1e-6, std::round( lambdaModifier * 1e6 ) / 1e6 );
+    }
+  }
+}
+
+void LambdaModifierSearch::finishIteration()
+{
+  std::stable_sort( m_iteration.begin(), m_iteration.end(), [this]( const Trial& a, const Trial& b ) { return xGetError( a ) > xGetError( b ); } );
+
+  for( const Trial& trial : m_iteration )
+  {
+    if( m_history.empty() || xGetError( trial ) < xGetError( m_best ) )
+    {
+      m_best = trial;
+    }
+    m_history.push_back( trial );
+  }
+  m_iteration.clear();
+}
+
+double LambdaModifierSearch::xGetError( const Trial& trial ) const
+{
+  double error = 0.0;
+  for( int layer = 0; layer < (int)m_targetBits.size(); layer++ )
+  {
+    error += std::abs( std::log( trial.bits[layer] / m_targetBits[layer] ) );
+  }
+  return error;
+}
+
+int LambdaModifierSearch::xIsInRange( const Trial& trial, const double tolerance, const int numLayers ) const
+{
+  int layer = 0;
+  while( layer < numLayers && std::abs( getDeviation( trial, layer ) ) <= tolerance )
+  {
+    layer++;
+  }
+  return layer;
+}
+
+double LambdaModifierSearch::xGuessLambdaModifier( const int layer, double interDampeningFactor ) const
+{
+  const double targetBits = m_targetBits[layer];
+
+  std::list<Trial>::const_reverse_iterator it = m_history.rbegin();
+  const double lambdaModifier = it->lambdaModifiers[layer];
+  const double bits           = it->bits[layer];
+  double       guess;
+
+  ++it;
+  if( it != m_history.rend() && it->lambdaModifiers[layer] != lambdaModifier && it->bits[layer] != bits )
+  {
+    // interpolate through the two latest points
+    guess = lambdaModifier + ( lambdaModifier - it->lambdaModifiers[layer] ) / ( bits - it->bits[layer] ) * ( targetBits - bits );
+  }
+  else
+  {
+    guess = lambdaModifier + m_initialAdjustment * ( lambdaModifier * targetBits / bits - lambdaModifier );
+  }
+
+  // intra dampening: the relative change is limited logarithmically
+  const double change = std::log( 1.0 + std::abs( guess - lambdaModifier ) / lambdaModifier );
+  guess = guess < lambdaModifier ? lambdaModifier * ( 1.0 - change ) : lambdaModifier * ( 1.0 + change );
+
+  // inter dampening, reduced further until the result is positive
+  double result;
+  do
+  {
+    result = lambdaModifier + interDampeningFactor * ( guess - lambdaModifier );
+    interDampeningFactor /= 2.0;
+  } while( result <= 0.0 );
+
+  return result;
+}
+
+//! \}
@@ -0,0 +1,94 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2020, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/** \file     LambdaModifierSearch.h
+    \brief    Search of per-temporal-layer lambda modifiers reaching target bits (header)
+*/
+
+#ifndef __LAMBDAMODIFIERSEARCH__
+#define __LAMBDAMODIFIERSEARCH__
+
+#include <list>
+#include <vector>
+
+//! \ingroup EncoderApp
+//! \{
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// guesses lambda modifiers from the outcome of trial encodings, following the BitrateTargeting utility
+class LambdaModifierSearch
+{
+public:
+  /// lambda modifiers of one trial encoding and the resulting average bits per non-intra picture of each temporal layer
+  struct Trial
+  {
+    std::vector<double> lambdaModifiers;
+    std::vector<double> bits;
+  };
+
+  LambdaModifierSearch( const std::vector<double>& targetBits, const double tolerance );
+
+  /// fills numCandidates lambda modifier sets to be encoded in parallel; the first one is the actual guess, the others
+  /// are spread around it so that the next guess can interpolate between close points
+  void          getCandidates  ( const std::vector<double>& initialLambdaModifiers, const int numCandidates, std::vector<std::vector<double>>& candidates ) const;
+  void          addTrial       ( const Trial& trial )    { m_iteration.push_back( trial ); }
+  /// appends the trials of the current iteration to the history, the closest one last
+  void          finishIteration();
+
+  bool          isConverged    ()                  const { return !m_history.empty() && xIsInRange( m_best, m_tolerance, (int)m_targetBits.size() ) == (int)m_targetBits.size(); }
+  const Trial&  getBestTrial   ()                  const { return m_best; }
+  double        getDeviation   ( const Trial& trial, const int layer ) const { return trial.bits[layer] / m_targetBits[layer] - 1.0; }
+
+private:
+  double        xGetError      ( const Trial& trial ) const;
+  /// number of leading temporal layers whose bits are within the given relative tolerance
+  int           xIsInRange     ( const Trial& trial, const double tolerance, const int numLayers ) const;
+  double        xGuessLambdaModifier( const int layer, double interDampeningFactor ) const;
+
+  static const double m_initialAdjustment;       ///< proportionality between a bit deviation and the first lambda modifier correction
+  static const double m_interDampening;          ///< weight of the lambda modifier changes of the lower temporal layers
+  static const double m_innerToleranceRatio;     ///< layers closer than this share of the tolerance are kept unchanged
+
+  std::vector<double> m_targetBits;
+  double              m_tolerance;
+  std::list<Trial>    m_history;
+  std::vector<Trial>  m_iteration;
+  Trial               m_best;
+};
+
+//! \}
+
+#endif // __LAMBDAMODIFIERSEARCH__
@@ -185,6 +185,8 @@ int main(int argc, char* argv[])
         pcEncApp[layerIdx]->destroy();
         return 1;
       }
+
+      pcEncApp[layerIdx]->searchLambdaModifiers( j, layerArgv );
     }
     catch( df::program_options_lite::ParseFailure &e )
     {
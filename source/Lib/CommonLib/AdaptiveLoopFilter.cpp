@@ -516,7 +516,6 @@ void AdaptiveLoopFilter::ALFProcess(CodingStructure& cs)
             {
               const Area blkSrc( 0, 0, w, h );
               const Area blkDst( xStart, yStart, w, h );
-              deriveClassification( m_classifier, buf.get(COMPONENT_Y), blkDst, blkSrc );
               short filterSetIndex = alfCtuFilterIndex[ctuIdx];
               short *coeff;
               short *clip;
@@ -530,10 +529,7 @@ void AdaptiveLoopFilter::ALFProcess(CodingStructure& cs)
                 coeff = m_fixedFilterSetCoeffDec[filterSetIndex];
                 clip = m_clipDefault;
               }
-              m_filter7x7Blk(m_classifier, recYuv, buf, blkDst, blkSrc, COMPONENT_Y, coeff, clip, m_clpRngs.comp[COMPONENT_Y], cs
-                , m_alfVBLumaCTUHeight
-                , m_alfVBLumaPos
-              );
+              classifyAndFilterLuma( recYuv, buf, blkDst, blkSrc, coeff, clip, cs );
             }
 
             for( int compIdx = 1; compIdx < MAX_NUM_COMPONENT; compIdx++ )
@@ -582,7 +578,6 @@ void AdaptiveLoopFilter::ALFProcess(CodingStructure& cs)
         if( m_ctuEnableFlag[COMPONENT_Y][ctuIdx] )
         {
           Area blk( xPos, yPos, width, height );
-          deriveClassification( m_classifier, tmpYuv.get( COMPONENT_Y ), blk, blk );
           short filterSetIndex = alfCtuFilterIndex[ctuIdx];
           short *coeff;
           short *clip;
@@ -596,10 +591,7 @@ void AdaptiveLoopFilter::ALFProcess(CodingStructure& cs)
             coeff = m_fixedFilterSetCoeffDec[filterSetIndex];
             clip = m_clipDefault;
           }
-          m_filter7x7Blk(m_classifier, recYuv, tmpYuv, blk, blk, COMPONENT_Y, coeff, clip, m_clpRngs.comp[COMPONENT_Y], cs
-            , m_alfVBLumaCTUHeight
-            , m_alfVBLumaPos
-          );
+          classifyAndFilterLuma( recYuv, tmpYuv, blk, blk, coeff, clip, cs );
         }
 
         for( int compIdx = 1; compIdx < MAX_NUM_COMPONENT; compIdx++ )
@@ -893,6 +885,24 @@ void AdaptiveLoopFilter::deriveClassification( AlfClassifier** classifier, const
   }
 }
 
+void AdaptiveLoopFilter::classifyAndFilterLuma( const PelUnitBuf& recDst, const CPelUnitBuf& recSrc, const Area& blkDst, const Area& blk, const short* filterSet, const short* fClipSet, CodingStructure& cs )
+{
+  // Classify and filter one stripe of classification blocks at a time, so that the source rows
+  // loaded by the classification are still cached when the filter reads them
+  for( int i = 0; i < blk.height; i += m_CLASSIFICATION_BLK_SIZE )
+  {
+    const int h = std::min<int>( blk.height - i, m_CLASSIFICATION_BLK_SIZE );
+    const Area stripeDst( blkDst.x, blkDst.y + i, blkDst.width, h );
+    const Area stripe( blk.x, blk.y + i, blk.width, h );
+
+    deriveClassification( m_classifier, recSrc.get( COMPONENT_Y ), stripeDst, stripe );
+    m_filter7x7Blk( m_classifier, recDst, recSrc, stripeDst, stripe, COMPONENT_Y, filterSet, fClipSet, m_clpRngs.comp[COMPONENT_Y], cs
+      , m_alfVBLumaCTUHeight
+      , m_alfVBLumaPos
+    );
+  }
+}
+
 void AdaptiveLoopFilter::deriveClassificationBlk(AlfClassifier **classifier, int **laplacian[NUM_DIRECTIONS],
                                                  const CPelBuf &srcLuma, const Area &blkDst, const Area &blk,
                                                  const int shift, const int vbCTUHeight, int vbPos)
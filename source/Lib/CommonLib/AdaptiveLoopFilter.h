@@ -77,6 +77,9 @@ public:
 
   static constexpr int   m_NUM_BITS = 8;
   static constexpr int   m_CLASSIFICATION_BLK_SIZE = 32;  //non-normative, local buffer size
+#if JVET_Q0795_CCALF
+  static constexpr int   m_scaleBits = 7; // 8-bits
+#endif
   static constexpr int m_ALF_UNUSED_CLASSIDX = 255;
   static constexpr int m_ALF_UNUSED_TRANSPOSIDX = 255;
 
@@ -91,6 +94,7 @@ public:
                                       const CPelBuf &srcLuma, const Area &blkDst, const Area &blk, const int shift,
                                       const int vbCTUHeight, int vbPos);
   void deriveClassification( AlfClassifier** classifier, const CPelBuf& srcLuma, const Area& blkDst, const Area& blk );
+  void classifyAndFilterLuma( const PelUnitBuf& recDst, const CPelUnitBuf& recSrc, const Area& blkDst, const Area& blk, const short* filterSet, const short* fClipSet, CodingStructure& cs );
 #if JVET_Q0795_CCALF
   template<AlfFilterType filtTypeCcAlf>
   static void filterBlkCcAlf(const PelBuf &dstBuf, const CPelUnitBuf &recSrc, const Area &blkDst, const Area &blkSrc,
@@ -136,7 +140,6 @@ public:
 protected:
   bool isCrossedByVirtualBoundaries( const CodingStructure& cs, const int xPos, const int yPos, const int width, const int height, bool& clipTop, bool& clipBottom, bool& clipLeft, bool& clipRight, int& numHorVirBndry, int& numVerVirBndry, int horVirBndryPos[], int verVirBndryPos[], int& rasterSliceAlfPad );
 #if JVET_Q0795_CCALF
-  static constexpr int   m_scaleBits = 7; // 8-bits
   CcAlfFilterParam       m_ccAlfFilterParam;
   uint8_t*               m_ccAlfFilterControl[2];
 #endif
@@ -60,6 +60,34 @@ OutputBitstream::~OutputBitstream()
 }
 
 
+static size_t findZeroPairCore( const uint8_t* buf, size_t size )
+{
+  // runs without zero bytes are skipped by memchr, only the zeros found are tested for a zero successor
+  size_t pos = 0;
+  while( pos + 1 < size )
+  {
+    const uint8_t* zero = static_cast<const uint8_t*>( memchr( buf + pos, 0, size - pos - 1 ) );
+    if( !zero )
+    {
+      break;
+    }
+    pos = zero - buf;
+    if( buf[pos + 1] == 0 )
+    {
+      return pos;
+    }
+    pos += 2;
+  }
+  return size;
+}
+
+BitstreamOps::BitstreamOps()
+{
+  findZeroPair = findZeroPairCore;
+}
+
+BitstreamOps g_bitstreamOps = BitstreamOps();
+
 InputBitstream::InputBitstream()
 : m_fifo()
 , m_emulationPreventionByteLocation()
@@ -179,9 +207,25 @@ void   OutputBitstream::addSubstream( OutputBitstream* pcSubstream )
   uint32_t uiNumBits = pcSubstream->getNumberOfWrittenBits();
 
   const vector<uint8_t>& rbsp = pcSubstream->getFIFO();
-  for (vector<uint8_t>::const_iterator it = rbsp.begin(); it != rbsp.end();)
+  if (m_num_held_bits == 0)
   {
-    write(*it++, 8);
+    // byte-aligned destination: plain copy of the complete bytes
+    m_fifo.insert(m_fifo.end(), rbsp.begin(), rbsp.end());
+  }
+  else if (!rbsp.empty())
+  {
+    // merge each source byte with the held bits, the low source bits become the new held bits
+    const size_t   oldSize   = m_fifo.size();
+    const uint32_t heldShift = m_num_held_bits;
+    m_fifo.resize(oldSize + rbsp.size());
+    uint8_t*       dst       = &m_fifo[oldSize];
+    uint8_t        held      = m_held_bits;
+    for (size_t i = 0; i < rbsp.size(); i++)
+    {
+      dst[i] = held | (rbsp[i] >> heldShift);
+      held   = rbsp[i] << (8 - heldShift);
+    }
+    m_held_bits = held;
   }
   if (uiNumBits&0x7)
   {
@@ -198,31 +242,22 @@ void OutputBitstream::writeByteAlignment()
 int OutputBitstream::countStartCodeEmulations()
 {
   uint32_t cnt = 0;
-  vector<uint8_t>& rbsp   = getFIFO();
-  for (vector<uint8_t>::iterator it = rbsp.begin(); it != rbsp.end();)
+  const uint8_t* rbsp = m_fifo.data();
+  const size_t   size = m_fifo.size();
+  size_t         pos  = 0;
+  while( pos < size )
   {
-    vector<uint8_t>::iterator found = it;
-    do
+    // find the next emulated 00 00 {00,01,02,03}, a trailing two byte sequence is not counted
+    const size_t zeroPos = pos + g_bitstreamOps.findZeroPair( rbsp + pos, size - pos );
+    if( zeroPos + 2 >= size )
     {
-      // find the next emulated 00 00 {00,01,02,03}
-      // NB, end()-1, prevents finding a trailing two byte sequence
-      found = search_n(found, rbsp.end()-1, 2, 0);
-      found++;
-      // if not found, found == end, otherwise found = second zero byte
-      if (found == rbsp.end())
-      {
-        break;
-      }
-      if (*(++found) <= 3)
-      {
-        break;
-      }
-    } while (true);
-    it = found;
-    if (found != rbsp.end())
+      break;
+    }
+    if( rbsp[zeroPos + 2] <= 3 )
     {
       cnt++;
     }
+    pos = zeroPos + 2;
   }
   return cnt;
 }
@@ -75,6 +75,10 @@ public:
   // create / destroy
   OutputBitstream();
   ~OutputBitstream();
+  OutputBitstream( const OutputBitstream& )            = default;
+  OutputBitstream( OutputBitstream&& )                 = default;
+  OutputBitstream& operator=( const OutputBitstream& ) = default;
+  OutputBitstream& operator=( OutputBitstream&& )      = default;
 
   // interface for encoding
   /**
@@ -109,6 +113,12 @@ public:
    */
   void clear();
 
+  /**
+   * Preallocate storage for numBytes bytes, so that writing up to that
+   * size does not reallocate the byte-stream buffer.
+   */
+  void reserve( uint32_t numBytes ) { m_fifo.reserve( numBytes ); }
+
   /**
    * returns the number of bits that need to be written to
    * achieve byte alignment.
@@ -212,6 +222,25 @@ public:
         std::vector<uint8_t> &getFifo()       { return m_fifo; }
 };
 
+/**
+ * Byte scanning kernels for the emulation prevention of NAL units.
+ */
+struct BitstreamOps
+{
+  BitstreamOps();
+
+#if ENABLE_SIMD_OPT_BITSTREAM && defined(TARGET_SIMD_X86)
+  void initBitstreamOpsX86();
+  template<X86_VEXT vext>
+  void _initBitstreamOpsX86();
+#endif
+
+  /// returns the position of the first two consecutive zero bytes in buf[0..size), or size if there are none
+  size_t ( *findZeroPair )( const uint8_t* buf, size_t size );
+};
+
+extern BitstreamOps g_bitstreamOps;
+
 //! \}
 
 #endif
@@ -308,6 +308,8 @@ PelBufferOps::PelBufferOps()
   profGradFilter = gradFilterCore <false>;
   applyPROF      = applyPROFCore;
   roundIntVector = nullptr;
+  calcSSE        = calcSSECore;
+  calcHPActivity = calcHPActivityCore;
 }
 
 PelBufferOps g_pelBufOP = PelBufferOps();
@@ -321,6 +323,43 @@ void copyBufferCore(Pel *src, int srcStride, Pel *dst, int dstStride, int width,
   }
 }
 
+uint64_t calcSSECore(const Pel* src0, int src0Stride, const Pel* src1, int src1Stride, int width, int height)
+{
+  uint64_t sum = 0;
+  for (int y = 0; y < height; y++)
+  {
+    for (int x = 0; x < width; x++)
+    {
+      const int64_t diff = (int64_t)src0[x] - (int64_t)src1[x];
+      sum += uint64_t(diff * diff);
+    }
+    src0 += src0Stride;
+    src1 += src1Stride;
+  }
+  return sum;
+}
+
+/** sum of the absolute 3x3 high-pass responses (centre 12, direct neighbours -2, diagonal neighbours -1) over the
+    area, the samples surrounding the area have to be valid */
+uint64_t calcHPActivityCore(const Pel* src, int srcStride, int width, int height)
+{
+  uint64_t sum = 0;
+  for (int y = 0; y < height; y++)
+  {
+    const Pel* a = src - srcStride;
+    const Pel* c = src;
+    const Pel* b = src + srcStride;
+    for (int x = 0; x < width; x++)
+    {
+      const int f = 12 * (int)c[x] - 2 * ((int)c[x-1] + (int)c[x+1] + (int)a[x] + (int)b[x])
+                       - (int)a[x-1] - (int)a[x+1] - (int)b[x-1] - (int)b[x+1];
+      sum += abs(f);
+    }
+    src += srcStride;
+  }
+  return sum;
+}
+
 void paddingCore(Pel *ptr, int stride, int width, int height, int padSize)
 {
   /*left and right padding*/
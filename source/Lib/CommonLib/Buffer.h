@@ -83,12 +83,16 @@ struct PelBufferOps
   void (*profGradFilter) (Pel* pSrc, int srcStride, int width, int height, int gradStride, Pel* gradX, Pel* gradY, const int bitDepth);
   void (*applyPROF)      (Pel* dst, int dstStride, const Pel* src, int srcStride, int width, int height, const Pel* gradX, const Pel* gradY, int gradStride, const int* dMvX, const int* dMvY, int dMvStride, const bool& bi, int shiftNum, Pel offset, const ClpRng& clpRng);
   void (*roundIntVector) (int* v, int size, unsigned int nShift, const int dmvLimit);
+  uint64_t (*calcSSE)       ( const Pel* src0, int src0Stride, const Pel* src1, int src1Stride, int width, int height );
+  uint64_t (*calcHPActivity)( const Pel* src, int srcStride, int width, int height );
 };
 
 extern PelBufferOps g_pelBufOP;
 
 void paddingCore(Pel *ptr, int stride, int width, int height, int padSize);
 void copyBufferCore(Pel *src, int srcStride, Pel *Dst, int dstStride, int width, int height);
+uint64_t calcSSECore(const Pel* src0, int src0Stride, const Pel* src1, int src1Stride, int width, int height);
+uint64_t calcHPActivityCore(const Pel* src, int srcStride, int width, int height);
 
 template<typename T>
 struct AreaBuf : public Size
@@ -44,7 +44,52 @@
 #include "UnitPartitioner.h"
 
 
-XUCache g_globalUnitCache = XUCache();
+thread_local XUCache g_globalUnitCache;
+
+#if ENABLE_CS_COPY_STATS
+std::atomic<uint64_t> CSCopyStats::m_numBytes[CSCopyStats::NUM_COPY_TYPES];
+std::atomic<uint64_t> CSCopyStats::m_numCtus;
+
+void CSCopyStats::report()
+{
+  static const char* copyTypeNames[NUM_COPY_TYPES] = { "samples", "motion", "units", "coefficients" };
+
+  const uint64_t numCtus  = m_numCtus;
+  uint64_t       numTotal = 0;
+
+  msg( INFO, "\nBytes copied by CodingStructure::useSubStructure/copyStructure (%llu CTUs)\n", ( unsigned long long ) numCtus );
+  for( int i = 0; i < NUM_COPY_TYPES; i++ )
+  {
+    const uint64_t numBytes = m_numBytes[i];
+    msg( INFO, "  %-12s: %16llu bytes, %12.1f bytes/CTU\n", copyTypeNames[i], ( unsigned long long ) numBytes, numCtus ? double( numBytes ) / numCtus : 0.0 );
+    numTotal += numBytes;
+  }
+  msg( INFO, "  %-12s: %16llu bytes, %12.1f bytes/CTU\n", "total", ( unsigned long long ) numTotal, numCtus ? double( numTotal ) / numCtus : 0.0 );
+}
+
+static size_t getNumBytes( const CPelUnitBuf& buf )
+{
+  size_t numBytes = 0;
+  for( const auto& blk : buf.bufs )
+  {
+    numBytes += blk.area() * sizeof( Pel );
+  }
+  return numBytes;
+}
+
+static size_t getNumCoeffBytes( const TransformUnit& tu, const bool codedCoeffsOnly )
+{
+  size_t numBytes = 0;
+  for( uint32_t i = 0; i < ::getNumberValidTBlocks( *tu.cs->pcv ); i++ )
+  {
+    if( !codedCoeffsOnly || tu.cbf[i] )
+    {
+      numBytes += tu.blocks[i].area() * sizeof( TCoeff );
+    }
+  }
+  return numBytes;
+}
+#endif
 
 const UnitScale UnitScaleArray[NUM_CHROMA_FORMAT][MAX_NUM_COMPONENT] =
 {
@@ -89,6 +134,11 @@ CodingStructure::CodingStructure(CUCache& cuCache, PUCache& puCache, TUCache& tu
     m_cuIdx   [ i ] = nullptr;
     m_puIdx   [ i ] = nullptr;
     m_tuIdx   [ i ] = nullptr;
+    m_cuIdxBase[ i ] = nullptr;
+    m_puIdxBase[ i ] = nullptr;
+    m_tuIdxBase[ i ] = nullptr;
+    m_idxBaseStride[ i ] = 0;
+    m_idxBaseSize  [ i ] = 0;
     m_isDecomp[ i ] = nullptr;
   }
 
@@ -126,6 +176,15 @@ void CodingStructure::destroy()
 
     delete[] m_tuIdx[ i ];
     m_tuIdx[ i ] = nullptr;
+
+    delete[] m_cuIdxBase[ i ];
+    m_cuIdxBase[ i ] = nullptr;
+
+    delete[] m_puIdxBase[ i ];
+    m_puIdxBase[ i ] = nullptr;
+
+    delete[] m_tuIdxBase[ i ];
+    m_tuIdxBase[ i ] = nullptr;
   }
 
   delete[] m_motionBuf;
@@ -226,14 +285,18 @@ void CodingStructure::clearCuPuTuIdxMap( const UnitArea &_area, uint32_t numCu,
     const Area scaledSelf = scale.scale( _selfBlk );
     const Area scaledBlk = scale.scale( _blk );
     const size_t offset = rsAddr( scaledBlk.pos(), scaledSelf.pos(), scaledSelf.width );
-    unsigned *idxPtrCU = m_cuIdx[i] + offset;
-    AreaBuf<uint32_t>( idxPtrCU, scaledSelf.width, scaledBlk.size() ).fill( 0 );
+    uint16_t *idxPtrCU = m_cuIdx[i] + offset;
+    AreaBuf<uint16_t>( idxPtrCU, scaledSelf.width, scaledBlk.size() ).fill( 0 );
 
-    unsigned *idxPtrPU = m_puIdx[i] + offset;
-    AreaBuf<uint32_t>( idxPtrPU, scaledSelf.width, scaledBlk.size() ).fill( 0 );
+    uint16_t *idxPtrPU = m_puIdx[i] + offset;
+    AreaBuf<uint16_t>( idxPtrPU, scaledSelf.width, scaledBlk.size() ).fill( 0 );
 
-    unsigned *idxPtrTU = m_tuIdx[i] + offset;
-    AreaBuf<uint32_t>( idxPtrTU, scaledSelf.width, scaledBlk.size() ).fill( 0 );
+    uint16_t *idxPtrTU = m_tuIdx[i] + offset;
+    AreaBuf<uint16_t>( idxPtrTU, scaledSelf.width, scaledBlk.size() ).fill( 0 );
+
+    clearUnitIdxBase( m_cuIdxBase[i], ChannelType( i ), numCu );
+    clearUnitIdxBase( m_puIdxBase[i], ChannelType( i ), numPu );
+    clearUnitIdxBase( m_tuIdxBase[i], ChannelType( i ), numTu );
   }
 
   //pop cu/pu/tus
@@ -261,13 +324,57 @@ void CodingStructure::clearCuPuTuIdxMap( const UnitArea &_area, uint32_t numCu,
   }
 }
 
+void CodingStructure::setUnitIdx( uint16_t* idxMap, unsigned* idxBase, const ChannelType chType, const Area& scaledBlk, const unsigned idx )
+{
+  const Area     scaledSelf = unitScale[chType].scale( area.blocks[chType] );
+  const unsigned stride     = scaledSelf.width;
+  const int      x0         = scaledBlk.x - scaledSelf.x;
+  const int      y0         = scaledBlk.y - scaledSelf.y;
+  const int      x1         = x0 + scaledBlk.width;
+  const int      y1         = y0 + scaledBlk.height;
+
+  // fill the part of the block in each cell with the index relative to the base of the cell
+  for( int cy = y0 >> IDX_CELL_LOG2; cy <= ( y1 - 1 ) >> IDX_CELL_LOG2; cy++ )
+  {
+    const int ys = std::max( y0, cy << IDX_CELL_LOG2 );
+    const int ye = std::min( y1, ( cy + 1 ) << IDX_CELL_LOG2 );
+
+    for( int cx = x0 >> IDX_CELL_LOG2; cx <= ( x1 - 1 ) >> IDX_CELL_LOG2; cx++ )
+    {
+      const int xs = std::max( x0, cx << IDX_CELL_LOG2 );
+      const int xe = std::min( x1, ( cx + 1 ) << IDX_CELL_LOG2 );
+
+      unsigned &base = idxBase[m_idxBaseStride[chType] * cy + cx];
+      if( base == IDX_NO_BASE )
+      {
+        base = idx - 1;
+      }
+      CHECK( idx - base > std::numeric_limits<uint16_t>::max(), "Unit index does not fit into the index map" );
+
+      AreaBuf<uint16_t>( idxMap + rsAddr( Position( xs, ys ), stride ), stride, xe - xs, ye - ys ).fill( uint16_t( idx - base ) );
+    }
+  }
+}
+
+void CodingStructure::clearUnitIdxBase( unsigned* idxBase, const ChannelType chType, const unsigned numUnits )
+{
+  // cells whose first unit has been removed get a new base with the next unit added to them
+  for( unsigned i = 0; i < m_idxBaseSize[chType]; i++ )
+  {
+    if( idxBase[i] != IDX_NO_BASE && idxBase[i] >= numUnits )
+    {
+      idxBase[i] = IDX_NO_BASE;
+    }
+  }
+}
+
 CodingUnit* CodingStructure::getLumaCU( const Position &pos )
 {
   const ChannelType effChType = CHANNEL_TYPE_LUMA;
   const CompArea &_blk = area.blocks[effChType];
   CHECK( !_blk.contains( pos ), "must contain the pos" );
 
-  const unsigned idx = m_cuIdx[effChType][rsAddr( pos, _blk.pos(), _blk.width, unitScale[effChType] )];
+  const unsigned idx = getUnitIdx( m_cuIdx[effChType], m_cuIdxBase[effChType], effChType, pos );
 
   if( idx != 0 ) return cus[idx - 1];
   else           return nullptr;
@@ -290,7 +397,7 @@ CodingUnit* CodingStructure::getCU( const Position &pos, const ChannelType effCh
   }
   else
   {
-    const unsigned idx = m_cuIdx[effChType][rsAddr( pos, _blk.pos(), _blk.width, unitScale[effChType] )];
+    const unsigned idx = getUnitIdx( m_cuIdx[effChType], m_cuIdxBase[effChType], effChType, pos );
 
     if( idx != 0 ) return cus[ idx - 1 ];
     else           return nullptr;
@@ -313,7 +420,7 @@ const CodingUnit* CodingStructure::getCU( const Position &pos, const ChannelType
   }
   else
   {
-    const unsigned idx = m_cuIdx[effChType][rsAddr( pos, _blk.pos(), _blk.width, unitScale[effChType] )];
+    const unsigned idx = getUnitIdx( m_cuIdx[effChType], m_cuIdxBase[effChType], effChType, pos );
 
     if( idx != 0 ) return cus[ idx - 1 ];
     else           return nullptr;
@@ -331,7 +438,7 @@ PredictionUnit* CodingStructure::getPU( const Position &pos, const ChannelType e
   }
   else
   {
-    const unsigned idx = m_puIdx[effChType][rsAddr( pos, _blk.pos(), _blk.width, unitScale[effChType] )];
+    const unsigned idx = getUnitIdx( m_puIdx[effChType], m_puIdxBase[effChType], effChType, pos );
 
     if( idx != 0 ) return pus[ idx - 1 ];
     else           return nullptr;
@@ -349,7 +456,7 @@ const PredictionUnit * CodingStructure::getPU( const Position &pos, const Channe
   }
   else
   {
-    const unsigned idx = m_puIdx[effChType][rsAddr( pos, _blk.pos(), _blk.width, unitScale[effChType] )];
+    const unsigned idx = getUnitIdx( m_puIdx[effChType], m_puIdxBase[effChType], effChType, pos );
 
     if( idx != 0 ) return pus[ idx - 1 ];
     else           return nullptr;
@@ -367,7 +474,7 @@ TransformUnit* CodingStructure::getTU( const Position &pos, const ChannelType ef
   }
   else
   {
-    const unsigned idx = m_tuIdx[effChType][rsAddr( pos, _blk.pos(), _blk.width, unitScale[effChType] )];
+    const unsigned idx = getUnitIdx( m_tuIdx[effChType], m_tuIdxBase[effChType], effChType, pos );
 
     if( idx != 0 )
     {
@@ -412,7 +519,7 @@ const TransformUnit * CodingStructure::getTU( const Position &pos, const Channel
   }
   else
   {
-    const unsigned idx = m_tuIdx[effChType][rsAddr( pos, _blk.pos(), _blk.width, unitScale[effChType] )];
+    const unsigned idx = getUnitIdx( m_tuIdx[effChType], m_tuIdxBase[effChType], effChType, pos );
     if( idx != 0 )
     {
       unsigned extraIdx = 0;
@@ -492,9 +599,8 @@ CodingUnit& CodingStructure::addCU( const UnitArea &unit, const ChannelType chTy
     const UnitScale& scale = unitScale[_blk.compID];
     const Area scaledSelf  = scale.scale( _selfBlk );
     const Area scaledBlk   = scale.scale(     _blk );
-    unsigned *idxPtr       = m_cuIdx[i] + rsAddr( scaledBlk.pos(), scaledSelf.pos(), scaledSelf.width );
-    CHECK( *idxPtr, "Overwriting a pre-existing value, should be '0'!" );
-    AreaBuf<uint32_t>( idxPtr, scaledSelf.width, scaledBlk.size() ).fill( idx );
+    CHECK( m_cuIdx[i][rsAddr( scaledBlk.pos(), scaledSelf.pos(), scaledSelf.width )], "Overwriting a pre-existing value, should be '0'!" );
+    setUnitIdx( m_cuIdx[i], m_cuIdxBase[i], ChannelType( i ), scaledBlk, idx );
   }
 
   return *cu;
@@ -552,9 +658,8 @@ PredictionUnit& CodingStructure::addPU( const UnitArea &unit, const ChannelType
     const UnitScale& scale = unitScale[_blk.compID];
     const Area scaledSelf  = scale.scale( _selfBlk );
     const Area scaledBlk   = scale.scale(     _blk );
-    unsigned *idxPtr       = m_puIdx[i] + rsAddr( scaledBlk.pos(), scaledSelf.pos(), scaledSelf.width );
-    CHECK( *idxPtr, "Overwriting a pre-existing value, should be '0'!" );
-    AreaBuf<uint32_t>( idxPtr, scaledSelf.width, scaledBlk.size() ).fill( idx );
+    CHECK( m_puIdx[i][rsAddr( scaledBlk.pos(), scaledSelf.pos(), scaledSelf.width )], "Overwriting a pre-existing value, should be '0'!" );
+    setUnitIdx( m_puIdx[i], m_puIdxBase[i], ChannelType( i ), scaledBlk, idx );
   }
 
   return *pu;
@@ -635,9 +740,8 @@ TransformUnit& CodingStructure::addTU( const UnitArea &unit, const ChannelType c
 
         const Area scaledSelf = scale.scale(_selfBlk);
         const Area scaledBlk = isIspTu ? scale.scale(tu->cu->blocks[i]) : scale.scale(_blk);
-        unsigned *idxPtr = m_tuIdx[i] + rsAddr(scaledBlk.pos(), scaledSelf.pos(), scaledSelf.width);
-        CHECK(*idxPtr, "Overwriting a pre-existing value, should be '0'!");
-        AreaBuf<uint32_t>(idxPtr, scaledSelf.width, scaledBlk.size()).fill(idx);
+        CHECK(m_tuIdx[i][rsAddr(scaledBlk.pos(), scaledSelf.pos(), scaledSelf.width)], "Overwriting a pre-existing value, should be '0'!");
+        setUnitIdx(m_tuIdx[i], m_tuIdxBase[i], ChannelType(i), scaledBlk, idx);
       }
     }
 
@@ -803,10 +907,19 @@ void CodingStructure::createInternals(const UnitArea& _unit, const bool isTopLay
   {
     unsigned _area = unitScale[i].scale( area.blocks[i].size() ).area();
 
-    m_cuIdx[i]    = _area > 0 ? new unsigned[_area] : nullptr;
-    m_puIdx[i]    = _area > 0 ? new unsigned[_area] : nullptr;
-    m_tuIdx[i]    = _area > 0 ? new unsigned[_area] : nullptr;
+    m_cuIdx[i]    = _area > 0 ? new uint16_t[_area] : nullptr;
+    m_puIdx[i]    = _area > 0 ? new uint16_t[_area] : nullptr;
+    m_tuIdx[i]    = _area > 0 ? new uint16_t[_area] : nullptr;
     m_isDecomp[i] = _area > 0 ? new bool    [_area] : nullptr;
+
+    const Size scaledSize = unitScale[i].scale( area.blocks[i].size() );
+    const unsigned cellSize = 1 << IDX_CELL_LOG2;
+    m_idxBaseStride[i] = ( scaledSize.width + cellSize - 1 ) >> IDX_CELL_LOG2;
+    m_idxBaseSize  [i] = m_idxBaseStride[i] * ( ( scaledSize.height + cellSize - 1 ) >> IDX_CELL_LOG2 );
+
+    m_cuIdxBase[i] = _area > 0 ? new unsigned[m_idxBaseSize[i]] : nullptr;
+    m_puIdxBase[i] = _area > 0 ? new unsigned[m_idxBaseSize[i]] : nullptr;
+    m_tuIdxBase[i] = _area > 0 ? new unsigned[m_idxBaseSize[i]] : nullptr;
   }
 
   numCh = getNumberValidComponents(area.chromaFormat);
@@ -1100,6 +1213,14 @@ void CodingStructure::useSubStructure( const CodingStructure& subStruct, const C
   if( cpyResi ) picture->getResiBuf( clippedArea ).copyFrom( subResiBuf );
   if( cpyReco ) picture->getRecoBuf( clippedArea ).copyFrom( subRecoBuf );
 
+#if ENABLE_CS_COPY_STATS
+  {
+    const size_t numSubBytes = ( cpyPred ? getNumBytes( subPredBuf ) : 0 ) + ( cpyResi ? getNumBytes( subResiBuf ) : 0 ) + ( cpyReco ? getNumBytes( subRecoBuf ) : 0 );
+    const size_t numOrgBytes = cpyOrgResi && parent ? getNumBytes( subStruct.getOrgResiBuf( clippedArea ) ) : 0;
+    CSCopyStats::add( CSCopyStats::COPY_SAMPLES, ( parent ? 2 : 1 ) * numSubBytes + numOrgBytes );
+  }
+#endif
+
   if (!subStruct.m_isTuEnc && ((!slice->isIntra() || slice->getSPS()->getIBCFlag()) && chType != CHANNEL_TYPE_CHROMA))
   {
     // copy motion buffer
@@ -1107,6 +1228,9 @@ void CodingStructure::useSubStructure( const CodingStructure& subStruct, const C
     CMotionBuf subMB = subStruct.getMotionBuf( clippedArea );
 
     ownMB.copyFrom( subMB );
+#if ENABLE_CS_COPY_STATS
+    CSCopyStats::add( CSCopyStats::COPY_MOTION, subMB.area() * sizeof( MotionInfo ) );
+#endif
 
     motionLut = subStruct.motionLut;
   }
@@ -1139,6 +1263,9 @@ void CodingStructure::useSubStructure( const CodingStructure& subStruct, const C
       // copy the CU info from subPatch
       cu = *pcu;
     }
+#if ENABLE_CS_COPY_STATS
+    CSCopyStats::add( CSCopyStats::COPY_UNITS, subStruct.cus.size() * sizeof( CodingUnit ) );
+#endif
   }
 
   // copy the PUs over
@@ -1157,6 +1284,9 @@ void CodingStructure::useSubStructure( const CodingStructure& subStruct, const C
       // copy the PU info from subPatch
       pu = *ppu;
     }
+#if ENABLE_CS_COPY_STATS
+    CSCopyStats::add( CSCopyStats::COPY_UNITS, subStruct.pus.size() * sizeof( PredictionUnit ) );
+#endif
   }
   // copy the TUs over
   for( const auto &ptu : subStruct.tus )
@@ -1166,7 +1296,11 @@ void CodingStructure::useSubStructure( const CodingStructure& subStruct, const C
     TransformUnit &tu = addTU( tuPatch, ptu->chType );
 
     // copy the TU info from subPatch
-    tu = *ptu;
+    tu.copyFrom( *ptu, CS_COPY_CODED_COEFFS_ONLY );
+#if ENABLE_CS_COPY_STATS
+    CSCopyStats::add( CSCopyStats::COPY_UNITS,  sizeof( TransformUnit ) );
+    CSCopyStats::add( CSCopyStats::COPY_COEFFS, getNumCoeffBytes( *ptu, CS_COPY_CODED_COEFFS_ONLY ) );
+#endif
   }
 }
 
@@ -1194,6 +1328,9 @@ void CodingStructure::copyStructure( const CodingStructure& other, const Channel
 
     // copy the CU info from subPatch
     cu = *pcu;
+#if ENABLE_CS_COPY_STATS
+    CSCopyStats::add( CSCopyStats::COPY_UNITS, sizeof( CodingUnit ) );
+#endif
   }
 
   // copy the PUs over
@@ -1210,6 +1347,9 @@ void CodingStructure::copyStructure( const CodingStructure& other, const Channel
 
     // copy the PU info from subPatch
     pu = *ppu;
+#if ENABLE_CS_COPY_STATS
+    CSCopyStats::add( CSCopyStats::COPY_UNITS, sizeof( PredictionUnit ) );
+#endif
   }
 
   if (!other.slice->isIntra() || other.slice->getSPS()->getIBCFlag())
@@ -1219,6 +1359,9 @@ void CodingStructure::copyStructure( const CodingStructure& other, const Channel
     CMotionBuf subMB = other.getMotionBuf();
 
     ownMB.copyFrom( subMB );
+#if ENABLE_CS_COPY_STATS
+    CSCopyStats::add( CSCopyStats::COPY_MOTION, subMB.area() * sizeof( MotionInfo ) );
+#endif
 
     motionLut = other.motionLut;
   }
@@ -1240,6 +1383,10 @@ void CodingStructure::copyStructure( const CodingStructure& other, const Channel
 
       // copy the TU info from subPatch
       tu = *ptu;
+#if ENABLE_CS_COPY_STATS
+      CSCopyStats::add( CSCopyStats::COPY_UNITS,  sizeof( TransformUnit ) );
+      CSCopyStats::add( CSCopyStats::COPY_COEFFS, getNumCoeffBytes( *ptu, false ) );
+#endif
     }
   }
 
@@ -1263,7 +1410,13 @@ void CodingStructure::copyStructure( const CodingStructure& other, const Channel
         getPredBuf(area).copyFrom(predBuf);
       }
       picture->getPredBuf(area).copyFrom(predBuf);
+#if ENABLE_CS_COPY_STATS
+      CSCopyStats::add( CSCopyStats::COPY_SAMPLES, ( parent ? 2 : 1 ) * getNumBytes( predBuf ) );
+#endif
     }
+#if ENABLE_CS_COPY_STATS
+    CSCopyStats::add( CSCopyStats::COPY_SAMPLES, ( parent ? 2 : 1 ) * getNumBytes( recoBuf ) );
+#endif
 
     // required for DebugCTU
     int numCh = ::getNumberValidChannels( area.chromaFormat );
@@ -1311,6 +1464,7 @@ void CodingStructure::clearTUs()
 
     memset( m_isDecomp[i], false, sizeof( *m_isDecomp[0] ) * _area );
     memset( m_tuIdx   [i],     0, sizeof( *m_tuIdx   [0] ) * _area );
+    std::fill_n( m_tuIdxBase[i], m_idxBaseSize[i], unsigned( IDX_NO_BASE ) );
   }
 
   numCh = getNumberValidComponents( area.chromaFormat );
@@ -1334,6 +1488,7 @@ void CodingStructure::clearPUs()
   for( int i = 0; i < numCh; i++ )
   {
     memset( m_puIdx[i], 0, sizeof( *m_puIdx[0] ) * unitScale[i].scaleArea( area.blocks[i].area() ) );
+    std::fill_n( m_puIdxBase[i], m_idxBaseSize[i], unsigned( IDX_NO_BASE ) );
   }
 
   m_puCache.cache( pus );
@@ -1351,6 +1506,7 @@ void CodingStructure::clearCUs()
   for( int i = 0; i < numCh; i++ )
   {
     memset( m_cuIdx[i], 0, sizeof( *m_cuIdx[0] ) * unitScale[i].scaleArea( area.blocks[i].area() ) );
+    std::fill_n( m_cuIdxBase[i], m_idxBaseSize[i], unsigned( IDX_NO_BASE ) );
   }
 
   m_cuCache.cache( cus );
@@ -45,6 +45,10 @@
 #include "Slice.h"
 #include <vector>
 
+#if ENABLE_CS_COPY_STATS
+#include <atomic>
+#endif
+
 
 struct Picture;
 
@@ -62,7 +66,31 @@ enum PictureType
   PIC_TRUE_ORIGINAL_INPUT,
   NUM_PIC_TYPES
 };
-extern XUCache g_globalUnitCache;
+extern thread_local XUCache g_globalUnitCache;
+
+#if ENABLE_CS_COPY_STATS
+/// bytes copied when coding structures are adopted by their parents in the CU RDO tree
+class CSCopyStats
+{
+public:
+  enum CopyType
+  {
+    COPY_SAMPLES = 0,
+    COPY_MOTION,
+    COPY_UNITS,
+    COPY_COEFFS,
+    NUM_COPY_TYPES
+  };
+
+  static void add   ( const CopyType type, const size_t numBytes ) { m_numBytes[type].fetch_add( numBytes, std::memory_order_relaxed ); }
+  static void addCtu()                                           { m_numCtus.fetch_add( 1, std::memory_order_relaxed ); }
+  static void report();
+
+private:
+  static std::atomic<uint64_t> m_numBytes[NUM_COPY_TYPES];
+  static std::atomic<uint64_t> m_numCtus;
+};
+#endif
 
 // ---------------------------------------------------------------------------
 // coding structure
@@ -211,11 +239,35 @@ private:
   // needed for TU encoding
   bool m_isTuEnc;
 
-  unsigned *m_cuIdx   [MAX_NUM_CHANNEL_TYPE];
-  unsigned *m_puIdx   [MAX_NUM_CHANNEL_TYPE];
-  unsigned *m_tuIdx   [MAX_NUM_CHANNEL_TYPE];
+  // The index maps hold the 1-based index of the unit covering each minimum block as a 16-bit offset from the base of
+  // its cell of (1 << IDX_CELL_LOG2) x (1 << IDX_CELL_LOG2) blocks. A cell spans at most 32x32 luma samples and never
+  // crosses a CTU boundary, so all units covering it are added while coding the same CTU.
+  static const int      IDX_CELL_LOG2 = 3;
+  static const unsigned IDX_NO_BASE   = MAX_UINT;
+
+  uint16_t *m_cuIdx   [MAX_NUM_CHANNEL_TYPE];
+  uint16_t *m_puIdx   [MAX_NUM_CHANNEL_TYPE];
+  uint16_t *m_tuIdx   [MAX_NUM_CHANNEL_TYPE];
+  unsigned *m_cuIdxBase[MAX_NUM_CHANNEL_TYPE];
+  unsigned *m_puIdxBase[MAX_NUM_CHANNEL_TYPE];
+  unsigned *m_tuIdxBase[MAX_NUM_CHANNEL_TYPE];
+  unsigned  m_idxBaseStride[MAX_NUM_CHANNEL_TYPE];
+  unsigned  m_idxBaseSize  [MAX_NUM_CHANNEL_TYPE];
   bool     *m_isDecomp[MAX_NUM_CHANNEL_TYPE];
 
+  unsigned getUnitIdx     ( const uint16_t* idxMap, const unsigned* idxBase, const ChannelType chType, const Position& pos ) const
+  {
+    const CompArea  &_blk  = area.blocks[chType];
+    const UnitScale &scale = unitScale[chType];
+    const unsigned   x     = ( pos.x - _blk.x ) >> scale.posx;
+    const unsigned   y     = ( pos.y - _blk.y ) >> scale.posy;
+    const unsigned   idx   = idxMap[( _blk.width >> scale.posx ) * y + x];
+
+    return idx ? idxBase[m_idxBaseStride[chType] * ( y >> IDX_CELL_LOG2 ) + ( x >> IDX_CELL_LOG2 )] + idx : 0;
+  }
+  void     setUnitIdx     ( uint16_t* idxMap, unsigned* idxBase, const ChannelType chType, const Area& scaledBlk, const unsigned idx );
+  void     clearUnitIdxBase( unsigned* idxBase, const ChannelType chType, const unsigned numUnits );
+
   unsigned m_numCUs;
   unsigned m_numPUs;
   unsigned m_numTUs;
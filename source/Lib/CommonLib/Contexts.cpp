@@ -1654,27 +1654,223 @@ const CtxSet ContextSetCfg::Sao = { ContextSetCfg::SaoMergeFlag, ContextSetCfg::
 
 const CtxSet ContextSetCfg::Alf = { ContextSetCfg::ctbAlfFlag, ContextSetCfg::ctbAlfAlternative, ContextSetCfg::AlfUseTemporalFilt };
 
+#if ENABLE_CTX_COPY_STATS
+std::atomic<uint64_t> CtxCopyStats::m_numBytes;
+std::atomic<uint64_t> CtxCopyStats::m_numCtus;
+
+void CtxCopyStats::report()
+{
+  const uint64_t numCtus  = m_numCtus;
+  const uint64_t numBytes = m_numBytes;
+
+  msg( INFO, "\nBytes of CABAC contexts copied (%llu CTUs)\n", ( unsigned long long ) numCtus );
+  msg( INFO, "  total: %16llu bytes, %12.1f bytes/CTU\n", ( unsigned long long ) numBytes, numCtus ? double( numBytes ) / numCtus : 0.0 );
+}
+#endif
+
+#if CTX_JOURNALED_COPY
+template <class BinProbModel>
+std::atomic<uint64_t> CtxStore<BinProbModel>::m_nextStateId( 0 );
+#endif
+
 template <class BinProbModel>
 CtxStore<BinProbModel>::CtxStore()
   : m_CtxBuffer ()
   , m_Ctx       ( nullptr )
+#if CTX_JOURNALED_COPY
+  , m_baseStateId( 0 )
+  , m_stateId   ( 0 )
+  , m_stateDirty( true )
+#endif
 {}
 
 template <class BinProbModel>
 CtxStore<BinProbModel>::CtxStore( bool dummy )
   : m_CtxBuffer ( ContextSetCfg::NumberOfContexts )
   , m_Ctx       ( m_CtxBuffer.data() )
-{}
+#if CTX_JOURNALED_COPY
+  , m_baseStateId( 0 )
+  , m_stateId   ( 0 )
+  , m_stateDirty( true )
+#endif
+{
+#if CTX_JOURNALED_COPY
+  initJournal();
+#endif
+}
 
 template <class BinProbModel>
 CtxStore<BinProbModel>::CtxStore( const CtxStore<BinProbModel>& ctxStore )
   : m_CtxBuffer ( ctxStore.m_CtxBuffer )
   , m_Ctx       ( m_CtxBuffer.data() )
-{}
+#if CTX_JOURNALED_COPY
+  , m_baseStateId( 0 )
+  , m_stateId   ( 0 )
+  , m_stateDirty( true )
+#endif
+{
+#if CTX_JOURNALED_COPY
+  if( ctxStore.m_Ctx )
+  {
+    initJournal();
+    m_baseStateId = m_stateId = ctxStore.getStateId();
+    m_stateDirty  = false;
+  }
+  else
+  {
+    m_Ctx = nullptr;
+  }
+#endif
+}
+
+#if CTX_JOURNALED_COPY
+template <class BinProbModel>
+void CtxStore<BinProbModel>::initJournal()
+{
+  m_isTouched.assign( ContextSetCfg::NumberOfContexts, 0 );
+  m_touched.clear();
+  m_touched.reserve( ContextSetCfg::NumberOfContexts );
+}
+
+template <class BinProbModel>
+void CtxStore<BinProbModel>::resetJournal( const uint64_t baseStateId )
+{
+  for( const uint16_t ctxId : m_touched )
+  {
+    m_isTouched[ctxId] = 0;
+  }
+  m_touched.clear();
+  m_baseStateId = baseStateId;
+}
+
+template <class BinProbModel>
+void CtxStore<BinProbModel>::addTouched( const std::vector<uint16_t>& touched )
+{
+  for( const uint16_t ctxId : touched )
+  {
+    if( !m_isTouched[ctxId] )
+    {
+      m_isTouched[ctxId] = 1;
+      m_touched.push_back( ctxId );
+    }
+  }
+}
+
+template <class BinProbModel>
+void CtxStore<BinProbModel>::copyTouched( const CtxStore<BinProbModel>& src, const std::vector<uint16_t>& touched )
+{
+  if( 2 * touched.size() > ContextSetCfg::NumberOfContexts )
+  {
+    ::memcpy( m_Ctx, src.m_Ctx, sizeof( BinProbModel ) * ContextSetCfg::NumberOfContexts );
+#if ENABLE_CTX_COPY_STATS
+    CtxCopyStats::add( sizeof( BinProbModel ) * ContextSetCfg::NumberOfContexts );
+#endif
+    return;
+  }
+  for( const uint16_t ctxId : touched )
+  {
+    m_Ctx[ctxId] = src.m_Ctx[ctxId];
+  }
+#if ENABLE_CTX_COPY_STATS
+  CtxCopyStats::add( sizeof( BinProbModel ) * touched.size() );
+#endif
+}
+
+template <class BinProbModel>
+uint64_t CtxStore<BinProbModel>::getStateId() const
+{
+  if( m_stateDirty )
+  {
+    m_stateId    = m_nextStateId.fetch_add( 1, std::memory_order_relaxed ) + 1;
+    m_stateDirty = false;
+  }
+  return m_stateId;
+}
+#endif
+
+template <class BinProbModel>
+void CtxStore<BinProbModel>::copyFrom( const CtxStore<BinProbModel>& src )
+{
+  checkInit();
+#if CTX_JOURNALED_COPY
+  const uint64_t srcStateId = src.getStateId();
+  const uint64_t ownStateId = getStateId();
+
+  if( srcStateId == ownStateId )
+  {
+    // identical contents
+    return;
+  }
+  if( srcStateId == m_baseStateId )
+  {
+    // the source still holds the version this store was copied from, only the own changes are undone
+    copyTouched( src, m_touched );
+    resetJournal( m_baseStateId );
+  }
+  else if( m_baseStateId && src.m_baseStateId == m_baseStateId )
+  {
+    // both stores were copied from the same version, only the models changed in one of them can differ
+    copyTouched( src, src.m_touched );
+    for( const uint16_t ctxId : m_touched )
+    {
+      if( !src.m_isTouched[ctxId] )
+      {
+        m_Ctx[ctxId] = src.m_Ctx[ctxId];
+#if ENABLE_CTX_COPY_STATS
+        CtxCopyStats::add( sizeof( BinProbModel ) );
+#endif
+      }
+    }
+    resetJournal( m_baseStateId );
+    addTouched  ( src.m_touched );
+  }
+  else if( src.m_baseStateId == ownStateId )
+  {
+    // this store holds the version the source was copied from, only the changes of the source are taken over
+    copyTouched( src, src.m_touched );
+    addTouched ( src.m_touched );
+  }
+  else
+  {
+    ::memcpy( m_Ctx, src.m_Ctx, sizeof( BinProbModel ) * ContextSetCfg::NumberOfContexts );
+#if ENABLE_CTX_COPY_STATS
+    CtxCopyStats::add( sizeof( BinProbModel ) * ContextSetCfg::NumberOfContexts );
+#endif
+    resetJournal( srcStateId );
+  }
+  m_stateId    = srcStateId;
+  m_stateDirty = false;
+#else
+  ::memcpy( m_Ctx, src.m_Ctx, sizeof( BinProbModel ) * ContextSetCfg::NumberOfContexts );
+#if ENABLE_CTX_COPY_STATS
+  CtxCopyStats::add( sizeof( BinProbModel ) * ContextSetCfg::NumberOfContexts );
+#endif
+#endif
+}
+
+template <class BinProbModel>
+void CtxStore<BinProbModel>::copyFrom( const CtxStore<BinProbModel>& src, const CtxSet& ctxSet )
+{
+  checkInit();
+  ::memcpy( m_Ctx + ctxSet.Offset, src.m_Ctx + ctxSet.Offset, sizeof( BinProbModel ) * ctxSet.Size );
+#if CTX_JOURNALED_COPY
+  for( unsigned ctxId = ctxSet.Offset; ctxId < ctxSet.Offset + ctxSet.Size; ctxId++ )
+  {
+    touch( ctxId );
+  }
+#endif
+#if ENABLE_CTX_COPY_STATS
+  CtxCopyStats::add( sizeof( BinProbModel ) * ctxSet.Size );
+#endif
+}
 
 template <class BinProbModel>
 void CtxStore<BinProbModel>::init( int qp, int initId )
 {
+#if CTX_JOURNALED_COPY
+  resetJournal( 0 );
+  m_stateDirty = true;
+#endif
   const std::vector<uint8_t>& initTable = ContextSetCfg::getInitTable( initId );
   CHECK( m_CtxBuffer.size() != initTable.size(),
         "Size of init table (" << initTable.size() << ") does not match size of context buffer (" << m_CtxBuffer.size() << ")." );
@@ -1693,6 +1889,10 @@ void CtxStore<BinProbModel>::init( int qp, int initId )
 template <class BinProbModel>
 void CtxStore<BinProbModel>::setWinSizes( const std::vector<uint8_t>& log2WindowSizes )
 {
+#if CTX_JOURNALED_COPY
+  resetJournal( 0 );
+  m_stateDirty = true;
+#endif
   CHECK( m_CtxBuffer.size() != log2WindowSizes.size(),
         "Size of window size table (" << log2WindowSizes.size() << ") does not match size of context buffer (" << m_CtxBuffer.size() << ")." );
   for( std::size_t k = 0; k < m_CtxBuffer.size(); k++ )
@@ -1704,6 +1904,10 @@ void CtxStore<BinProbModel>::setWinSizes( const std::vector<uint8_t>& log2Window
 template <class BinProbModel>
 void CtxStore<BinProbModel>::loadPStates( const std::vector<uint16_t>& probStates )
 {
+#if CTX_JOURNALED_COPY
+  resetJournal( 0 );
+  m_stateDirty = true;
+#endif
   CHECK( m_CtxBuffer.size() != probStates.size(),
         "Size of prob states table (" << probStates.size() << ") does not match size of context buffer (" << m_CtxBuffer.size() << ")." );
   for( std::size_t k = 0; k < m_CtxBuffer.size(); k++ )
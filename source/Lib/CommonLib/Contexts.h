@@ -43,6 +43,10 @@
 
 #include <vector>
 
+#if CTX_JOURNALED_COPY || ENABLE_CTX_COPY_STATS
+#include <atomic>
+#endif
+
 static constexpr int     PROB_BITS   = 15;   // Nominal number of bits to represent probabilities
 static constexpr int     PROB_BITS_0 = 10;   // Number of bits to represent 1st estimate
 static constexpr int     PROB_BITS_1 = 14;   // Number of bits to represent 2nd estimate
@@ -297,6 +301,21 @@ public:
 
 
 
+#if ENABLE_CTX_COPY_STATS
+/// bytes of context models copied by the CABAC context stores
+class CtxCopyStats
+{
+public:
+  static void add   ( const size_t numBytes ) { m_numBytes.fetch_add( numBytes, std::memory_order_relaxed ); }
+  static void addCtu()                        { m_numCtus .fetch_add( 1,        std::memory_order_relaxed ); }
+  static void report();
+
+private:
+  static std::atomic<uint64_t> m_numBytes;
+  static std::atomic<uint64_t> m_numCtus;
+};
+#endif
+
 template <class BinProbModel>
 class CtxStore : public FracBitsAccess
 {
@@ -305,25 +324,62 @@ public:
   CtxStore( bool dummy );
   CtxStore( const CtxStore<BinProbModel>& ctxStore );
 public:
-  void copyFrom   ( const CtxStore<BinProbModel>& src )                        { checkInit(); ::memcpy( m_Ctx,               src.m_Ctx,               sizeof( BinProbModel ) * ContextSetCfg::NumberOfContexts ); }
-  void copyFrom   ( const CtxStore<BinProbModel>& src, const CtxSet& ctxSet )  { checkInit(); ::memcpy( m_Ctx+ctxSet.Offset, src.m_Ctx+ctxSet.Offset, sizeof( BinProbModel ) * ctxSet.Size ); }
+  void copyFrom   ( const CtxStore<BinProbModel>& src );
+  void copyFrom   ( const CtxStore<BinProbModel>& src, const CtxSet& ctxSet );
   void init       ( int qp, int initId );
   void setWinSizes( const std::vector<uint8_t>&   log2WindowSizes );
   void loadPStates( const std::vector<uint16_t>&  probStates );
   void savePStates( std::vector<uint16_t>&        probStates )  const;
 
   const BinProbModel& operator[]      ( unsigned  ctxId  )  const { return m_Ctx[ctxId]; }
+#if CTX_JOURNALED_COPY
+  BinProbModel&       operator[]      ( unsigned  ctxId  )        { touch( ctxId ); return m_Ctx[ctxId]; }
+#else
   BinProbModel&       operator[]      ( unsigned  ctxId  )        { return m_Ctx[ctxId]; }
+#endif
   uint32_t            estFracBits     ( unsigned  bin,
                                         unsigned  ctxId  )  const { return m_Ctx[ctxId].estFracBits(bin); }
 
   BinFracBits         getFracBitsArray( unsigned  ctxId  )  const { return m_Ctx[ctxId].getFracBitsArray(); }
 
 private:
+#if CTX_JOURNALED_COPY
+  inline void checkInit() { if( m_Ctx ) return; m_CtxBuffer.resize( ContextSetCfg::NumberOfContexts ); m_Ctx = m_CtxBuffer.data(); initJournal(); }
+#else
   inline void checkInit() { if( m_Ctx ) return; m_CtxBuffer.resize( ContextSetCfg::NumberOfContexts ); m_Ctx = m_CtxBuffer.data(); }
+#endif
 private:
   std::vector<BinProbModel> m_CtxBuffer;
   BinProbModel*             m_Ctx;
+
+#if CTX_JOURNALED_COPY
+  // Journal of the context models changed since the store was last copied in full. Each content version of a store
+  // gets a unique id (assigned lazily, shared by stores with identical contents), and a store remembers the id of the
+  // version it was copied from. Copies between stores that derive from each other or from the same version only move
+  // the journaled models.
+  inline void touch( unsigned ctxId )
+  {
+    m_stateDirty = true;
+    if( !m_isTouched[ctxId] )
+    {
+      m_isTouched[ctxId] = 1;
+      m_touched.push_back( ctxId );
+    }
+  }
+  void     initJournal  ();
+  void     resetJournal ( const uint64_t baseStateId );
+  void     addTouched   ( const std::vector<uint16_t>& touched );
+  void     copyTouched  ( const CtxStore<BinProbModel>& src, const std::vector<uint16_t>& touched );
+  uint64_t getStateId   ()  const;
+
+  std::vector<uint16_t>     m_touched;
+  std::vector<uint8_t>      m_isTouched;
+  uint64_t                  m_baseStateId;
+  mutable uint64_t          m_stateId;
+  mutable bool              m_stateDirty;
+
+  static std::atomic<uint64_t> m_nextStateId;
+#endif
 };
 
 
@@ -360,6 +416,9 @@ public:
     default:        break;
     }
     ::memcpy( m_GRAdaptStats, ctx.m_GRAdaptStats, sizeof( unsigned ) * RExt__GOLOMB_RICE_ADAPTATION_STATISTICS_SETS );
+#if ENABLE_CTX_COPY_STATS
+    CtxCopyStats::add( sizeof( unsigned ) * RExt__GOLOMB_RICE_ADAPTATION_STATISTICS_SETS );
+#endif
     return *this;
   }
 
@@ -67,9 +67,6 @@ namespace DQIntern
     int32_t   bits[6];
   };
 
-
-  enum ScanPosType { SCAN_ISCSBB = 0, SCAN_SOCSBB = 1, SCAN_EOCSBB = 2 };
-
   struct ScanInfo
   {
     ScanInfo() {}
@@ -600,23 +597,6 @@ namespace DQIntern
   /*================================================================================*/
 
 
-  struct PQData
-  {
-    TCoeff  absLevel;
-    int64_t deltaDist;
-  };
-
-
-  struct Decision
-  {
-    int64_t rdCost;
-    TCoeff  absLevel;
-    int     prevId;
-  };
-
-
-
-
   /*================================================================================*/
   /*=====                                                                      =====*/
   /*=====   P R E - Q U A N T I Z E R                                          =====*/
@@ -852,11 +832,91 @@ namespace DQIntern
     {131072, 131072, 131072, 131072, 131072, 131072, 131072, 131072, 163840, 163840, 163840, 163840, 163840, 163840, 163840, 163840, 196608, 196608, 196608, 196608, 196608, 196608, 196608, 196608, 229376, 229376, 229376, 229376, 229376, 229376, 229376, 229376}
   };
 
+  static inline void checkRdCostsState( const StateMem& mem, const int stateId, const ScanPosType spt, const PQData& pqDataA, const PQData& pqDataB, Decision& decisionA, Decision& decisionB )
+  {
+    const int32_t*  goRiceTab = g_goRiceBits[mem.goRicePar[stateId]];
+    int64_t         rdCostA   = mem.rdCost[stateId] + pqDataA.deltaDist;
+    int64_t         rdCostB   = mem.rdCost[stateId] + pqDataB.deltaDist;
+    int64_t         rdCostZ   = mem.rdCost[stateId];
+    if( mem.remRegBins[stateId] >= 4 )
+    {
+      if( pqDataA.absLevel < 4 )
+        rdCostA += mem.coeffFracBits[pqDataA.absLevel][stateId];
+      else
+      {
+        const unsigned value = ( pqDataA.absLevel - 4 ) >> 1;
+        rdCostA += mem.coeffFracBits[pqDataA.absLevel - ( value << 1 )][stateId] + goRiceTab[ value < RICEMAX ? value : RICEMAX - 1 ];
+      }
+      if( pqDataB.absLevel < 4 )
+        rdCostB += mem.coeffFracBits[pqDataB.absLevel][stateId];
+      else
+      {
+        const unsigned value = ( pqDataB.absLevel - 4 ) >> 1;
+        rdCostB += mem.coeffFracBits[pqDataB.absLevel - ( value << 1 )][stateId] + goRiceTab[ value < RICEMAX ? value : RICEMAX - 1 ];
+      }
+      if( spt == SCAN_ISCSBB )
+      {
+        rdCostA += mem.sigFracBits[1][stateId];
+        rdCostB += mem.sigFracBits[1][stateId];
+        rdCostZ += mem.sigFracBits[0][stateId];
+      }
+      else if( spt == SCAN_SOCSBB )
+      {
+        rdCostA += mem.sbbFracBits[1][stateId] + mem.sigFracBits[1][stateId];
+        rdCostB += mem.sbbFracBits[1][stateId] + mem.sigFracBits[1][stateId];
+        rdCostZ += mem.sbbFracBits[1][stateId] + mem.sigFracBits[0][stateId];
+      }
+      else if( mem.numSigSbb[stateId] )
+      {
+        rdCostA += mem.sigFracBits[1][stateId];
+        rdCostB += mem.sigFracBits[1][stateId];
+        rdCostZ += mem.sigFracBits[0][stateId];
+      }
+      else
+      {
+        rdCostZ = decisionA.rdCost;
+      }
+    }
+    else
+    {
+      rdCostA += ( 1 << SCALE_BITS ) + goRiceTab[ pqDataA.absLevel <= mem.goRiceZero[stateId] ? pqDataA.absLevel - 1 : ( pqDataA.absLevel < RICEMAX ? pqDataA.absLevel : RICEMAX - 1 ) ];
+      rdCostB += ( 1 << SCALE_BITS ) + goRiceTab[ pqDataB.absLevel <= mem.goRiceZero[stateId] ? pqDataB.absLevel - 1 : ( pqDataB.absLevel < RICEMAX ? pqDataB.absLevel : RICEMAX - 1 ) ];
+      rdCostZ += goRiceTab[ mem.goRiceZero[stateId] ];
+    }
+    if( rdCostA < decisionA.rdCost )
+    {
+      decisionA.rdCost = rdCostA;
+      decisionA.absLevel = pqDataA.absLevel;
+      decisionA.prevId = stateId;
+    }
+    if( rdCostZ < decisionA.rdCost )
+    {
+      decisionA.rdCost = rdCostZ;
+      decisionA.absLevel = 0;
+      decisionA.prevId = stateId;
+    }
+    if( rdCostB < decisionB.rdCost )
+    {
+      decisionB.rdCost = rdCostB;
+      decisionB.absLevel = pqDataB.absLevel;
+      decisionB.prevId = stateId;
+    }
+  }
+
+  // checks the transitions from all four states of the previous scan position (the state transition table is hard-coded)
+  static void checkRdCostsCore( const StateMem& prevStates, const ScanPosType spt, const PQData* pqData, Decision* decisions )
+  {
+    checkRdCostsState( prevStates, 0, spt, pqData[0], pqData[2], decisions[0], decisions[2] );
+    checkRdCostsState( prevStates, 1, spt, pqData[0], pqData[2], decisions[2], decisions[0] );
+    checkRdCostsState( prevStates, 2, spt, pqData[3], pqData[1], decisions[1], decisions[3] );
+    checkRdCostsState( prevStates, 3, spt, pqData[3], pqData[1], decisions[3], decisions[1] );
+  }
+
   class State
   {
     friend class CommonCtx;
   public:
-    State( const RateEstimator& rateEst, CommonCtx& commonCtx, const int stateId );
+    State( const RateEstimator& rateEst, CommonCtx& commonCtx, StateMem& stateMem, const int stateId );
 
     template<uint8_t numIPos>
     inline void updateState(const ScanInfo &scanInfo, const State *prevStates, const Decision &decision);
@@ -865,97 +925,29 @@ namespace DQIntern
 
     inline void init()
     {
-      m_rdCost        = std::numeric_limits<int64_t>::max()>>1;
-      m_numSigSbb     = 0;
-      m_remRegBins    = 4;  // just large enough for last scan pos
-      m_refSbbCtxId   = -1;
-      m_sigFracBits   = m_sigFracBitsArray[ 0 ];
-      m_coeffFracBits = m_gtxFracBitsArray[ 0 ];
-      m_goRicePar     = 0;
-      m_goRiceZero    = 0;
+      m_mem.rdCost    [m_stateId] = std::numeric_limits<int64_t>::max()>>1;
+      m_mem.numSigSbb [m_stateId] = 0;
+      m_mem.remRegBins[m_stateId] = 4;  // just large enough for last scan pos
+      m_refSbbCtxId               = -1;
+      setSigFracBits  ( m_sigFracBitsArray[ 0 ] );
+      setCoeffFracBits( m_gtxFracBitsArray[ 0 ] );
+      m_mem.goRicePar [m_stateId] = 0;
+      m_mem.goRiceZero[m_stateId] = 0;
     }
-    void checkRdCosts( const ScanPosType spt, const PQData& pqDataA, const PQData& pqDataB, Decision& decisionA, Decision& decisionB ) const
-    {
-      const int32_t*  goRiceTab = g_goRiceBits[m_goRicePar];
-      int64_t         rdCostA   = m_rdCost + pqDataA.deltaDist;
-      int64_t         rdCostB   = m_rdCost + pqDataB.deltaDist;
-      int64_t         rdCostZ   = m_rdCost;
-        if( m_remRegBins >= 4 )
-        {
-          if( pqDataA.absLevel < 4 )
-            rdCostA += m_coeffFracBits.bits[ pqDataA.absLevel ];
-          else
-          {
-            const unsigned value = ( pqDataA.absLevel - 4 ) >> 1;
-            rdCostA += m_coeffFracBits.bits[ pqDataA.absLevel - ( value << 1 ) ] + goRiceTab[ value < RICEMAX ? value : RICEMAX - 1 ];
-          }
-          if( pqDataB.absLevel < 4 )
-            rdCostB += m_coeffFracBits.bits[ pqDataB.absLevel ];
-          else
-          {
-            const unsigned value = ( pqDataB.absLevel - 4 ) >> 1;
-            rdCostB += m_coeffFracBits.bits[ pqDataB.absLevel - ( value << 1 ) ] + goRiceTab[ value < RICEMAX ? value : RICEMAX - 1 ];
-          }
-          if( spt == SCAN_ISCSBB )
-          {
-            rdCostA += m_sigFracBits.intBits[ 1 ];
-            rdCostB += m_sigFracBits.intBits[ 1 ];
-            rdCostZ += m_sigFracBits.intBits[ 0 ];
-          }
-          else if( spt == SCAN_SOCSBB )
-          {
-            rdCostA += m_sbbFracBits.intBits[ 1 ] + m_sigFracBits.intBits[ 1 ];
-            rdCostB += m_sbbFracBits.intBits[ 1 ] + m_sigFracBits.intBits[ 1 ];
-            rdCostZ += m_sbbFracBits.intBits[ 1 ] + m_sigFracBits.intBits[ 0 ];
-          }
-          else if( m_numSigSbb )
-          {
-            rdCostA += m_sigFracBits.intBits[ 1 ];
-            rdCostB += m_sigFracBits.intBits[ 1 ];
-            rdCostZ += m_sigFracBits.intBits[ 0 ];
-          }
-          else
-          {
-            rdCostZ = decisionA.rdCost;
-          }
-        }
-        else
-        {
-          rdCostA += ( 1 << SCALE_BITS ) + goRiceTab[ pqDataA.absLevel <= m_goRiceZero ? pqDataA.absLevel - 1 : ( pqDataA.absLevel < RICEMAX ? pqDataA.absLevel : RICEMAX - 1 ) ];
-          rdCostB += ( 1 << SCALE_BITS ) + goRiceTab[ pqDataB.absLevel <= m_goRiceZero ? pqDataB.absLevel - 1 : ( pqDataB.absLevel < RICEMAX ? pqDataB.absLevel : RICEMAX - 1 ) ];
-          rdCostZ += goRiceTab[ m_goRiceZero ];
-        }
-        if( rdCostA < decisionA.rdCost )
-        {
-          decisionA.rdCost = rdCostA;
-          decisionA.absLevel = pqDataA.absLevel;
-          decisionA.prevId = m_stateId;
-        }
-        if( rdCostZ < decisionA.rdCost )
-        {
-          decisionA.rdCost = rdCostZ;
-          decisionA.absLevel = 0;
-          decisionA.prevId = m_stateId;
-        }
-        if( rdCostB < decisionB.rdCost )
-        {
-          decisionB.rdCost = rdCostB;
-          decisionB.absLevel = pqDataB.absLevel;
-          decisionB.prevId = m_stateId;
-        }
-      }
+
+    inline const StateMem& stateMem() const { return m_mem; }
 
     inline void checkRdCostStart(int32_t lastOffset, const PQData &pqData, Decision &decision) const
     {
       int64_t rdCost = pqData.deltaDist + lastOffset;
       if (pqData.absLevel < 4)
       {
-        rdCost += m_coeffFracBits.bits[pqData.absLevel];
+        rdCost += m_mem.coeffFracBits[pqData.absLevel][m_stateId];
       }
       else
       {
         const unsigned value = (pqData.absLevel - 4) >> 1;
-        rdCost += m_coeffFracBits.bits[pqData.absLevel - (value << 1)] + g_goRiceBits[m_goRicePar][value < RICEMAX ? value : RICEMAX-1];
+        rdCost += m_mem.coeffFracBits[pqData.absLevel - (value << 1)][m_stateId] + g_goRiceBits[m_mem.goRicePar[m_stateId]][value < RICEMAX ? value : RICEMAX-1];
       }
       if( rdCost < decision.rdCost )
       {
@@ -967,7 +959,7 @@ namespace DQIntern
 
     inline void checkRdCostSkipSbb(Decision &decision) const
     {
-      int64_t rdCost = m_rdCost + m_sbbFracBits.intBits[0];
+      int64_t rdCost = m_mem.rdCost[m_stateId] + m_mem.sbbFracBits[0][m_stateId];
       if( rdCost < decision.rdCost )
       {
         decision.rdCost   = rdCost;
@@ -978,24 +970,43 @@ namespace DQIntern
 
     inline void checkRdCostSkipSbbZeroOut(Decision &decision) const
     {
-      int64_t rdCost = m_rdCost + m_sbbFracBits.intBits[0];
+      int64_t rdCost = m_mem.rdCost[m_stateId] + m_mem.sbbFracBits[0][m_stateId];
       decision.rdCost = rdCost;
       decision.absLevel = 0;
       decision.prevId = 4 + m_stateId;
     }
 
   private:
-    int64_t                   m_rdCost;
+    inline void setSbbFracBits( const BinFracBits& fracBits )
+    {
+      m_mem.sbbFracBits[0][m_stateId] = fracBits.intBits[0];
+      m_mem.sbbFracBits[1][m_stateId] = fracBits.intBits[1];
+    }
+    inline void setSigFracBits( const BinFracBits& fracBits )
+    {
+      m_mem.sigFracBits[0][m_stateId] = fracBits.intBits[0];
+      m_mem.sigFracBits[1][m_stateId] = fracBits.intBits[1];
+    }
+    inline void setCoeffFracBits( const CoeffFracBits& fracBits )
+    {
+      for( int k = 0; k < 6; k++ )
+      {
+        m_mem.coeffFracBits[k][m_stateId] = fracBits.bits[k];
+      }
+    }
+    inline void copyRateState( const State& other )
+    {
+      m_mem.sbbFracBits[0][m_stateId] = other.m_mem.sbbFracBits[0][other.m_stateId];
+      m_mem.sbbFracBits[1][m_stateId] = other.m_mem.sbbFracBits[1][other.m_stateId];
+      m_mem.remRegBins    [m_stateId] = other.m_mem.remRegBins    [other.m_stateId];
+      m_mem.goRicePar     [m_stateId] = other.m_mem.goRicePar     [other.m_stateId];
+    }
+
+  private:
     uint16_t                  m_absLevelsAndCtxInit[24];  // 16x8bit for abs levels + 16x16bit for ctx init id
-    int8_t                    m_numSigSbb;
-    int                       m_remRegBins;
     int8_t                    m_refSbbCtxId;
-    BinFracBits               m_sbbFracBits;
-    BinFracBits               m_sigFracBits;
-    CoeffFracBits             m_coeffFracBits;
-    int8_t                    m_goRicePar;
-    int8_t                    m_goRiceZero;
     const int8_t              m_stateId;
+    StateMem&                 m_mem;
     const BinFracBits*const   m_sigFracBitsArray;
     const CoeffFracBits*const m_gtxFracBitsArray;
     CommonCtx&                m_commonCtx;
@@ -1005,48 +1016,51 @@ namespace DQIntern
   };
 
 
-  State::State( const RateEstimator& rateEst, CommonCtx& commonCtx, const int stateId )
-    : m_sbbFracBits     { { 0, 0 } }
-    , m_stateId         ( stateId )
+  State::State( const RateEstimator& rateEst, CommonCtx& commonCtx, StateMem& stateMem, const int stateId )
+    : m_stateId         ( stateId )
+    , m_mem             ( stateMem )
     , m_sigFracBitsArray( rateEst.sigFlagBits(stateId) )
     , m_gtxFracBitsArray( rateEst.gtxFracBits(stateId) )
     , m_commonCtx       ( commonCtx )
   {
+    setSbbFracBits( { { 0, 0 } } );
   }
 
   template<uint8_t numIPos>
   inline void State::updateState(const ScanInfo &scanInfo, const State *prevStates, const Decision &decision)
   {
-    m_rdCost = decision.rdCost;
+    int32_t& remRegBins = m_mem.remRegBins[m_stateId];
+    int8_t&  goRicePar  = m_mem.goRicePar [m_stateId];
+
+    m_mem.rdCost[m_stateId] = decision.rdCost;
     if( decision.prevId > -2 )
     {
       if( decision.prevId >= 0 )
       {
         const State*  prvState  = prevStates            +   decision.prevId;
-        m_numSigSbb             = prvState->m_numSigSbb + !!decision.absLevel;
+        m_mem.numSigSbb[m_stateId] = prvState->m_mem.numSigSbb[prvState->m_stateId] + !!decision.absLevel;
         m_refSbbCtxId           = prvState->m_refSbbCtxId;
-        m_sbbFracBits           = prvState->m_sbbFracBits;
-        m_remRegBins            = prvState->m_remRegBins - 1;
-        m_goRicePar             = prvState->m_goRicePar;
-        if( m_remRegBins >= 4 )
+        copyRateState( *prvState );
+        remRegBins             -= 1;
+        if( remRegBins >= 4 )
         {
-          m_remRegBins -= (decision.absLevel < 2 ? decision.absLevel : 3);
+          remRegBins -= (decision.absLevel < 2 ? decision.absLevel : 3);
         }
         ::memcpy( m_absLevelsAndCtxInit, prvState->m_absLevelsAndCtxInit, 48*sizeof(uint8_t) );
       }
       else
       {
-        m_numSigSbb     =  1;
+        m_mem.numSigSbb[m_stateId] =  1;
         m_refSbbCtxId   = -1;
         int ctxBinSampleRatio = (scanInfo.chType == CHANNEL_TYPE_LUMA) ? MAX_TU_LEVEL_CTX_CODED_BIN_CONSTRAINT_LUMA : MAX_TU_LEVEL_CTX_CODED_BIN_CONSTRAINT_CHROMA;
-        m_remRegBins = (effWidth * effHeight *ctxBinSampleRatio) / 16 - (decision.absLevel < 2 ? decision.absLevel : 3);
+        remRegBins = (effWidth * effHeight *ctxBinSampleRatio) / 16 - (decision.absLevel < 2 ? decision.absLevel : 3);
         ::memset( m_absLevelsAndCtxInit, 0, 48*sizeof(uint8_t) );
       }
 
       uint8_t* levels               = reinterpret_cast<uint8_t*>(m_absLevelsAndCtxInit);
       levels[ scanInfo.insidePos ]  = (uint8_t)std::min<TCoeff>( 255, decision.absLevel );
 
-      if (m_remRegBins >= 4)
+      if (remRegBins >= 4)
       {
         TCoeff  tinit = m_absLevelsAndCtxInit[8 + scanInfo.nextInsidePos];
         TCoeff  sumAbs1 = (tinit >> 3) & 31;
@@ -1084,8 +1098,8 @@ namespace DQIntern
         }
 #undef UPDATE
         TCoeff sumGt1 = sumAbs1 - sumNum;
-        m_sigFracBits = m_sigFracBitsArray[scanInfo.sigCtxOffsetNext + std::min( (sumAbs1+1)>>1, 3 )];
-        m_coeffFracBits = m_gtxFracBitsArray[scanInfo.gtxCtxOffsetNext + (sumGt1 < 4 ? sumGt1 : 4)];
+        setSigFracBits  ( m_sigFracBitsArray[scanInfo.sigCtxOffsetNext + std::min( (sumAbs1+1)>>1, 3 )] );
+        setCoeffFracBits( m_gtxFracBitsArray[scanInfo.gtxCtxOffsetNext + (sumGt1 < 4 ? sumGt1 : 4)] );
 
         TCoeff  sumAbs = m_absLevelsAndCtxInit[8 + scanInfo.nextInsidePos] >> 8;
 #define UPDATE(k) {TCoeff t=levels[scanInfo.nextNbInfoSbb.inPos[k]]; sumAbs+=t; }
@@ -1121,7 +1135,7 @@ namespace DQIntern
         }
 #undef UPDATE
         int sumAll = std::max(std::min(31, (int)sumAbs - 4 * 5), 0);
-        m_goRicePar = g_auiGoRiceParsCoeff[sumAll];
+        goRicePar = g_auiGoRiceParsCoeff[sumAll];
       }
       else
       {
@@ -1159,8 +1173,8 @@ namespace DQIntern
         }
 #undef UPDATE
         sumAbs = std::min<TCoeff>(31, sumAbs);
-        m_goRicePar = g_auiGoRiceParsCoeff[sumAbs];
-        m_goRiceZero = g_auiGoRicePosCoeff0(m_stateId, m_goRicePar);
+        goRicePar = g_auiGoRiceParsCoeff[sumAbs];
+        m_mem.goRiceZero[m_stateId] = g_auiGoRicePosCoeff0(m_stateId, goRicePar);
       }
     }
   }
@@ -1168,7 +1182,7 @@ namespace DQIntern
   inline void State::updateStateEOS(const ScanInfo &scanInfo, const State *prevStates, const State *skipStates,
                                     const Decision &decision)
   {
-    m_rdCost = decision.rdCost;
+    m_mem.rdCost[m_stateId] = decision.rdCost;
     if( decision.prevId > -2 )
     {
       const State* prvState = 0;
@@ -1176,18 +1190,18 @@ namespace DQIntern
       {
         CHECK( decision.absLevel != 0, "cannot happen" );
         prvState    = skipStates + ( decision.prevId - 4 );
-        m_numSigSbb = 0;
+        m_mem.numSigSbb[m_stateId] = 0;
         ::memset( m_absLevelsAndCtxInit, 0, 16*sizeof(uint8_t) );
       }
       else if( decision.prevId  >= 0 )
       {
         prvState    = prevStates            +   decision.prevId;
-        m_numSigSbb = prvState->m_numSigSbb + !!decision.absLevel;
+        m_mem.numSigSbb[m_stateId] = prvState->m_mem.numSigSbb[prvState->m_stateId] + !!decision.absLevel;
         ::memcpy( m_absLevelsAndCtxInit, prvState->m_absLevelsAndCtxInit, 16*sizeof(uint8_t) );
       }
       else
       {
-        m_numSigSbb = 1;
+        m_mem.numSigSbb[m_stateId] = 1;
         ::memset( m_absLevelsAndCtxInit, 0, 16*sizeof(uint8_t) );
       }
       reinterpret_cast<uint8_t*>(m_absLevelsAndCtxInit)[ scanInfo.insidePos ] = (uint8_t)std::min<TCoeff>( 255, decision.absLevel );
@@ -1198,15 +1212,17 @@ namespace DQIntern
       TCoeff  sumNum  =   tinit        & 7;
       TCoeff  sumAbs1 = ( tinit >> 3 ) & 31;
       TCoeff  sumGt1  = sumAbs1        - sumNum;
-      m_sigFracBits   = m_sigFracBitsArray[ scanInfo.sigCtxOffsetNext + std::min( (sumAbs1+1)>>1, 3 ) ];
-      m_coeffFracBits = m_gtxFracBitsArray[ scanInfo.gtxCtxOffsetNext + ( sumGt1  < 4 ? sumGt1  : 4 ) ];
+      setSigFracBits  ( m_sigFracBitsArray[ scanInfo.sigCtxOffsetNext + std::min( (sumAbs1+1)>>1, 3 ) ] );
+      setCoeffFracBits( m_gtxFracBitsArray[ scanInfo.gtxCtxOffsetNext + ( sumGt1  < 4 ? sumGt1  : 4 ) ] );
     }
   }
 
   inline void CommonCtx::update(const ScanInfo &scanInfo, const State *prevState, State &currState)
   {
-    uint8_t*    sbbFlags  = m_currSbbCtx[ currState.m_stateId ].sbbFlags;
-    uint8_t*    levels    = m_currSbbCtx[ currState.m_stateId ].levels;
+    StateMem&   currMem   = currState.m_mem;
+    const int   currId    = currState.m_stateId;
+    uint8_t*    sbbFlags  = m_currSbbCtx[ currId ].sbbFlags;
+    uint8_t*    levels    = m_currSbbCtx[ currId ].levels;
     std::size_t setCpSize = m_nbInfo[ scanInfo.scanIdx - 1 ].maxDist * sizeof(uint8_t);
     if( prevState && prevState->m_refSbbCtxId >= 0 )
     {
@@ -1218,23 +1234,23 @@ namespace DQIntern
       ::memset( sbbFlags,                  0, scanInfo.numSbb*sizeof(uint8_t) );
       ::memset( levels + scanInfo.scanIdx, 0, setCpSize );
     }
-    sbbFlags[ scanInfo.sbbPos ] = !!currState.m_numSigSbb;
+    sbbFlags[ scanInfo.sbbPos ] = !!currMem.numSigSbb[ currId ];
     ::memcpy( levels + scanInfo.scanIdx, currState.m_absLevelsAndCtxInit, scanInfo.sbbSize*sizeof(uint8_t) );
 
     const int       sigNSbb   = ( ( scanInfo.nextSbbRight ? sbbFlags[ scanInfo.nextSbbRight ] : false ) || ( scanInfo.nextSbbBelow ? sbbFlags[ scanInfo.nextSbbBelow ] : false ) ? 1 : 0 );
-    currState.m_numSigSbb     = 0;
+    currMem.numSigSbb[ currId ] = 0;
     if (prevState)
     {
-      currState.m_remRegBins = prevState->m_remRegBins;
+      currMem.remRegBins[ currId ] = prevState->m_mem.remRegBins[ prevState->m_stateId ];
     }
     else
     {
       int ctxBinSampleRatio = (scanInfo.chType == CHANNEL_TYPE_LUMA) ? MAX_TU_LEVEL_CTX_CODED_BIN_CONSTRAINT_LUMA : MAX_TU_LEVEL_CTX_CODED_BIN_CONSTRAINT_CHROMA;
-      currState.m_remRegBins = (currState.effWidth * currState.effHeight *ctxBinSampleRatio) / 16;
+      currMem.remRegBins[ currId ] = (currState.effWidth * currState.effHeight *ctxBinSampleRatio) / 16;
     }
-    currState.m_goRicePar     = 0;
-    currState.m_refSbbCtxId   = currState.m_stateId;
-    currState.m_sbbFracBits   = m_sbbFlagBits[ sigNSbb ];
+    currMem.goRicePar[ currId ] = 0;
+    currState.m_refSbbCtxId     = currId;
+    currState.setSbbFracBits( m_sbbFlagBits[ sigNSbb ] );
 
     uint16_t          templateCtxInit[16];
     const int         scanBeg   = scanInfo.scanIdx - scanInfo.sbbSize;
@@ -1285,7 +1301,7 @@ namespace DQIntern
   class DepQuant : private RateEstimator
   {
   public:
-    DepQuant();
+    DepQuant( CheckRdCostsFunc* checkRdCosts, TCoeff (*maxAbsCoeff)( const TCoeff*, const int ) );
 
     void    quant   ( TransformUnit& tu, const CCoeffBuf& srcCoeff, const ComponentID compID, const QpParam& cQP, const double lambda, const Ctx& ctx, TCoeff& absSum, bool enableScalingLists, int* quantCoeff );
     void    dequant ( const TransformUnit& tu, CoeffBuf& recCoeff, const ComponentID compID, const QpParam& cQP, bool enableScalingLists, int* quantCoeff );
@@ -1296,6 +1312,7 @@ namespace DQIntern
 
   private:
     CommonCtx   m_commonCtx;
+    StateMem    m_stateMem [ 4 ];
     State       m_allStates[ 12 ];
     State*      m_currStates;
     State*      m_prevStates;
@@ -1303,18 +1320,22 @@ namespace DQIntern
     State       m_startState;
     Quantizer   m_quant;
     Decision    m_trellis[ MAX_TB_SIZEY * MAX_TB_SIZEY ][ 8 ];
+    CheckRdCostsFunc* m_checkRdCosts;
+    TCoeff          (*m_maxAbsCoeff)( const TCoeff* src, const int numCoeff );
   };
 
 
-#define TINIT(x) {*this,m_commonCtx,x}
-  DepQuant::DepQuant()
+#define TINIT(m,x) {*this,m_commonCtx,m_stateMem[m],x}
+  DepQuant::DepQuant( CheckRdCostsFunc* checkRdCosts, TCoeff (*maxAbsCoeff)( const TCoeff*, const int ) )
     : RateEstimator ()
     , m_commonCtx   ()
-    , m_allStates   {TINIT(0),TINIT(1),TINIT(2),TINIT(3),TINIT(0),TINIT(1),TINIT(2),TINIT(3),TINIT(0),TINIT(1),TINIT(2),TINIT(3)}
+    , m_allStates   {TINIT(0,0),TINIT(0,1),TINIT(0,2),TINIT(0,3),TINIT(1,0),TINIT(1,1),TINIT(1,2),TINIT(1,3),TINIT(2,0),TINIT(2,1),TINIT(2,2),TINIT(2,3)}
     , m_currStates  (  m_allStates      )
     , m_prevStates  (  m_currStates + 4 )
     , m_skipStates  (  m_prevStates + 4 )
-    , m_startState  TINIT(0)
+    , m_startState  TINIT(3,0)
+    , m_checkRdCosts( checkRdCosts )
+    , m_maxAbsCoeff ( maxAbsCoeff )
   {}
 #undef TINIT
 
@@ -1348,10 +1369,7 @@ namespace DQIntern
 
     PQData  pqData[4];
     m_quant.preQuantCoeff( absCoeff, pqData, quanCoeff );
-    m_prevStates[0].checkRdCosts( spt, pqData[0], pqData[2], decisions[0], decisions[2]);
-    m_prevStates[1].checkRdCosts( spt, pqData[0], pqData[2], decisions[2], decisions[0]);
-    m_prevStates[2].checkRdCosts( spt, pqData[3], pqData[1], decisions[1], decisions[3]);
-    m_prevStates[3].checkRdCosts( spt, pqData[3], pqData[1], decisions[3], decisions[1]);
+    m_checkRdCosts( m_prevStates->stateMem(), spt, pqData, decisions );
     if( spt==SCAN_EOCSBB )
     {
         m_skipStates[0].checkRdCostSkipSbb( decisions[0] );
@@ -1474,6 +1492,18 @@ namespace DQIntern
     }
     const TCoeff defaultQuantisationCoefficient = (TCoeff)m_quant.getQScale();
     const TCoeff thres = m_quant.getLastThreshold();
+    if( !enableScalingLists )
+    {
+      // no coefficient exceeds the threshold for the last position, the trellis would not be started
+      const bool allZero = m_maxAbsCoeff( tCoeff, numCoeff ) <= TCoeff( thres / ( 4 * defaultQuantisationCoefficient ) );
+#if ENABLE_QUANT_ZERO_TU_STATS
+      QuantZeroTUStats::count( area, cQP.Qp( false ), allZero );
+#endif
+      if( allZero )
+      {
+        return;
+      }
+    }
     for( ; firstTestPos >= 0; firstTestPos-- )
     {
       if (zeroOutforThres && (tuPars.m_scanId2BlkPos[firstTestPos].x >= ((tuPars.m_width == 32 && zeroOut) ? 16 : 32)
@@ -1559,7 +1589,13 @@ DepQuant::DepQuant( const Quant* other, bool enc ) : QuantRDOQ( other )
 {
   const DepQuant* dq = dynamic_cast<const DepQuant*>( other );
   CHECK( other && !dq, "The DepQuant cast must be successfull!" );
-  p = new DQIntern::DepQuant();
+  m_checkRdCosts = DQIntern::checkRdCostsCore;
+#if ENABLE_SIMD_OPT_DEPQUANT
+#ifdef TARGET_SIMD_X86
+  initDepQuantX86();
+#endif
+#endif
+  p = new DQIntern::DepQuant( m_checkRdCosts, m_maxAbsCoeff );
   if( enc )
   {
     DQIntern::g_Rom.init();
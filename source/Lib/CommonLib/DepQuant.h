@@ -44,7 +44,40 @@
 #include "QuantRDOQ.h"
 
 
+namespace DQIntern
+{
+  enum ScanPosType { SCAN_ISCSBB = 0, SCAN_SOCSBB = 1, SCAN_EOCSBB = 2 };
+
+  struct PQData
+  {
+    TCoeff  absLevel;
+    int64_t deltaDist;
+  };
+
+  struct Decision
+  {
+    int64_t rdCost;
+    TCoeff  absLevel;
+    int     prevId;
+  };
+
+  // rate estimation data of the four states of one trellis stage, stored as structure of arrays (index = state id)
+  struct StateMem
+  {
+    int64_t   rdCost       [4];
+    int32_t   remRegBins   [4];
+    int32_t   sbbFracBits  [2][4];
+    int32_t   sigFracBits  [2][4];
+    int32_t   coeffFracBits[6][4];
+    int8_t    numSigSbb    [4];
+    int8_t    goRicePar    [4];
+    int8_t    goRiceZero   [4];
+  };
 
+  typedef void CheckRdCostsFunc( const StateMem& prevStates, const ScanPosType spt, const PQData* pqData, Decision* decisions );
+
+  extern const int32_t g_goRiceBits[4][32];
+}
 
 
 class DepQuant : public QuantRDOQ
@@ -58,6 +91,14 @@ public:
 
 private:
   void* p;
+
+  DQIntern::CheckRdCostsFunc* m_checkRdCosts;
+
+#if ENABLE_SIMD_OPT_DEPQUANT && defined( TARGET_SIMD_X86 )
+  void initDepQuantX86();
+  template <X86_VEXT vext>
+  void _initDepQuantX86();
+#endif
 };
 
 
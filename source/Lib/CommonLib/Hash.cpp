@@ -39,6 +39,10 @@
 #include "CommonLib/UnitTools.h"
 #include "Hash.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 
 
  // ====================================================================================================================
@@ -46,12 +50,20 @@
  // ====================================================================================================================
 
 int TComHash::m_blockSizeToIndex[65][65];
-TCRCCalculatorLight TComHash::m_crcCalculator1(24, 0x5D6DCB);
 TCRCCalculatorLight TComHash::m_crcCalculator2(24, 0x864CFB);
+uint32_t (*TComHash::m_calcCRC32C)(const unsigned char* p, int length) = TComHash::xCalcCRC32C;
+
+static int getNumHashThreads(const int numJobs)
+{
+#ifdef _OPENMP
+  return std::max(1, std::min(numJobs, omp_get_max_threads()));
+#else
+  return 1;
+#endif
+}
 
 TCRCCalculatorLight::TCRCCalculatorLight(uint32_t bits, uint32_t truncPoly)
 {
-  m_remainder = 0;
   m_bits = bits;
   m_truncPoly = truncPoly;
   m_finalResultMask = (1 << bits) - 1;
@@ -94,20 +106,22 @@ void TCRCCalculatorLight::xInitTable()
   }
 }
 
-void TCRCCalculatorLight::processData(unsigned char* curData, uint32_t dataLength)
+uint32_t TCRCCalculatorLight::getCRC(const unsigned char* curData, uint32_t dataLength) const
 {
+  // the remainder is local, the calculator can be shared between threads
+  uint32_t remainder = 0;
   for (uint32_t i = 0; i < dataLength; i++)
   {
-    unsigned char index = (m_remainder >> (m_bits - 8)) ^ curData[i];
-    m_remainder <<= 8;
-    m_remainder ^= m_table[index];
+    unsigned char index = (remainder >> (m_bits - 8)) ^ curData[i];
+    remainder <<= 8;
+    remainder ^= m_table[index];
   }
+  return remainder & m_finalResultMask;
 }
 
 
 TComHash::TComHash()
 {
-  m_lookupTable = NULL;
   tableHasContent = false;
   for (int i = 0; i < 5; i++)
   {
@@ -118,18 +132,10 @@ TComHash::TComHash()
 TComHash::~TComHash()
 {
   clearAll();
-  if (m_lookupTable != NULL)
-  {
-    delete[] m_lookupTable;
-    m_lookupTable = NULL;
-  }
 }
 void TComHash::create(int picWidth, int picHeight)
 {
-  if (m_lookupTable)
-  {
-    clearAll();
-  }
+  clearAll();
   if (!hashPic[0])
   {
     for (int k = 0; k < 5; k++)
@@ -137,14 +143,7 @@ void TComHash::create(int picWidth, int picHeight)
       hashPic[k] = new uint16_t[picWidth*picHeight];
     }
   }
-  if (m_lookupTable)
-  {
-    return;
-  }
-  int maxAddr = 1 << (m_CRCBits + m_blockSizeBits);
-  m_lookupTable = new std::vector<BlockHash>*[maxAddr];
-  memset(m_lookupTable, 0, sizeof(std::vector<BlockHash>*) * maxAddr);
-  tableHasContent = false;
+  m_bucketStart.assign(m_numBlockSizes * (m_numBuckets + 1), 0);
 }
 
 void TComHash::clearAll()
@@ -158,78 +157,27 @@ void TComHash::clearAll()
     }
   }
   tableHasContent = false;
-  if (m_lookupTable == NULL)
-  {
-    return;
-  }
-  int maxAddr = 1 << (m_CRCBits + m_blockSizeBits);
-  for (int i = 0; i < maxAddr; i++)
-  {
-    if (m_lookupTable[i] != NULL)
-    {
-      delete m_lookupTable[i];
-      m_lookupTable[i] = NULL;
-    }
-  }
-}
-
-void TComHash::addToTable(uint32_t hashValue, const BlockHash& blockHash)
-{
-  if (m_lookupTable[hashValue] == NULL)
-  {
-    m_lookupTable[hashValue] = new std::vector<BlockHash>;
-    m_lookupTable[hashValue]->push_back(blockHash);
-  }
-  else
-  {
-    m_lookupTable[hashValue]->push_back(blockHash);
-  }
-}
-
-int TComHash::count(uint32_t hashValue)
-{
-  if (m_lookupTable[hashValue] == NULL)
-  {
-    return 0;
-  }
-  else
-  {
-    return static_cast<int>(m_lookupTable[hashValue]->size());
-  }
+  std::vector<BlockHash>().swap(m_entries);
+  std::fill(m_bucketStart.begin(), m_bucketStart.end(), 0);
 }
 
 int TComHash::count(uint32_t hashValue) const
 {
-  if (m_lookupTable[hashValue] == NULL)
-  {
-    return 0;
-  }
-  else
-  {
-    return static_cast<int>(m_lookupTable[hashValue]->size());
-  }
+  const uint32_t* bucket = xGetBucket(hashValue);
+  return static_cast<int>(bucket[1] - bucket[0]);
 }
 
-MapIterator TComHash::getFirstIterator(uint32_t hashValue)
+MapIterator TComHash::getFirstIterator(uint32_t hashValue) const
 {
-  return m_lookupTable[hashValue]->begin();
+  return m_entries.begin() + xGetBucket(hashValue)[0];
 }
 
-const MapIterator TComHash::getFirstIterator(uint32_t hashValue) const
+bool TComHash::hasExactMatch(uint32_t hashValue1, uint32_t hashValue2) const
 {
-  return m_lookupTable[hashValue]->begin();
-}
-
-bool TComHash::hasExactMatch(uint32_t hashValue1, uint32_t hashValue2)
-{
-  if (m_lookupTable[hashValue1] == NULL)
-  {
-    return false;
-  }
-  std::vector<BlockHash>::iterator it;
-  for (it = m_lookupTable[hashValue1]->begin(); it != m_lookupTable[hashValue1]->end(); it++)
+  const uint32_t* bucket = xGetBucket(hashValue1);
+  for (uint32_t i = bucket[0]; i < bucket[1]; i++)
   {
-    if ((*it).hashValue2 == hashValue2)
+    if (m_entries[i].hashValue2 == hashValue2)
     {
       return true;
     }
@@ -251,11 +199,14 @@ void TComHash::generateBlock2x2HashValue(const PelUnitBuf &curPicBuf, int picWid
     length *= 3;
     includeChroma = true;
   }
-  unsigned char* p = new unsigned char[length];
 
-  int pos = 0;
+  // the rows are independent, pos = yPos * picWidth + xPos
+  const int numThreads = getNumHashThreads(yEnd);
+#pragma omp parallel for num_threads(numThreads) if(numThreads > 1)
   for (int yPos = 0; yPos < yEnd; yPos++)
   {
+    unsigned char p[12];
+    int pos = yPos * picWidth;
     for (int xPos = 0; xPos < xEnd; xPos++)
     {
       TComHash::getPixelsIn1DCharArrayByBlock2x2(curPicBuf, p, xPos, yPos, bitDepths, includeChroma);
@@ -267,10 +218,7 @@ void TComHash::generateBlock2x2HashValue(const PelUnitBuf &curPicBuf, int picWid
 
       pos++;
     }
-    pos += width - 1;
   }
-
-  delete[] p;
 }
 
 void TComHash::generateBlockHashValue(int picWidth, int picHeight, int width, int height, uint32_t* srcPicBlockHash[2], uint32_t* dstPicBlockHash[2], bool* srcPicBlockSameInfo[3], bool* dstPicBlockSameInfo[3])
@@ -285,10 +233,12 @@ void TComHash::generateBlockHashValue(int picWidth, int picHeight, int width, in
 
   int length = 4 * sizeof(uint32_t);
 
-  uint32_t p[4];
-  int pos = 0;
+  const int numThreads = getNumHashThreads(yEnd);
+#pragma omp parallel for num_threads(numThreads) if(numThreads > 1)
   for (int yPos = 0; yPos < yEnd; yPos++)
   {
+    uint32_t p[4];
+    int pos = yPos * picWidth;
     for (int xPos = 0; xPos < xEnd; xPos++)
     {
       p[0] = srcPicBlockHash[0][pos];
@@ -309,23 +259,11 @@ void TComHash::generateBlockHashValue(int picWidth, int picHeight, int width, in
       dstPicBlockSameInfo[1][pos] = srcPicBlockSameInfo[1][pos] && srcPicBlockSameInfo[1][pos + srcWidth] && srcPicBlockSameInfo[1][pos + quadHeight * picWidth]
         && srcPicBlockSameInfo[1][pos + quadHeight * picWidth + srcWidth] && srcPicBlockSameInfo[1][pos + srcHeight * picWidth] && srcPicBlockSameInfo[1][pos + srcHeight * picWidth + srcWidth];
 
-      pos++;
-    }
-    pos += width - 1;
-  }
-
-  if (width >= 4)
-  {
-    pos = 0;
-
-    for (int yPos = 0; yPos < yEnd; yPos++)
-    {
-      for (int xPos = 0; xPos < xEnd; xPos++)
+      if (width >= 4)
       {
         dstPicBlockSameInfo[2][pos] = (!dstPicBlockSameInfo[0][pos] && !dstPicBlockSameInfo[1][pos]);
-        pos++;
       }
-      pos += width - 1;
+      pos++;
     }
   }
 }
@@ -340,28 +278,77 @@ void TComHash::addToHashMapByRowWithPrecalData(uint32_t* picHash[2], bool* picIs
 
   int addValue = m_blockSizeToIndex[width][height];
   CHECK(addValue < 0, "Wrong")
-  addValue <<= m_CRCBits;
+  uint32_t* bucketStart = &m_bucketStart[addValue * (m_numBuckets + 1)];
   int crcMask = 1 << m_CRCBits;
   crcMask -= 1;
   int blockIdx = floorLog2(width) - 2;
 
-  for (int xPos = 0; xPos < xEnd; xPos++)
+  if (xEnd <= 0 || yEnd <= 0)
+  {
+    return;
+  }
+
+  const int numThreads = getNumHashThreads(yEnd);
+#pragma omp parallel for num_threads(numThreads) if(numThreads > 1)
+  for (int yPos = 0; yPos < yEnd; yPos++)
   {
-    for (int yPos = 0; yPos < yEnd; yPos++)
+    for (int xPos = 0, pos = yPos * picWidth; xPos < xEnd; xPos++, pos++)
     {
-      int pos = yPos * picWidth + xPos;
       hashPic[blockIdx][pos] = (uint16_t)(srcHash[1][pos] & crcMask);
-      //valid data
-      if (srcIsAdded[pos])
+    }
+  }
+
+  // counting sort into the flat table: every thread takes a range of columns and counts its entries per bucket,
+  // the entries of a bucket keep the column-major insertion order (x, then y) of the original per-bucket lists
+  const int numColThreads = getNumHashThreads(xEnd);
+  std::vector<uint32_t> bucketPos((size_t)numColThreads * m_numBuckets, 0);
+
+#pragma omp parallel for num_threads(numColThreads) if(numColThreads > 1)
+  for (int t = 0; t < numColThreads; t++)
+  {
+    uint32_t* count = &bucketPos[(size_t)t * m_numBuckets];
+    for (int xPos = t * xEnd / numColThreads; xPos < (t + 1) * xEnd / numColThreads; xPos++)
+    {
+      for (int yPos = 0, pos = xPos; yPos < yEnd; yPos++, pos += picWidth)
       {
-        BlockHash blockHash;
-        blockHash.x = xPos;
-        blockHash.y = yPos;
+        if (srcIsAdded[pos])
+        {
+          count[srcHash[0][pos] & crcMask]++;
+        }
+      }
+    }
+  }
 
-        uint32_t hashValue1 = (srcHash[0][pos] & crcMask) + addValue;
-        blockHash.hashValue2 = srcHash[1][pos];
+  uint32_t numEntries = (uint32_t)m_entries.size();
+  for (int b = 0; b < m_numBuckets; b++)
+  {
+    bucketStart[b] = numEntries;
+    for (int t = 0; t < numColThreads; t++)
+    {
+      const uint32_t count = bucketPos[(size_t)t * m_numBuckets + b];
+      bucketPos[(size_t)t * m_numBuckets + b] = numEntries;
+      numEntries += count;
+    }
+  }
+  bucketStart[m_numBuckets] = numEntries;
+  m_entries.resize(numEntries);
 
-        addToTable(hashValue1, blockHash);
+#pragma omp parallel for num_threads(numColThreads) if(numColThreads > 1)
+  for (int t = 0; t < numColThreads; t++)
+  {
+    uint32_t* nextEntry = &bucketPos[(size_t)t * m_numBuckets];
+    for (int xPos = t * xEnd / numColThreads; xPos < (t + 1) * xEnd / numColThreads; xPos++)
+    {
+      for (int yPos = 0, pos = xPos; yPos < yEnd; yPos++, pos += picWidth)
+      {
+        //valid data
+        if (srcIsAdded[pos])
+        {
+          BlockHash& blockHash = m_entries[nextEntry[srcHash[0][pos] & crcMask]++];
+          blockHash.x = xPos;
+          blockHash.y = yPos;
+          blockHash.hashValue2 = srcHash[1][pos];
+        }
       }
     }
   }
@@ -561,19 +548,10 @@ bool TComHash::getBlockHashValue(const PelUnitBuf &curPicBuf, int width, int hei
     includeChroma = true;
   }
 
-  unsigned char* p = new unsigned char[length];
+  unsigned char p[12];
   uint32_t toHash[4];
 
-  int block2x2Num = (width*height) >> 2;
-
-  uint32_t* hashValueBuffer[2][2];
-  for (int i = 0; i < 2; i++)
-  {
-    for (int j = 0; j < 2; j++)
-    {
-      hashValueBuffer[i][j] = new uint32_t[block2x2Num];
-    }
-  }
+  uint32_t hashValueBuffer[2][2][(64 * 64) >> 2];
 
   //2x2 subblock hash values in current CU
   int subBlockInWidth = (width >> 1);
@@ -669,16 +647,6 @@ bool TComHash::getBlockHashValue(const PelUnitBuf &curPicBuf, int width, int hei
   hashValue1 = (hashValueBuffer[0][dstIdx][0] & crcMask) + addValue;
   hashValue2 = hashValueBuffer[1][dstIdx][0];
 
-  for (int i = 0; i < 2; i++)
-  {
-    for (int j = 0; j < 2; j++)
-    {
-      delete[] hashValueBuffer[i][j];
-    }
-  }
-
-  delete[] p;
-
   return true;
 }
 
@@ -697,19 +665,48 @@ void TComHash::initBlockSizeToIndex()
   m_blockSizeToIndex[32][32] = 2;
   m_blockSizeToIndex[64][64] = 3;
   m_blockSizeToIndex[4][4] = 4;
+
+#if ENABLE_SIMD_OPT_HASH && defined( TARGET_SIMD_X86 )
+  initTComHashX86();
+#endif
 }
 
 uint32_t TComHash::getCRCValue1(unsigned char* p, int length)
 {
-  m_crcCalculator1.reset();
-  m_crcCalculator1.processData(p, length);
-  return m_crcCalculator1.getCRC();
+  return m_calcCRC32C(p, length);
 }
 
 uint32_t TComHash::getCRCValue2(unsigned char* p, int length)
 {
-  m_crcCalculator2.reset();
-  m_crcCalculator2.processData(p, length);
-  return m_crcCalculator2.getCRC();
+  return m_crcCalculator2.getCRC(p, length);
+}
+
+struct TCRC32CTable
+{
+  // reflected CRC-32C (Castagnoli) polynomial, same results as the SSE4.2 crc32 instruction
+  TCRC32CTable()
+  {
+    for (uint32_t value = 0; value < 256; value++)
+    {
+      uint32_t remainder = value;
+      for (int bit = 0; bit < 8; bit++)
+      {
+        remainder = (remainder >> 1) ^ ((remainder & 1) ? 0x82F63B78 : 0);
+      }
+      m_table[value] = remainder;
+    }
+  }
+  uint32_t m_table[256];
+};
+
+uint32_t TComHash::xCalcCRC32C(const unsigned char* p, int length)
+{
+  static const TCRC32CTable crcTable;
+  uint32_t crc = 0;
+  for (int i = 0; i < length; i++)
+  {
+    crc = crcTable.m_table[(crc ^ p[i]) & 0xff] ^ (crc >> 8);
+  }
+  return crc;
 }
 //! \}
@@ -56,7 +56,7 @@ struct BlockHash
   uint32_t hashValue2;
 };
 
-typedef std::vector<BlockHash>::iterator MapIterator;
+typedef std::vector<BlockHash>::const_iterator MapIterator;
 
 // ====================================================================================================================
 // Class definitions
@@ -70,15 +70,12 @@ public:
   ~TCRCCalculatorLight();
 
 public:
-  void processData(unsigned char* curData, uint32_t dataLength);
-  void reset() { m_remainder = 0; }
-  uint32_t getCRC() { return m_remainder & m_finalResultMask; }
+  uint32_t getCRC(const unsigned char* curData, uint32_t dataLength) const;
 
 private:
   void xInitTable();
 
 private:
-  uint32_t m_remainder;
   uint32_t m_truncPoly;
   uint32_t m_bits;
   uint32_t m_table[256];
@@ -93,12 +90,9 @@ public:
   ~TComHash();
   void create(int picWidth, int picHeight);
   void clearAll();
-  void addToTable(uint32_t hashValue, const BlockHash& blockHash);
-  int count(uint32_t hashValue);
   int count(uint32_t hashValue) const;
-  MapIterator getFirstIterator(uint32_t hashValue);
-  const MapIterator getFirstIterator(uint32_t hashValue) const;
-  bool hasExactMatch(uint32_t hashValue1, uint32_t hashValue2);
+  MapIterator getFirstIterator(uint32_t hashValue) const;
+  bool hasExactMatch(uint32_t hashValue1, uint32_t hashValue2) const;
 
   void generateBlock2x2HashValue(const PelUnitBuf &curPicBuf, int picWidth, int picHeight, const BitDepths bitDepths, uint32_t* picBlockHash[2], bool* picBlockSameInfo[3]);
   void generateBlockHashValue(int picWidth, int picHeight, int width, int height, uint32_t* srcPicBlockHash[2], uint32_t* dstPicBlockHash[2], bool* srcPicBlockSameInfo[3], bool* dstPicBlockSameInfo[3]);
@@ -119,17 +113,32 @@ public:
   static bool isHorizontalPerfectLuma(const Pel* srcPel, int stride, int width, int height);
   static bool isVerticalPerfectLuma(const Pel* srcPel, int stride, int width, int height);
 
+#if ENABLE_SIMD_OPT_HASH && defined( TARGET_SIMD_X86 )
+  static void initTComHashX86();
+  template <X86_VEXT vext>
+  static void _initTComHashX86();
+#endif
+
+private:
+  static uint32_t xCalcCRC32C(const unsigned char* p, int length);
+  const uint32_t* xGetBucket(uint32_t hashValue) const { return &m_bucketStart[(hashValue >> m_CRCBits) * (m_numBuckets + 1) + (hashValue & (m_numBuckets - 1))]; }
+
 private:
-  std::vector<BlockHash>** m_lookupTable;
+  // flat table, the entries of each block size are sorted by bucket and lie in [ bucketStart[b], bucketStart[b+1] ) of that size
+  std::vector<BlockHash> m_entries;
+  std::vector<uint32_t>  m_bucketStart;
   bool tableHasContent;
   uint16_t* hashPic[5];//4x4 ~ 64x64
 
 private:
   static const int m_CRCBits = 16;
   static const int m_blockSizeBits = 3;
+  static const int m_numBuckets = 1 << m_CRCBits;
+  static const int m_numBlockSizes = 5;
   static int m_blockSizeToIndex[65][65];
 
-  static TCRCCalculatorLight m_crcCalculator1;
+  static uint32_t (*m_calcCRC32C)(const unsigned char* p, int length);
+
   static TCRCCalculatorLight m_crcCalculator2;
 };
 
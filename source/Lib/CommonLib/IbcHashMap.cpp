@@ -40,6 +40,10 @@
 #include "CommonLib/UnitTools.h"
 #include "IbcHashMap.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 
 using namespace std;
 
@@ -55,7 +59,10 @@ IbcHashMap::IbcHashMap()
   m_picWidth = 0;
   m_picHeight = 0;
   m_pos2Hash = NULL;
+  m_pos2Entry = NULL;
+  m_picHashMapValid = false;
   m_computeCrc32c = xxComputeCrc32c16bit;
+  m_calcBlockHash = xxCalcBlockHash;
 
 #if ENABLE_SIMD_OPT_IBC
 #ifdef TARGET_SIMD_X86
@@ -72,19 +79,37 @@ IbcHashMap::~IbcHashMap()
 
 void IbcHashMap::init(const int picWidth, const int picHeight)
 {
-  if (picWidth != m_picWidth || picHeight != m_picHeight)
+  // a new picture, the buffers are kept when the size does not change
+  m_picHashMapValid = false;
+  if (m_pos2Hash != NULL && picWidth == m_picWidth && picHeight == m_picHeight)
   {
-    destroy();
+    return;
   }
+  destroy();
 
   m_picWidth = picWidth;
   m_picHeight = picHeight;
   m_pos2Hash = new unsigned int*[m_picHeight];
   m_pos2Hash[0] = new unsigned int[m_picWidth * m_picHeight];
+  m_pos2Entry = new unsigned int*[m_picHeight];
+  m_pos2Entry[0] = new unsigned int[m_picWidth * m_picHeight];
   for (int n = 1; n < m_picHeight; n++)
   {
     m_pos2Hash[n] = m_pos2Hash[n - 1] + m_picWidth;
+    m_pos2Entry[n] = m_pos2Entry[n - 1] + m_picWidth;
+  }
+
+  // at most one entry per position, the table is kept at most half full
+  const size_t numPos = (size_t)m_picWidth * m_picHeight;
+  size_t tableSize = 1;
+  while (tableSize < 2 * numPos)
+  {
+    tableSize <<= 1;
   }
+  m_hashTable.assign(tableSize, 0);
+  m_entryHash.reserve(numPos);
+  m_posStart.reserve(numPos + 1);
+  m_posPool.reserve(numPos);
 }
 
 void IbcHashMap::destroy()
@@ -98,6 +123,18 @@ void IbcHashMap::destroy()
     delete[] m_pos2Hash;
   }
   m_pos2Hash = NULL;
+  if (m_pos2Entry != NULL)
+  {
+    delete[] m_pos2Entry[0];
+    delete[] m_pos2Entry;
+  }
+  m_pos2Entry = NULL;
+  m_picHashMapValid = false;
+
+  std::vector<unsigned int>().swap(m_entryHash);
+  std::vector<unsigned int>().swap(m_posStart);
+  std::vector<Position>().swap(m_posPool);
+  std::vector<unsigned int>().swap(m_hashTable);
 }
 ////////////////////////////////////////////////////////
 // CRC32C calculation in C code, same results as SSE 4.2's implementation
@@ -184,19 +221,37 @@ uint32_t IbcHashMap::xxComputeCrc32c16bit(uint32_t crc, const Pel pel)
 // CRC calculation in C code
 ////////////////////////////////////////////////////////
 
-unsigned int IbcHashMap::xxCalcBlockHash(const Pel* pel, const int stride, const int width, const int height, unsigned int crc)
+uint32_t IbcHashMap::xxCalcBlockHash(const Pel* pel, const int stride, const int width, const int height, uint32_t crc)
 {
   for (int y = 0; y < height; y++)
   {
     for (int x = 0; x < width; x++)
     {
-      crc = m_computeCrc32c(crc, pel[x]);
+      crc = xxComputeCrc32c16bit(crc, pel[x]);
     }
     pel += stride;
   }
   return crc;
 }
 
+unsigned int IbcHashMap::xxGetEntry(const unsigned int hashValue)
+{
+  // linear probing, the CRC values are spread well enough to use their low bits as slot index
+  const size_t mask = m_hashTable.size() - 1;
+  size_t slot = hashValue & mask;
+  while (m_hashTable[slot] != 0)
+  {
+    if (m_entryHash[m_hashTable[slot] - 1] == hashValue)
+    {
+      return m_hashTable[slot] - 1;
+    }
+    slot = (slot + 1) & mask;
+  }
+  m_entryHash.push_back(hashValue);
+  m_hashTable[slot] = (unsigned int)m_entryHash.size();
+  return m_hashTable[slot] - 1;
+}
+
 template<ChromaFormat chromaFormat>
 void IbcHashMap::xxBuildPicHashMap(const PelUnitBuf& pic)
 {
@@ -204,49 +259,103 @@ void IbcHashMap::xxBuildPicHashMap(const PelUnitBuf& pic)
   const int chromaScalingY = getChannelTypeScaleY(CHANNEL_TYPE_CHROMA, chromaFormat);
   const int chromaMinBlkWidth = MIN_PU_SIZE >> chromaScalingX;
   const int chromaMinBlkHeight = MIN_PU_SIZE >> chromaScalingY;
-  const Pel* pelY = NULL;
-  const Pel* pelCb = NULL;
-  const Pel* pelCr = NULL;
-
-  Position pos;
-  for (pos.y = 0; pos.y + MIN_PU_SIZE <= pic.Y().height; pos.y++)
+  const int yEnd = pic.Y().height - MIN_PU_SIZE + 1;
+  const int xEnd = pic.Y().width - MIN_PU_SIZE + 1;
+
+  // the block hashes of all rows are independent
+#ifdef _OPENMP
+  const int numThreads = std::max(1, std::min(yEnd, omp_get_max_threads()));
+#else
+  const int numThreads = 1;
+#endif
+#pragma omp parallel for num_threads(numThreads) if(numThreads > 1)
+  for (int y = 0; y < yEnd; y++)
   {
     // row pointer
-    pelY = pic.Y().bufAt(0, pos.y);
+    const Pel* pelY = pic.Y().bufAt(0, y);
+    const Pel* pelCb = NULL;
+    const Pel* pelCr = NULL;
     if (chromaFormat != CHROMA_400)
     {
-      int chromaY = pos.y >> chromaScalingY;
+      int chromaY = y >> chromaScalingY;
       pelCb = pic.Cb().bufAt(0, chromaY);
       pelCr = pic.Cr().bufAt(0, chromaY);
     }
 
-    for (pos.x = 0; pos.x + MIN_PU_SIZE <= pic.Y().width; pos.x++)
+    for (int x = 0; x < xEnd; x++)
     {
       // 0x1FF is just an initial value
       unsigned int hashValue = 0x1FF;
 
       // luma part
-      hashValue = xxCalcBlockHash(&pelY[pos.x], pic.Y().stride, MIN_PU_SIZE, MIN_PU_SIZE, hashValue);
+      hashValue = m_calcBlockHash(&pelY[x], pic.Y().stride, MIN_PU_SIZE, MIN_PU_SIZE, hashValue);
 
       // chroma part
       if (chromaFormat != CHROMA_400)
       {
-        int chromaX = pos.x >> chromaScalingX;
-        hashValue = xxCalcBlockHash(&pelCb[chromaX], pic.Cb().stride, chromaMinBlkWidth, chromaMinBlkHeight, hashValue);
-        hashValue = xxCalcBlockHash(&pelCr[chromaX], pic.Cr().stride, chromaMinBlkWidth, chromaMinBlkHeight, hashValue);
+        int chromaX = x >> chromaScalingX;
+        hashValue = m_calcBlockHash(&pelCb[chromaX], pic.Cb().stride, chromaMinBlkWidth, chromaMinBlkHeight, hashValue);
+        hashValue = m_calcBlockHash(&pelCr[chromaX], pic.Cr().stride, chromaMinBlkWidth, chromaMinBlkHeight, hashValue);
       }
 
-      // hash table
-      m_hash2Pos[hashValue].push_back(pos);
-      m_pos2Hash[pos.y][pos.x] = hashValue;
+      m_pos2Hash[y][x] = hashValue;
     }
   }
+
+  // hash table, the positions of each hash value are stored contiguously in raster order
+  std::fill(m_hashTable.begin(), m_hashTable.end(), 0);
+  m_entryHash.clear();
+  m_posStart.clear();
+
+  unsigned int prevHash = 0;
+  unsigned int prevEntry = MAX_UINT;
+  for (int y = 0; y < yEnd; y++)
+  {
+    for (int x = 0; x < xEnd; x++)
+    {
+      const unsigned int hashValue = m_pos2Hash[y][x];
+      // runs of equal blocks are common in screen content
+      if (prevEntry == MAX_UINT || hashValue != prevHash)
+      {
+        prevEntry = xxGetEntry(hashValue);
+        prevHash = hashValue;
+        if (prevEntry == m_posStart.size())
+        {
+          m_posStart.push_back(0);
+        }
+      }
+      m_pos2Entry[y][x] = prevEntry;
+      m_posStart[prevEntry]++;
+    }
+  }
+
+  unsigned int numPos = 0;
+  for (size_t e = 0; e < m_posStart.size(); e++)
+  {
+    const unsigned int count = m_posStart[e];
+    m_posStart[e] = numPos;
+    numPos += count;
+  }
+  m_posStart.push_back(numPos);
+  m_posPool.resize(numPos);
+
+  for (int y = 0; y < yEnd; y++)
+  {
+    for (int x = 0; x < xEnd; x++)
+    {
+      // m_posStart[e] is advanced while filling and restored below
+      m_posPool[m_posStart[m_pos2Entry[y][x]]++] = Position(x, y);
+    }
+  }
+  for (size_t e = m_posStart.size() - 1; e > 0; e--)
+  {
+    m_posStart[e] = m_posStart[e - 1];
+  }
+  m_posStart[0] = 0;
 }
 
 void IbcHashMap::rebuildPicHashMap(const PelUnitBuf& pic)
 {
-  m_hash2Pos.clear();
-
   switch (pic.chromaFormat)
   {
   case CHROMA_400:
@@ -265,6 +374,7 @@ void IbcHashMap::rebuildPicHashMap(const PelUnitBuf& pic)
     THROW("invalid chroma fomat");
     break;
   }
+  m_picHashMapValid = true;
 }
 
 bool IbcHashMap::ibcHashMatch(const Area& lumaArea, std::vector<Position>& cand, const CodingStructure& cs, const int maxCand, const int searchRange4SmallBlk)
@@ -273,28 +383,29 @@ bool IbcHashMap::ibcHashMatch(const Area& lumaArea, std::vector<Position>& cand,
 
   // find the block with least candidates
   size_t minSize = MAX_UINT;
-  unsigned int targetHashOneBlock = 0;
+  unsigned int targetEntryOneBlock = 0;
   Position targetBlockOffsetInCu(0, 0);
   for (SizeType y = 0; y < lumaArea.height && minSize > 1; y += MIN_PU_SIZE)
   {
     for (SizeType x = 0; x < lumaArea.width && minSize > 1; x += MIN_PU_SIZE)
     {
-      unsigned int hash = m_pos2Hash[lumaArea.pos().y + y][lumaArea.pos().x + x];
-      if (m_hash2Pos[hash].size() < minSize)
+      const unsigned int entry = m_pos2Entry[lumaArea.pos().y + y][lumaArea.pos().x + x];
+      if (xxGetNumPos(entry) < minSize)
       {
-        minSize = m_hash2Pos[hash].size();
-        targetHashOneBlock = hash;
+        minSize = xxGetNumPos(entry);
+        targetEntryOneBlock = entry;
         targetBlockOffsetInCu.repositionTo(Position(x, y));
       }
     }
   }
 
-  if (m_hash2Pos[targetHashOneBlock].size() > 1)
+  if (minSize > 1)
   {
-    std::vector<Position>& candOneBlock = m_hash2Pos[targetHashOneBlock];
+    const Position* candBegin = &m_posPool[m_posStart[targetEntryOneBlock]];
+    const Position* candEnd = candBegin + minSize;
 
     // check whether whole block match
-    for (std::vector<Position>::iterator refBlockPos = candOneBlock.begin(); refBlockPos != candOneBlock.end(); refBlockPos++)
+    for (const Position* refBlockPos = candBegin; refBlockPos != candEnd; refBlockPos++)
     {
       Position topLeft = refBlockPos->offset(-targetBlockOffsetInCu.x, -targetBlockOffsetInCu.y);
       Position bottomRight = topLeft.offset(lumaArea.width - 1, lumaArea.height - 1);
@@ -345,8 +456,7 @@ int IbcHashMap::getHashHitRatio(const Area& lumaArea)
   {
     for (int x = lumaArea.x; x < maxX; x += MIN_PU_SIZE)
     {
-      const unsigned int hash = m_pos2Hash[y][x];
-      hit += (m_hash2Pos[hash].size() > 1);
+      hit += (xxGetNumPos(m_pos2Entry[y][x]) > 1);
       total++;
     }
   }
@@ -368,11 +478,10 @@ int IbcHashMap::calHashBlkMatchPerc(const Area& lumaArea)
     mostSelHash[i] = 0;
   }
 
-  for (std::unordered_map<unsigned int, std::vector<Position>>::iterator it = m_hash2Pos.begin(); it != m_hash2Pos.end(); ++it)
+  for (unsigned int entry = 0; entry < m_entryHash.size(); entry++)
   {
-    unsigned int hash = it->first;
-    int usage = (int)it->second.size();
-    assert(usage == m_hash2Pos[hash].size());
+    unsigned int hash = m_entryHash[entry];
+    int usage = (int)xxGetNumPos(entry);
 
     int insertPos = -1;
     for (insertPos = 0; insertPos < numExcludedHashValue; insertPos++)
@@ -417,7 +526,7 @@ int IbcHashMap::calHashBlkMatchPerc(const Area& lumaArea)
         continue;
       }
 
-      hit += (m_hash2Pos[hash].size() > 1);
+      hit += (xxGetNumPos(m_pos2Entry[y][x]) > 1);
       total++;
     }
   }
@@ -46,7 +46,6 @@
 #include "CommonLib/Unit.h"
 #include "CommonLib/UnitPartitioner.h"
 
-#include <unordered_map>
 #include <vector>
 //! \ingroup EncoderLib
 //! \{
@@ -61,17 +60,28 @@ private:
   int     m_picWidth;
   int     m_picHeight;
   unsigned int**  m_pos2Hash;
-  std::unordered_map<unsigned int, std::vector<Position>> m_hash2Pos;
+  unsigned int**  m_pos2Entry;
+  bool    m_picHashMapValid;
 
-  unsigned int xxCalcBlockHash(const Pel* pel, const int stride, const int width, const int height, unsigned int crc);
+  // distinct hash values in order of first occurrence, the positions of entry e are m_posPool[m_posStart[e] .. m_posStart[e+1])
+  std::vector<unsigned int> m_entryHash;
+  std::vector<unsigned int> m_posStart;
+  std::vector<Position>     m_posPool;
+  // open-addressing table from hash value to entry + 1 (0: empty slot), only used while building
+  std::vector<unsigned int> m_hashTable;
+
+  unsigned int xxGetNumPos(const unsigned int entry) const { return m_posStart[entry + 1] - m_posStart[entry]; }
+  unsigned int xxGetEntry(const unsigned int hashValue);
 
   template<ChromaFormat chromaFormat>
   void    xxBuildPicHashMap(const PelUnitBuf& pic);
 
   static  uint32_t xxComputeCrc32c16bit(uint32_t crc, const Pel pel);
+  static  uint32_t xxCalcBlockHash(const Pel* pel, const int stride, const int width, const int height, uint32_t crc);
 
 public:
   uint32_t (*m_computeCrc32c) (uint32_t crc, const Pel pel);
+  uint32_t (*m_calcBlockHash) (const Pel* pel, const int stride, const int width, const int height, uint32_t crc);
 
   IbcHashMap();
   virtual ~IbcHashMap();
@@ -79,12 +89,13 @@ public:
   void    init(const int picWidth, const int picHeight);
   void    destroy();
   void    rebuildPicHashMap(const PelUnitBuf& pic);
+  bool    isPicHashMapValid() const { return m_picHashMapValid; }
   bool    ibcHashMatch(const Area& lumaArea, std::vector<Position>& cand, const CodingStructure& cs, const int maxCand, const int searchRange4SmallBlk);
   int     getHashHitRatio(const Area& lumaArea);
 
   int     calHashBlkMatchPerc(const Area& lumaArea);
 
-#ifdef TARGET_SIMD_X86
+#if ENABLE_SIMD_OPT_IBC && defined( TARGET_SIMD_X86 )
   void    initIbcHashMapX86();
   template <X86_VEXT vext>
   void    _initIbcHashMapX86();
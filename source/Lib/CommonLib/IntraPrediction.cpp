@@ -86,6 +86,16 @@ IntraPrediction::IntraPrediction()
 
   m_piTemp = nullptr;
   m_pMdlmTemp = nullptr;
+
+  m_intraPredAngLuma      = xPredIntraAngLumaCore;
+  m_intraPredAngChroma    = xPredIntraAngChromaCore;
+  m_intraPredPlanar       = xPredIntraPlanarCore;
+  m_intraPredSampleFilter = xPredIntraSampleFilterCore;
+#if ENABLE_SIMD_OPT_INTRAPRED
+#ifdef TARGET_SIMD_X86
+  initIntraPredictionX86();
+#endif
+#endif
 }
 
 IntraPrediction::~IntraPrediction()
@@ -238,24 +248,30 @@ void IntraPrediction::predIntraAng( const ComponentID compId, PelBuf &piPred, co
 
   if (m_ipaParam.applyPDPC)
   {
-    PelBuf dstBuf = piPred;
-    const int scale = ((floorLog2(iWidth) - 2 + floorLog2(iHeight) - 2 + 2) >> 2);
-    CHECK(scale < 0 || scale > 31, "PDPC: scale < 0 || scale > 31");
-
     if (uiDirMode == PLANAR_IDX || uiDirMode == DC_IDX)
     {
-      for (int y = 0; y < iHeight; y++)
-      {
-        const int wT   = 32 >> std::min(31, ((y << 1) >> scale));
-        const Pel left = srcBuf.at(y + 1, 1);
-        for (int x = 0; x < iWidth; x++)
-        {
-          const int wL    = 32 >> std::min(31, ((x << 1) >> scale));
-          const Pel top   = srcBuf.at(x + 1, 0);
-          const Pel val   = dstBuf.at(x, y);
-          dstBuf.at(x, y) = val + ((wL * (left - val) + wT * (top - val) + 32) >> 6);
-        }
-      }
+      m_intraPredSampleFilter(srcBuf, piPred);
+    }
+  }
+}
+
+void IntraPrediction::xPredIntraSampleFilterCore( const CPelBuf &pSrc, PelBuf &pDst )
+{
+  const int iWidth  = pDst.width;
+  const int iHeight = pDst.height;
+  const int scale   = ((floorLog2(iWidth) - 2 + floorLog2(iHeight) - 2 + 2) >> 2);
+  CHECK(scale < 0 || scale > 31, "PDPC: scale < 0 || scale > 31");
+
+  for (int y = 0; y < iHeight; y++)
+  {
+    const int wT   = 32 >> std::min(31, ((y << 1) >> scale));
+    const Pel left = pSrc.at(y + 1, 1);
+    for (int x = 0; x < iWidth; x++)
+    {
+      const int wL  = 32 >> std::min(31, ((x << 1) >> scale));
+      const Pel top = pSrc.at(x + 1, 0);
+      const Pel val = pDst.at(x, y);
+      pDst.at(x, y) = val + ((wL * (left - val) + wT * (top - val) + 32) >> 6);
     }
   }
 }
@@ -287,6 +303,11 @@ void IntraPrediction::predIntraChromaLM(const ComponentID compID, PelBuf &piPred
 
 //NOTE: Bit-Limit - 24-bit source
 void IntraPrediction::xPredIntraPlanar( const CPelBuf &pSrc, PelBuf &pDst )
+{
+  m_intraPredPlanar( pSrc, pDst );
+}
+
+void IntraPrediction::xPredIntraPlanarCore( const CPelBuf &pSrc, PelBuf &pDst )
 {
   const uint32_t width  = pDst.width;
   const uint32_t height = pDst.height;
@@ -560,60 +581,40 @@ void IntraPrediction::xPredIntraAng( const CPelBuf &pSrc, PelBuf &pDst, const Ch
   }
   else
   {
-    for (int y = 0, deltaPos = intraPredAngle * (1 + multiRefIdx); y<height; y++, deltaPos += intraPredAngle, pDsty += dstStride)
-    {
-      const int deltaInt   = deltaPos >> 5;
-      const int deltaFract = deltaPos & 31;
+    const int deltaPos0 = intraPredAngle * (1 + multiRefIdx);
 
-      if ( !isIntegerSlope( abs(intraPredAngle) ) )
+    if ( !isIntegerSlope( abs(intraPredAngle) ) )
+    {
+      if( isLuma(channelType) )
       {
-        if( isLuma(channelType) )
-        {
-          const bool useCubicFilter = !m_ipaParam.interpolationFlag;
-
-          const TFilterCoeff        intraSmoothingFilter[4] = {TFilterCoeff(16 - (deltaFract >> 1)), TFilterCoeff(32 - (deltaFract >> 1)), TFilterCoeff(16 + (deltaFract >> 1)), TFilterCoeff(deltaFract >> 1)};
-          const TFilterCoeff* const f                       = (useCubicFilter) ? InterpolationFilter::getChromaFilterTable(deltaFract) : intraSmoothingFilter;
-
-          for (int x = 0; x < width; x++)
-          {
-            Pel p[4];
-
-            p[0] = refMain[deltaInt + x];
-            p[1] = refMain[deltaInt + x + 1];
-            p[2] = refMain[deltaInt + x + 2];
-            p[3] = refMain[deltaInt + x + 3];
-
-            Pel val = (f[0] * p[0] + f[1] * p[1] + f[2] * p[2] + f[3] * p[3] + 32) >> 6;
-
-            pDsty[x] = ClipPel(val, clpRng);   // always clip even though not always needed
-          }
-        }
-        else
-        {
-          // Do linear filtering
-          for (int x = 0; x < width; x++)
-          {
-            Pel p[2];
-
-            p[0] = refMain[deltaInt + x + 1];
-            p[1] = refMain[deltaInt + x + 2];
-
-            pDsty[x] = p[0] + ((deltaFract * (p[1] - p[0]) + 16) >> 5);
-          }
-        }
+        m_intraPredAngLuma( pDstBuf, dstStride, refMain, width, height, deltaPos0, intraPredAngle, !m_ipaParam.interpolationFlag, clpRng );
       }
       else
       {
-        // Just copy the integer samples
+        m_intraPredAngChroma( pDstBuf, dstStride, refMain, width, height, deltaPos0, intraPredAngle );
+      }
+    }
+    else
+    {
+      // Just copy the integer samples
+      for (int y = 0, deltaPos = deltaPos0; y < height; y++, deltaPos += intraPredAngle, pDsty += dstStride)
+      {
+        const int deltaInt = deltaPos >> 5;
         for( int x = 0; x < width; x++ )
         {
           pDsty[x] = refMain[x + deltaInt + 1];
         }
       }
-      if (m_ipaParam.applyPDPC)
+    }
+
+    if (m_ipaParam.applyPDPC)
+    {
+      const int scale = m_ipaParam.angularScale;
+
+      pDsty = pDstBuf;
+      for (int y = 0; y < height; y++, pDsty += dstStride)
       {
-        const int scale       = m_ipaParam.angularScale;
-        int       invAngleSum = 256;
+        int invAngleSum = 256;
 
         for (int x = 0; x < std::min(3 << scale, width); x++)
         {
@@ -641,6 +642,52 @@ void IntraPrediction::xPredIntraAng( const CPelBuf &pSrc, PelBuf &pDst, const Ch
   }
 }
 
+void IntraPrediction::xPredIntraAngLumaCore( Pel* pDst, const ptrdiff_t dstStride, const Pel* refMain, const int width, const int height, int deltaPos, const int intraPredAngle, const bool useCubicFilter, const ClpRng& clpRng )
+{
+  for (int y = 0; y < height; y++, deltaPos += intraPredAngle, pDst += dstStride)
+  {
+    const int deltaInt   = deltaPos >> 5;
+    const int deltaFract = deltaPos & 31;
+
+    const TFilterCoeff        intraSmoothingFilter[4] = {TFilterCoeff(16 - (deltaFract >> 1)), TFilterCoeff(32 - (deltaFract >> 1)), TFilterCoeff(16 + (deltaFract >> 1)), TFilterCoeff(deltaFract >> 1)};
+    const TFilterCoeff* const f                       = (useCubicFilter) ? InterpolationFilter::getChromaFilterTable(deltaFract) : intraSmoothingFilter;
+
+    for (int x = 0; x < width; x++)
+    {
+      Pel p[4];
+
+      p[0] = refMain[deltaInt + x];
+      p[1] = refMain[deltaInt + x + 1];
+      p[2] = refMain[deltaInt + x + 2];
+      p[3] = refMain[deltaInt + x + 3];
+
+      Pel val = (f[0] * p[0] + f[1] * p[1] + f[2] * p[2] + f[3] * p[3] + 32) >> 6;
+
+      pDst[x] = ClipPel(val, clpRng);   // always clip even though not always needed
+    }
+  }
+}
+
+void IntraPrediction::xPredIntraAngChromaCore( Pel* pDst, const ptrdiff_t dstStride, const Pel* refMain, const int width, const int height, int deltaPos, const int intraPredAngle )
+{
+  for (int y = 0; y < height; y++, deltaPos += intraPredAngle, pDst += dstStride)
+  {
+    const int deltaInt   = deltaPos >> 5;
+    const int deltaFract = deltaPos & 31;
+
+    // Do linear filtering
+    for (int x = 0; x < width; x++)
+    {
+      Pel p[2];
+
+      p[0] = refMain[deltaInt + x + 1];
+      p[1] = refMain[deltaInt + x + 2];
+
+      pDst[x] = p[0] + ((deltaFract * (p[1] - p[0]) + 16) >> 5);
+    }
+  }
+}
+
 void IntraPrediction::xPredIntraBDPCM(const CPelBuf &pSrc, PelBuf &pDst, const uint32_t dirMode, const ClpRng& clpRng )
 {
   const int wdt = pDst.width;
@@ -117,6 +117,32 @@ protected:
   int m_leftRefLength;
   ScanElement* m_scanOrder;
   bool         m_bestScanRotationMode;
+  // prediction kernels, replaced by SIMD versions where available
+  void (*m_intraPredAngLuma)      ( Pel* pDst, const ptrdiff_t dstStride, const Pel* refMain, const int width, const int height, int deltaPos, const int intraPredAngle, const bool useCubicFilter, const ClpRng& clpRng );
+  void (*m_intraPredAngChroma)    ( Pel* pDst, const ptrdiff_t dstStride, const Pel* refMain, const int width, const int height, int deltaPos, const int intraPredAngle );
+  void (*m_intraPredPlanar)       ( const CPelBuf &pSrc, PelBuf &pDst );
+  void (*m_intraPredSampleFilter) ( const CPelBuf &pSrc, PelBuf &pDst );
+
+  static void xPredIntraAngLumaCore     ( Pel* pDst, const ptrdiff_t dstStride, const Pel* refMain, const int width, const int height, int deltaPos, const int intraPredAngle, const bool useCubicFilter, const ClpRng& clpRng );
+  static void xPredIntraAngChromaCore   ( Pel* pDst, const ptrdiff_t dstStride, const Pel* refMain, const int width, const int height, int deltaPos, const int intraPredAngle );
+  static void xPredIntraPlanarCore      ( const CPelBuf &pSrc, PelBuf &pDst );
+  static void xPredIntraSampleFilterCore( const CPelBuf &pSrc, PelBuf &pDst );
+
+#if ENABLE_SIMD_OPT_INTRAPRED && defined( TARGET_SIMD_X86 )
+  template<X86_VEXT vext>
+  static void xPredIntraAngLuma_SIMD     ( Pel* pDst, const ptrdiff_t dstStride, const Pel* refMain, const int width, const int height, int deltaPos, const int intraPredAngle, const bool useCubicFilter, const ClpRng& clpRng );
+  template<X86_VEXT vext>
+  static void xPredIntraAngChroma_SIMD   ( Pel* pDst, const ptrdiff_t dstStride, const Pel* refMain, const int width, const int height, int deltaPos, const int intraPredAngle );
+  template<X86_VEXT vext>
+  static void xPredIntraPlanar_SIMD      ( const CPelBuf &pSrc, PelBuf &pDst );
+  template<X86_VEXT vext>
+  static void xPredIntraSampleFilter_SIMD( const CPelBuf &pSrc, PelBuf &pDst );
+
+  void initIntraPredictionX86();
+  template<X86_VEXT vext>
+  void _initIntraPredictionX86();
+#endif
+
   // prediction
   void xPredIntraPlanar           ( const CPelBuf &pSrc, PelBuf &pDst );
   void xPredIntraDc               ( const CPelBuf &pSrc, PelBuf &pDst, const ChannelType channelType, const bool enableBoundaryFilter = true );
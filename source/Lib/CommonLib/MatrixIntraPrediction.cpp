@@ -56,6 +56,13 @@ MatrixIntraPrediction::MatrixIntraPrediction():
   m_upsmpFactorHor( 0 ),
   m_upsmpFactorVer( 0 )
 {
+  m_computeReducedPred     = computeReducedPredCore;
+  m_predictionUpsampling1D = predictionUpsampling1DCore;
+#if ENABLE_SIMD_OPT_MIP
+#ifdef TARGET_SIMD_X86
+  initMatrixIntraPredictionX86();
+#endif
+#endif
 }
 
 
@@ -200,7 +207,7 @@ void MatrixIntraPrediction::boundaryDownsampling1D(int* reducedDst, const int* c
 }
 
 
-void MatrixIntraPrediction::predictionUpsampling1D(int* const dst, const int* const src, const int* const bndry,
+void MatrixIntraPrediction::predictionUpsampling1DCore(int* const dst, const int* const src, const int* const bndry,
                                                    const SizeType srcSizeUpsmpDim, const SizeType srcSizeOrthDim,
                                                    const SizeType srcStep, const SizeType srcStride,
                                                    const SizeType dstStep, const SizeType dstStride,
@@ -260,7 +267,7 @@ void MatrixIntraPrediction::predictionUpsampling( int* const dst, const int* con
     verSrc = horDst;
     verSrcStep *= m_upsmpFactorVer;
 
-    predictionUpsampling1D( horDst, src, m_refSamplesLeft.data(),
+    m_predictionUpsampling1D( horDst, src, m_refSamplesLeft.data(),
                             m_reducedPredSize, m_reducedPredSize,
                             1, m_reducedPredSize, 1, verSrcStep,
                             m_upsmpFactorVer, m_upsmpFactorHor );
@@ -268,7 +275,7 @@ void MatrixIntraPrediction::predictionUpsampling( int* const dst, const int* con
 
   if( m_upsmpFactorVer > 1 )
   {
-    predictionUpsampling1D( dst, verSrc, m_refSamplesTop.data(),
+    m_predictionUpsampling1D( dst, verSrc, m_refSamplesTop.data(),
                             m_reducedPredSize, m_blockSize.width,
                             verSrcStep, 1, m_blockSize.width, 1,
                             1, m_upsmpFactorVer );
@@ -333,37 +340,15 @@ void MatrixIntraPrediction::computeReducedPred( int*const result, const int* con
 #endif
   CHECK( inputSize != 4 * (inputSize >> 2), "Error, input size not divisible by four" );
 
-  const uint8_t *weight = matrix;
   const int   inputOffset = transpose ? m_inputOffsetTransp : m_inputOffset;
 
   const bool redSize = (m_sizeId == 2);
-  int posRes = 0;
-  for( int y = 0; y < m_reducedPredSize; y++ )
-  {
-    for( int x = 0; x < m_reducedPredSize; x++ )
-    {
-      if( redSize ) weight -= 1;
-      int tmp0 = redSize ? 0 : (input[0] * weight[0]);
-      int tmp1 = input[1] * weight[1];
-      int tmp2 = input[2] * weight[2];
-      int tmp3 = input[3] * weight[3];
-      for (int i = 4; i < inputSize; i += 4)
-      {
-        tmp0 += input[i]     * weight[i];
-        tmp1 += input[i + 1] * weight[i + 1];
-        tmp2 += input[i + 2] * weight[i + 2];
-        tmp3 += input[i + 3] * weight[i + 3];
-      }
 #if JVET_Q0446_MIP_CONST_SHIFT_OFFSET
-      resPtr[posRes++] = ClipBD<int>(((tmp0 + tmp1 + tmp2 + tmp3 + offset) >> MIP_SHIFT_MATRIX) + inputOffset, bitDepth);
+  m_computeReducedPred( resPtr, input, matrix, inputSize, m_reducedPredSize * m_reducedPredSize, redSize, offset, MIP_SHIFT_MATRIX, inputOffset, bitDepth );
 #else
-      resPtr[posRes++] = ClipBD<int>( ((tmp0 + tmp1 + tmp2 + tmp3 + offset) >> shiftMatrix) + inputOffset, bitDepth );
+  m_computeReducedPred( resPtr, input, matrix, inputSize, m_reducedPredSize * m_reducedPredSize, redSize, offset, shiftMatrix, inputOffset, bitDepth );
 #endif
 
-      weight += inputSize;
-    }
-  }
-
   if( transpose )
   {
     for( int y = 0; y < m_reducedPredSize; y++ )
@@ -375,3 +360,28 @@ void MatrixIntraPrediction::computeReducedPred( int*const result, const int* con
     }
   }
 }
+
+void MatrixIntraPrediction::computeReducedPredCore( int* const result, const int* const input, const uint8_t* matrix, const int inputSize, const int outputSize,
+                                                    const bool redSize, const int offset, const int shift, const int inputOffset, const int bitDepth )
+{
+  const uint8_t *weight = matrix;
+
+  for( int posRes = 0; posRes < outputSize; posRes++ )
+  {
+    if( redSize ) weight -= 1;
+    int tmp0 = redSize ? 0 : (input[0] * weight[0]);
+    int tmp1 = input[1] * weight[1];
+    int tmp2 = input[2] * weight[2];
+    int tmp3 = input[3] * weight[3];
+    for (int i = 4; i < inputSize; i += 4)
+    {
+      tmp0 += input[i]     * weight[i];
+      tmp1 += input[i + 1] * weight[i + 1];
+      tmp2 += input[i + 2] * weight[i + 2];
+      tmp3 += input[i + 3] * weight[i + 3];
+    }
+    result[posRes] = ClipBD<int>( ((tmp0 + tmp1 + tmp2 + tmp3 + offset) >> shift) + inputOffset, bitDepth );
+
+    weight += inputSize;
+  }
+}
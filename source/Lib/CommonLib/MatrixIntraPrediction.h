@@ -73,12 +73,42 @@ public:
     static void boundaryDownsampling1D(int* reducedDst, const int* const fullSrc, const SizeType srcLen, const SizeType dstLen);
 
     void predictionUpsampling( int* const dst, const int* const src ) const;
-    static void predictionUpsampling1D( int* const dst, const int* const src, const int* const bndry,
-                                        const SizeType srcSizeUpsmpDim, const SizeType srcSizeOrthDim,
-                                        const SizeType srcStep, const SizeType srcStride,
-                                        const SizeType dstStep, const SizeType dstStride,
-                                        const SizeType bndryStep,
-                                        const unsigned int upsmpFactor );
+    static void predictionUpsampling1DCore( int* const dst, const int* const src, const int* const bndry,
+                                            const SizeType srcSizeUpsmpDim, const SizeType srcSizeOrthDim,
+                                            const SizeType srcStep, const SizeType srcStride,
+                                            const SizeType dstStep, const SizeType dstStride,
+                                            const SizeType bndryStep,
+                                            const unsigned int upsmpFactor );
+
+    // matrix-vector product of the reduced prediction, clipped to the bit depth
+    static void computeReducedPredCore( int* const result, const int* const input, const uint8_t* matrix, const int inputSize, const int outputSize,
+                                        const bool redSize, const int offset, const int shift, const int inputOffset, const int bitDepth );
+
+    void (*m_computeReducedPred)    ( int* const result, const int* const input, const uint8_t* matrix, const int inputSize, const int outputSize,
+                                      const bool redSize, const int offset, const int shift, const int inputOffset, const int bitDepth );
+    void (*m_predictionUpsampling1D)( int* const dst, const int* const src, const int* const bndry,
+                                      const SizeType srcSizeUpsmpDim, const SizeType srcSizeOrthDim,
+                                      const SizeType srcStep, const SizeType srcStride,
+                                      const SizeType dstStep, const SizeType dstStride,
+                                      const SizeType bndryStep,
+                                      const unsigned int upsmpFactor );
+
+#if ENABLE_SIMD_OPT_MIP && defined( TARGET_SIMD_X86 )
+    template<X86_VEXT vext>
+    static void computeReducedPred_SIMD    ( int* const result, const int* const input, const uint8_t* matrix, const int inputSize, const int outputSize,
+                                             const bool redSize, const int offset, const int shift, const int inputOffset, const int bitDepth );
+    template<X86_VEXT vext>
+    static void predictionUpsampling1D_SIMD( int* const dst, const int* const src, const int* const bndry,
+                                             const SizeType srcSizeUpsmpDim, const SizeType srcSizeOrthDim,
+                                             const SizeType srcStep, const SizeType srcStride,
+                                             const SizeType dstStep, const SizeType dstStride,
+                                             const SizeType bndryStep,
+                                             const unsigned int upsmpFactor );
+
+    void initMatrixIntraPredictionX86();
+    template<X86_VEXT vext>
+    void _initMatrixIntraPredictionX86();
+#endif
 
 #if JVET_Q0446_MIP_CONST_SHIFT_OFFSET
     const uint8_t* getMatrixData(const int modeIdx) const;
@@ -129,6 +129,9 @@ struct NALUnitEBSP : public NALUnit
    * emulation_prevention_three_byte symbols.
    */
   NALUnitEBSP(OutputNALUnit& nalu);
+
+  /// size of the EBSP data in bytes, without copying the stream buffer
+  uint32_t getSize() { return uint32_t( m_nalUnitData.tellp() ); }
 };
 //! \}
 //! \}
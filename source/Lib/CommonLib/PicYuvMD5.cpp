@@ -35,28 +35,28 @@
 #include "SEI.h"
 #include "libmd5/MD5.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 //! \ingroup CommonLib
 //! \{
 
 /**
- * Update md5 using n samples from plane, each sample is adjusted to
- * OUTBIT_BITDEPTH_DIV8.
+ * Pack n samples into buf, each sample is adjusted to OUTBIT_BITDEPTH_DIV8
+ * bytes in little endian byte order.
  */
 template<uint32_t OUTPUT_BITDEPTH_DIV8>
-static void md5_block(MD5& md5, const Pel* plane, uint32_t n)
+static inline void md5_pack(uint8_t* buf, const Pel* plane, uint32_t n)
 {
-  /* create a 64 byte buffer for packing Pel's into */
-  uint8_t buf[64/OUTPUT_BITDEPTH_DIV8][OUTPUT_BITDEPTH_DIV8];
   for (uint32_t i = 0; i < n; i++)
   {
-    Pel pel = plane[i];
-    /* perform bitdepth and endian conversion */
+    const Pel pel = plane[i];
     for (uint32_t d = 0; d < OUTPUT_BITDEPTH_DIV8; d++)
     {
-      buf[i][d] = pel >> (d*8);
+      buf[i*OUTPUT_BITDEPTH_DIV8 + d] = uint8_t(pel >> (d*8));
     }
   }
-  md5.update((uint8_t*)buf, n * OUTPUT_BITDEPTH_DIV8);
 }
 
 /**
@@ -68,7 +68,8 @@ static void md5_plane(MD5& md5, const Pel* plane, uint32_t width, uint32_t heigh
 {
   /* N is the number of samples to process per md5 update.
    * All N samples must fit in buf */
-  uint32_t N = 32;
+  static const uint32_t N = 64;
+  uint8_t buf[N * OUTPUT_BITDEPTH_DIV8];
   uint32_t width_modN = width % N;
   uint32_t width_less_modN = width - width_modN;
 
@@ -78,49 +79,84 @@ static void md5_plane(MD5& md5, const Pel* plane, uint32_t width, uint32_t heigh
      * NB, for 8bit data, data is truncated to 8bits. */
     for (uint32_t x = 0; x < width_less_modN; x += N)
     {
-      md5_block<OUTPUT_BITDEPTH_DIV8>(md5, &plane[y*stride + x], N);
+      md5_pack<OUTPUT_BITDEPTH_DIV8>(buf, &plane[y*stride + x], N);
+      md5.update(buf, N * OUTPUT_BITDEPTH_DIV8);
     }
 
     /* mop up any of the remaining line */
-    md5_block<OUTPUT_BITDEPTH_DIV8>(md5, &plane[y*stride + width_less_modN], width_modN);
+    md5_pack<OUTPUT_BITDEPTH_DIV8>(buf, &plane[y*stride + width_less_modN], width_modN);
+    md5.update(buf, width_modN * OUTPUT_BITDEPTH_DIV8);
   }
 }
 
+/**
+ * Lookup tables for the CRC of compCRC. The data bits are shifted into the low end of the
+ * register, so they only reach the feedback after 16 steps. After 8 (16) steps the register is
+ * the shifted register and data, xored with the feedback of the upper (both) register byte(s).
+ */
+struct CRCTables
+{
+  uint16_t feedback8  [256];  ///< feedback of the upper byte after 8 steps
+  uint16_t feedback16H[256];  ///< feedback of the upper byte after 16 steps
+  uint16_t feedback16L[256];  ///< feedback of the lower byte after 16 steps
+
+  static uint32_t steps( uint32_t crcVal, int numSteps )
+  {
+    for( int i = 0; i < numSteps; i++ )
+    {
+      const uint32_t crcMsb = (crcVal >> 15) & 1;
+      crcVal = ((crcVal << 1) & 0xffff) ^ (crcMsb * 0x1021);
+    }
+    return crcVal;
+  }
+
+  CRCTables()
+  {
+    for( uint32_t i = 0; i < 256; i++ )
+    {
+      feedback8  [i] = uint16_t( steps( i << 8,  8 ) );
+      feedback16H[i] = uint16_t( steps( i << 8, 16 ) );
+      feedback16L[i] = uint16_t( steps( i,      16 ) );
+    }
+  }
+};
+
+static const CRCTables g_crcTables;
+
+/** number of threads for hashing the planes concurrently, limited by the available OpenMP threads */
+static int getNumHashThreads(const int numComp)
+{
+#ifdef _OPENMP
+  return std::min(numComp, omp_get_max_threads());
+#else
+  return 1;
+#endif
+}
 
 uint32_t compCRC(int bitdepth, const Pel* plane, uint32_t width, uint32_t height, uint32_t stride, PictureHash &digest)
 {
-  uint32_t crcMsb;
-  uint32_t bitVal;
   uint32_t crcVal = 0xffff;
-  uint32_t bitIdx;
   for (uint32_t y = 0; y < height; y++)
   {
-    for (uint32_t x = 0; x < width; x++)
+    const Pel* line = &plane[y*stride];
+    if (bitdepth > 8)
     {
-      // take CRC of first pictureData byte
-      for(bitIdx=0; bitIdx<8; bitIdx++)
+      // both bytes of a sample in one step, the first pictureData byte is the low byte
+      for (uint32_t x = 0; x < width; x++)
       {
-        crcMsb = (crcVal >> 15) & 1;
-        bitVal = (plane[y*stride+x] >> (7 - bitIdx)) & 1;
-        crcVal = (((crcVal << 1) + bitVal) & 0xffff) ^ (crcMsb * 0x1021);
+        const uint32_t pel = uint16_t(line[x]);
+        crcVal = (((pel & 0xff) << 8) | (pel >> 8)) ^ g_crcTables.feedback16H[crcVal >> 8] ^ g_crcTables.feedback16L[crcVal & 0xff];
       }
-      // take CRC of second pictureData byte if bit depth is greater than 8-bits
-      if(bitdepth > 8)
+    }
+    else
+    {
+      for (uint32_t x = 0; x < width; x++)
       {
-        for(bitIdx=0; bitIdx<8; bitIdx++)
-        {
-          crcMsb = (crcVal >> 15) & 1;
-          bitVal = (plane[y*stride+x] >> (15 - bitIdx)) & 1;
-          crcVal = (((crcVal << 1) + bitVal) & 0xffff) ^ (crcMsb * 0x1021);
-        }
+        crcVal = (((crcVal << 8) | (line[x] & 0xff)) & 0xffff) ^ g_crcTables.feedback8[crcVal >> 8];
       }
     }
   }
-  for(bitIdx=0; bitIdx<16; bitIdx++)
-  {
-    crcMsb = (crcVal >> 15) & 1;
-    crcVal = ((crcVal << 1) & 0xffff) ^ (crcMsb * 0x1021);
-  }
+  crcVal = g_crcTables.feedback16H[crcVal >> 8] ^ g_crcTables.feedback16L[crcVal & 0xff];
 
   digest.hash.push_back((crcVal>>8)  & 0xff);
   digest.hash.push_back( crcVal      & 0xff);
@@ -129,34 +165,56 @@ uint32_t compCRC(int bitdepth, const Pel* plane, uint32_t width, uint32_t height
 
 uint32_t calcCRC(const CPelUnitBuf& pic, PictureHash &digest, const BitDepths &bitDepths)
 {
-  uint32_t digestLen=0;
-  digest.hash.clear();
-  for (uint32_t chan = 0; chan< (uint32_t)pic.bufs.size(); chan++)
+  const int   numComp    = (int)pic.bufs.size();
+  const int   numThreads = getNumHashThreads(numComp);
+  PictureHash compDigest[MAX_NUM_COMPONENT];
+  uint32_t    digestLen[MAX_NUM_COMPONENT] = { 0 };
+
+  // the planes are hashed concurrently, the digests are appended in component order
+#pragma omp parallel for num_threads(numThreads) if(numThreads > 1)
+  for (int chan = 0; chan < numComp; chan++)
   {
     const ComponentID compID = ComponentID(chan);
     const CPelBuf area = pic.get(compID);
-    digestLen = compCRC(bitDepths.recon[toChannelType(compID)], area.bufAt(0, 0), area.width, area.height, area.stride, digest );
+    digestLen[chan] = compCRC(bitDepths.recon[toChannelType(compID)], area.bufAt(0, 0), area.width, area.height, area.stride, compDigest[chan] );
+  }
+
+  digest.hash.clear();
+  for (int chan = 0; chan < numComp; chan++)
+  {
+    digest.hash.insert(digest.hash.end(), compDigest[chan].hash.begin(), compDigest[chan].hash.end());
   }
-  return digestLen;
+  return numComp ? digestLen[numComp - 1] : 0;
 }
 
 uint32_t compChecksum(int bitdepth, const Pel* plane, uint32_t width, uint32_t height, uint32_t stride, PictureHash &digest, const BitDepths &/*bitDepths*/)
 {
   uint32_t checksum = 0;
-  uint8_t xor_mask;
 
+  // the sums wrap around modulo 2^32, so the lines can be summed up independently and without branches
   for (uint32_t y = 0; y < height; y++)
   {
-    for (uint32_t x = 0; x < width; x++)
-    {
-      xor_mask = (x & 0xff) ^ (y & 0xff) ^ (x >> 8) ^ (y >> 8);
-      checksum = (checksum + ((plane[y*stride+x] & 0xff) ^ xor_mask)) & 0xffffffff;
+    const uint32_t yMask = ((y & 0xff) ^ (y >> 8)) & 0xff;
+    const Pel*     line  = &plane[y*stride];
+    uint32_t       sum   = 0;
 
-      if(bitdepth > 8)
+    if(bitdepth > 8)
+    {
+      for (uint32_t x = 0; x < width; x++)
+      {
+        const uint32_t xor_mask = ((x & 0xff) ^ (x >> 8) ^ yMask) & 0xff;
+        sum += ((line[x] & 0xff) ^ xor_mask) + ((line[x] >> 8) ^ xor_mask);
+      }
+    }
+    else
+    {
+      for (uint32_t x = 0; x < width; x++)
       {
-        checksum = (checksum + ((plane[y*stride+x]>>8) ^ xor_mask)) & 0xffffffff;
+        const uint32_t xor_mask = ((x & 0xff) ^ (x >> 8) ^ yMask) & 0xff;
+        sum += (line[x] & 0xff) ^ xor_mask;
       }
     }
+    checksum += sum;
   }
 
   digest.hash.push_back((checksum>>24) & 0xff);
@@ -168,15 +226,26 @@ uint32_t compChecksum(int bitdepth, const Pel* plane, uint32_t width, uint32_t h
 
 uint32_t calcChecksum(const CPelUnitBuf& pic, PictureHash &digest, const BitDepths &bitDepths)
 {
-  uint32_t digestLen=0;
-  digest.hash.clear();
-  for(uint32_t chan=0; chan< (uint32_t)pic.bufs.size(); chan++)
+  const int   numComp    = (int)pic.bufs.size();
+  const int   numThreads = getNumHashThreads(numComp);
+  PictureHash compDigest[MAX_NUM_COMPONENT];
+  uint32_t    digestLen[MAX_NUM_COMPONENT] = { 0 };
+
+  // the planes are hashed concurrently, the digests are appended in component order
+#pragma omp parallel for num_threads(numThreads) if(numThreads > 1)
+  for (int chan = 0; chan < numComp; chan++)
   {
     const ComponentID compID=ComponentID(chan);
     const CPelBuf area = pic.get(compID);
-    digestLen=compChecksum(bitDepths.recon[toChannelType(compID)], area.bufAt(0,0), area.width, area.height, area.stride, digest, bitDepths);
+    digestLen[chan]=compChecksum(bitDepths.recon[toChannelType(compID)], area.bufAt(0,0), area.width, area.height, area.stride, compDigest[chan], bitDepths);
+  }
+
+  digest.hash.clear();
+  for (int chan = 0; chan < numComp; chan++)
+  {
+    digest.hash.insert(digest.hash.end(), compDigest[chan].hash.begin(), compDigest[chan].hash.end());
   }
-  return digestLen;
+  return numComp ? digestLen[numComp - 1] : 0;
 }
 /**
  * Calculate the MD5sum of pic, storing the result in digest.
@@ -189,23 +258,29 @@ uint32_t calcMD5(const CPelUnitBuf& pic, PictureHash &digest, const BitDepths &b
 {
   /* choose an md5_plane packing function based on the system bitdepth */
   typedef void (*MD5PlaneFunc)(MD5&, const Pel*, uint32_t, uint32_t, uint32_t);
-  MD5PlaneFunc md5_plane_func;
 
-  MD5 md5[MAX_NUM_COMPONENT];
+  const int numComp    = (int)pic.bufs.size();
+  const int numThreads = getNumHashThreads(numComp);
+  MD5       md5[MAX_NUM_COMPONENT];
+  uint8_t   tmp_digest[MAX_NUM_COMPONENT][MD5_DIGEST_STRING_LENGTH];
 
-  digest.hash.clear();
-
-  for (uint32_t chan = 0; chan< (uint32_t)pic.bufs.size(); chan++)
+  /* the planes are hashed concurrently, the digests are appended in component order */
+#pragma omp parallel for num_threads(numThreads) if(numThreads > 1)
+  for (int chan = 0; chan < numComp; chan++)
   {
     const ComponentID compID=ComponentID(chan);
     const CPelBuf area = pic.get(compID);
-    md5_plane_func = bitDepths.recon[toChannelType(compID)] <= 8 ? (MD5PlaneFunc)md5_plane<1> : (MD5PlaneFunc)md5_plane<2>;
-    uint8_t tmp_digest[MD5_DIGEST_STRING_LENGTH];
+    MD5PlaneFunc md5_plane_func = bitDepths.recon[toChannelType(compID)] <= 8 ? (MD5PlaneFunc)md5_plane<1> : (MD5PlaneFunc)md5_plane<2>;
     md5_plane_func(md5[compID], area.bufAt(0, 0), area.width, area.height, area.stride );
-    md5[compID].finalize(tmp_digest);
+    md5[compID].finalize(tmp_digest[compID]);
+  }
+
+  digest.hash.clear();
+  for (int chan = 0; chan < numComp; chan++)
+  {
     for(uint32_t i=0; i<MD5_DIGEST_STRING_LENGTH; i++)
     {
-      digest.hash.push_back(tmp_digest[i]);
+      digest.hash.push_back(tmp_digest[chan][i]);
     }
   }
   return 16;
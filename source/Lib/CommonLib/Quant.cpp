@@ -142,9 +142,69 @@ QpParam::QpParam(const TransformUnit& tu, const ComponentID &compIDX, const int
 // Quant class member functions
 // ====================================================================================================================
 
+#if ENABLE_QUANT_ZERO_TU_STATS
+std::atomic<uint64_t> QuantZeroTUStats::m_numChecked[MAX_CU_DEPTH + 1][MAX_CU_DEPTH + 1][QuantZeroTUStats::NUM_QP];
+std::atomic<uint64_t> QuantZeroTUStats::m_numAllZero[MAX_CU_DEPTH + 1][MAX_CU_DEPTH + 1][QuantZeroTUStats::NUM_QP];
+
+void QuantZeroTUStats::count( const CompArea& area, const int qp, const bool allZero )
+{
+  const int log2Width  = floorLog2( area.width  );
+  const int log2Height = floorLog2( area.height );
+  const int qpIdx      = Clip3( 0, NUM_QP - 1, qp );
+
+  m_numChecked[log2Width][log2Height][qpIdx].fetch_add( 1, std::memory_order_relaxed );
+  if( allZero )
+  {
+    m_numAllZero[log2Width][log2Height][qpIdx].fetch_add( 1, std::memory_order_relaxed );
+  }
+}
+
+void QuantZeroTUStats::report()
+{
+  uint64_t totalChecked = 0, totalAllZero = 0;
+
+  msg( INFO, "\nAll-zero TU detection in the quantizers (TU size, QP: checked, all-zero)\n" );
+  for( int log2Width = 0; log2Width <= MAX_CU_DEPTH; log2Width++ )
+  {
+    for( int log2Height = 0; log2Height <= MAX_CU_DEPTH; log2Height++ )
+    {
+      for( int qp = 0; qp < NUM_QP; qp++ )
+      {
+        const uint64_t numChecked = m_numChecked[log2Width][log2Height][qp];
+        const uint64_t numAllZero = m_numAllZero[log2Width][log2Height][qp];
+        if( numChecked )
+        {
+          msg( INFO, "  %3dx%-3d QP %3d: %10llu %10llu (%5.1f%%)\n", 1 << log2Width, 1 << log2Height, qp, ( unsigned long long ) numChecked, ( unsigned long long ) numAllZero, 100.0 * numAllZero / numChecked );
+          totalChecked += numChecked;
+          totalAllZero += numAllZero;
+        }
+      }
+    }
+  }
+  msg( INFO, "  total          : %10llu %10llu (%5.1f%%)\n", ( unsigned long long ) totalChecked, ( unsigned long long ) totalAllZero, totalChecked ? 100.0 * totalAllZero / totalChecked : 0.0 );
+}
+#endif
+
+static TCoeff maxAbsCoeffCore( const TCoeff* src, const int numCoeff )
+{
+  TCoeff maxAbs = 0;
+  for( int i = 0; i < numCoeff; i++ )
+  {
+    maxAbs = std::max<TCoeff>( maxAbs, abs( src[i] ) );
+  }
+  return maxAbs;
+}
+
 Quant::Quant( const Quant* other )
 {
   xInitScalingList( other );
+
+  m_maxAbsCoeff = maxAbsCoeffCore;
+#if ENABLE_SIMD_OPT_QUANT
+#ifdef TARGET_SIMD_X86
+  initQuantX86();
+#endif
+#endif
 }
 
 Quant::~Quant()
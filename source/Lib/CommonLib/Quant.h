@@ -46,6 +46,10 @@
 
 #include "UnitPartitioner.h"
 
+#if ENABLE_QUANT_ZERO_TU_STATS
+#include <atomic>
+#endif
+
 //! \ingroup CommonLib
 //! \{
 
@@ -101,6 +105,22 @@ public:
 
 }; // END STRUCT DEFINITION QpParam
 
+#if ENABLE_QUANT_ZERO_TU_STATS
+/// statistics of the all-zero TU detection of the quantizers, per TU size and QP
+class QuantZeroTUStats
+{
+public:
+  static void count ( const CompArea& area, const int qp, const bool allZero );
+  static void report();
+
+private:
+  static const int NUM_QP = 128;
+
+  static std::atomic<uint64_t> m_numChecked[MAX_CU_DEPTH + 1][MAX_CU_DEPTH + 1][NUM_QP];
+  static std::atomic<uint64_t> m_numAllZero[MAX_CU_DEPTH + 1][MAX_CU_DEPTH + 1][NUM_QP];
+};
+#endif
+
 /// transform and quantization class
 class Quant
 {
@@ -162,6 +182,15 @@ protected:
   bool xNeedRDOQ                 ( TransformUnit &tu, const ComponentID &compID, const CCoeffBuf &pSrc, const QpParam &cQP );
 #endif
 
+  // maximum absolute value of a contiguous coefficient block, used to detect blocks that quantize to zero
+  TCoeff (*m_maxAbsCoeff)        ( const TCoeff* src, const int numCoeff );
+
+#if ENABLE_SIMD_OPT_QUANT && defined( TARGET_SIMD_X86 )
+  void initQuantX86();
+  template <X86_VEXT vext>
+  void _initQuantX86();
+#endif
+
   double   m_dLambda;
   uint32_t     m_uiMaxTrSize;
   bool     m_useRDOQ;
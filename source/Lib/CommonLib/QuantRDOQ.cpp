@@ -617,12 +617,6 @@ void QuantRDOQ::xRateDistOptQuant(TransformUnit &tu, const ComponentID &compID,
   TCoeff *deltaU       = m_deltaU;
 
   memset(piDstCoeff, 0, sizeof(*piDstCoeff) * uiMaxNumCoeff);
-  memset( m_pdCostCoeff,  0, sizeof( double ) *  uiMaxNumCoeff );
-  memset( m_pdCostSig,    0, sizeof( double ) *  uiMaxNumCoeff );
-  memset( m_rateIncUp,    0, sizeof( int    ) *  uiMaxNumCoeff );
-  memset( m_rateIncDown,  0, sizeof( int    ) *  uiMaxNumCoeff );
-  memset( m_sigRateDelta, 0, sizeof( int    ) *  uiMaxNumCoeff );
-  memset( m_deltaU,       0, sizeof( TCoeff ) *  uiMaxNumCoeff );
 
 
   const bool needSqrtAdjustment= TU::needsBlockSizeTrafoScale( tu, compID );
@@ -640,6 +634,26 @@ void QuantRDOQ::xRateDistOptQuant(TransformUnit &tu, const ComponentID &compID,
   const double defaultErrorScale              = xGetErrScaleCoeffNoScalingList(scalingListType, uiLog2BlockWidth, uiLog2BlockHeight, cQP.rem(isTransformSkip));
   const int iQBits = QUANT_SHIFT + cQP.per(isTransformSkip) + iTransformShift + (needSqrtAdjustment?-1:0);                   // Right shift of non-RDOQ quantizer;  level = (coeff*uiQ + offset)>>q_bits
 
+  if( !enableScalingLists )
+  {
+    // RDOQ never increases the rounded level, so the block is all-zero if the largest coefficient rounds to zero
+    const bool allZero = int64_t( m_maxAbsCoeff( plSrcCoeff, uiMaxNumCoeff ) ) * defaultQuantisationCoefficient < ( int64_t( 1 ) << ( iQBits - 1 ) );
+#if ENABLE_QUANT_ZERO_TU_STATS
+    QuantZeroTUStats::count( rect, cQP.Qp( isTransformSkip ), allZero );
+#endif
+    if( allZero )
+    {
+      return;
+    }
+  }
+
+  memset( m_pdCostCoeff,  0, sizeof( double ) *  uiMaxNumCoeff );
+  memset( m_pdCostSig,    0, sizeof( double ) *  uiMaxNumCoeff );
+  memset( m_rateIncUp,    0, sizeof( int    ) *  uiMaxNumCoeff );
+  memset( m_rateIncDown,  0, sizeof( int    ) *  uiMaxNumCoeff );
+  memset( m_sigRateDelta, 0, sizeof( int    ) *  uiMaxNumCoeff );
+  memset( m_deltaU,       0, sizeof( TCoeff ) *  uiMaxNumCoeff );
+
 
   const TCoeff entropyCodingMinimum = -(1 << maxLog2TrDynamicRange);
   const TCoeff entropyCodingMaximum =  (1 << maxLog2TrDynamicRange) - 1;
@@ -7199,10 +7199,10 @@ Distortion RdCost::xAffineGetHADs( const DistParam &rcDtParam )
 #endif
 
 #if WCG_EXT
-uint32_t   RdCost::m_signalType                 = RESHAPE_SIGNAL_NULL;
-double     RdCost::m_chromaWeight               = 1.0;
-int        RdCost::m_lumaBD                     = 10;
-std::vector<double> RdCost::m_reshapeLumaLevelToWeightPLUT;
+thread_local uint32_t RdCost::m_signalType      = RESHAPE_SIGNAL_NULL;
+thread_local double   RdCost::m_chromaWeight    = 1.0;
+thread_local int      RdCost::m_lumaBD          = 10;
+thread_local std::vector<double> RdCost::m_reshapeLumaLevelToWeightPLUT;
 std::vector<double> RdCost::m_lumaLevelToWeightPLUT;
 
 void RdCost::saveUnadjustedLambda()
@@ -121,11 +121,12 @@ private:
 #if WCG_EXT
   double                  m_dLambda_unadjusted; // TODO: check is necessary
   double                  m_DistScaleUnadjusted;
-  static std::vector<double> m_reshapeLumaLevelToWeightPLUT;
+  // the reshaper weights follow the picture being coded, so every encoder thread keeps its own copy
+  static thread_local std::vector<double> m_reshapeLumaLevelToWeightPLUT;
   static std::vector<double> m_lumaLevelToWeightPLUT;
-  static uint32_t         m_signalType;
-  static double           m_chromaWeight;
-  static int              m_lumaBD;
+  static thread_local uint32_t m_signalType;
+  static thread_local double   m_chromaWeight;
+  static thread_local int      m_lumaBD;
   ChromaFormat            m_cf;
 #endif
   double                  m_DistScale;
@@ -455,8 +455,6 @@ void initROM()
   initGeoTemplate();
 #endif
 
-  ::memset(g_isReusedUniMVsFilled, 0, sizeof(g_isReusedUniMVsFilled));
-
 #if JVET_Q0503_Q0712_PLT_ENCODER_IMPROV_BUGFIX
   for (int qp = 0; qp < 57; qp++)
   {
@@ -749,9 +747,6 @@ uint8_t g_triangleMvStorage[TRIANGLE_DIR_NUM][MAX_CU_DEPTH - MIN_CU_LOG2 + 1][MA
 int16_t *g_triangleWeights[TRIANGLE_DIR_NUM][MAX_CU_DEPTH - MIN_CU_LOG2 + 2][MAX_CU_DEPTH - MIN_CU_LOG2 + 2];
 #endif
 
-Mv   g_reusedUniMVs[32][32][8][8][2][33];
-bool g_isReusedUniMVsFilled[32][32][8][8];
-
 #if JVET_Q0503_Q0712_PLT_ENCODER_IMPROV_BUGFIX
 uint16_t g_paletteQuant[57];
 #else
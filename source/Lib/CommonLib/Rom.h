@@ -213,10 +213,6 @@ extern int16_t *g_triangleWeights[TRIANGLE_DIR_NUM][MAX_CU_DEPTH - MIN_CU_LOG2 +
 
 extern bool g_mctsDecCheckEnabled;
 
-class  Mv;
-extern Mv   g_reusedUniMVs[32][32][8][8][2][33];
-extern bool g_isReusedUniMVsFilled[32][32][8][8];
-
 #if JVET_Q0503_Q0712_PLT_ENCODER_IMPROV_BUGFIX
 extern uint16_t g_paletteQuant[57];
 #else
@@ -156,6 +156,50 @@ template<int signedMode> void invTransformCbCr( PelBuf &resCb, PelBuf &resCr )
   }
 }
 
+static void fwdLfnstNxNCore( const TCoeff* src, TCoeff* dst, const int8_t* trMat, const int trSize, const int zeroOutSize )
+{
+  int     coef;
+  TCoeff* out = dst;
+
+  for( int j = 0; j < zeroOutSize; j++ )
+  {
+    const TCoeff* srcPtr   = src;
+    const int8_t* trMatTmp = trMat;
+    coef = 0;
+    for( int i = 0; i < trSize; i++ )
+    {
+      coef += *srcPtr++ * *trMatTmp++;
+    }
+    *out++ = ( coef + 64 ) >> 7;
+    trMat += trSize;
+  }
+
+  ::memset( out, 0, ( trSize - zeroOutSize ) * sizeof( TCoeff ) );
+}
+
+static void invLfnstNxNCore( const TCoeff* src, TCoeff* dst, const int8_t* trMat, const int trSize, const int zeroOutSize )
+{
+  int             maxLog2TrDynamicRange =  15;
+  const TCoeff    outputMinimum         = -( 1 << maxLog2TrDynamicRange );
+  const TCoeff    outputMaximum         =  ( 1 << maxLog2TrDynamicRange ) - 1;
+  int             resi;
+  TCoeff*         out                   =  dst;
+
+  for( int j = 0; j < trSize; j++ )
+  {
+    resi = 0;
+    const int8_t* trMatTmp = trMat;
+    const TCoeff* srcPtr   = src;
+    for( int i = 0; i < zeroOutSize; i++ )
+    {
+      resi += *srcPtr++ * *trMatTmp;
+      trMatTmp += trSize;
+    }
+    *out++ = Clip3( outputMinimum, outputMaximum, ( int ) ( resi + 64 ) >> 7 );
+    trMat++;
+  }
+}
+
 // ====================================================================================================================
 // TrQuant class member functions
 // ====================================================================================================================
@@ -180,6 +224,17 @@ TrQuant::TrQuant() : m_quant( nullptr )
     m_fwdICT[ 3]  = fwdTransformCbCr< 3>;
     m_fwdICT[-3]  = fwdTransformCbCr<-3>;
   }
+
+  memcpy( m_fwdTrans, fastFwdTrans, sizeof( m_fwdTrans ) );
+  memcpy( m_invTrans, fastInvTrans, sizeof( m_invTrans ) );
+  m_fwdLfnstNxN = fwdLfnstNxNCore;
+  m_invLfnstNxN = invLfnstNxNCore;
+
+#if ENABLE_SIMD_OPT_TRAFO
+#ifdef TARGET_SIMD_X86
+  initTrQuantX86();
+#endif
+#endif
 }
 
 TrQuant::~TrQuant()
@@ -233,52 +288,20 @@ void TrQuant::fwdLfnstNxN( int* src, int* dst, const uint32_t mode, const uint32
 {
   const int8_t* trMat  = ( size > 4 ) ? g_lfnst8x8[ mode ][ index ][ 0 ] : g_lfnst4x4[ mode ][ index ][ 0 ];
   const int     trSize = ( size > 4 ) ? 48 : 16;
-  int           coef;
-  int*          out    = dst;
 
   assert( index < 3 );
 
-  for( int j = 0; j < zeroOutSize; j++ )
-  {
-    int*          srcPtr   = src;
-    const int8_t* trMatTmp = trMat;
-    coef = 0;
-    for( int i = 0; i < trSize; i++ )
-    {
-      coef += *srcPtr++ * *trMatTmp++;
-    }
-    *out++ = ( coef + 64 ) >> 7;
-    trMat += trSize;
-  }
-
-  ::memset( out, 0, ( trSize - zeroOutSize ) * sizeof( int ) );
+  m_fwdLfnstNxN( src, dst, trMat, trSize, zeroOutSize );
 }
 
 void TrQuant::invLfnstNxN( int* src, int* dst, const uint32_t mode, const uint32_t index, const uint32_t size, int zeroOutSize )
 {
-  int             maxLog2TrDynamicRange =  15;
-  const TCoeff    outputMinimum         = -( 1 << maxLog2TrDynamicRange );
-  const TCoeff    outputMaximum         =  ( 1 << maxLog2TrDynamicRange ) - 1;
-  const int8_t*   trMat                 =  ( size > 4 ) ? g_lfnst8x8[ mode ][ index ][ 0 ] : g_lfnst4x4[ mode ][ index ][ 0 ];
-  const int       trSize                =  ( size > 4 ) ? 48 : 16;
-  int             resi;
-  int*            out                   =  dst;
+  const int8_t* trMat  = ( size > 4 ) ? g_lfnst8x8[ mode ][ index ][ 0 ] : g_lfnst4x4[ mode ][ index ][ 0 ];
+  const int     trSize = ( size > 4 ) ? 48 : 16;
 
   assert( index < 3 );
 
-  for( int j = 0; j < trSize; j++ )
-  {
-    resi = 0;
-    const int8_t* trMatTmp = trMat;
-    int*          srcPtr   = src;
-    for( int i = 0; i < zeroOutSize; i++ )
-    {
-      resi += *srcPtr++ * *trMatTmp;
-      trMatTmp += trSize;
-    }
-    *out++ = Clip3( outputMinimum, outputMaximum, ( int ) ( resi + 64 ) >> 7 );
-    trMat++;
-  }
+  m_invLfnstNxN( src, dst, trMat, trSize, zeroOutSize );
 }
 
 uint32_t TrQuant::getLFNSTIntraMode( int wideAngPredMode )
@@ -804,22 +827,22 @@ void TrQuant::xT( const TransformUnit &tu, const ComponentID &compID, const CPel
     CHECK( shift_2nd < 0, "Negative shift" );
   TCoeff *tmp = ( TCoeff * ) alloca( width * height * sizeof( TCoeff ) );
 
-  fastFwdTrans[trTypeHor][transformWidthIndex ](block,        tmp, shift_1st, height,        0, skipWidth);
-  fastFwdTrans[trTypeVer][transformHeightIndex](tmp, dstCoeff.buf, shift_2nd, width, skipWidth, skipHeight);
+  m_fwdTrans[trTypeHor][transformWidthIndex ](block,        tmp, shift_1st, height,        0, skipWidth);
+  m_fwdTrans[trTypeVer][transformHeightIndex](tmp, dstCoeff.buf, shift_2nd, width, skipWidth, skipHeight);
   }
   else if( height == 1 ) //1-D horizontal transform
   {
     const int      shift              = ((floorLog2(width )) + bitDepth + TRANSFORM_MATRIX_SHIFT) - maxLog2TrDynamicRange + COM16_C806_TRANS_PREC;
     CHECK( shift < 0, "Negative shift" );
     CHECKD( ( transformWidthIndex < 0 ), "There is a problem with the width." );
-    fastFwdTrans[trTypeHor][transformWidthIndex]( block, dstCoeff.buf, shift, 1, 0, skipWidth );
+    m_fwdTrans[trTypeHor][transformWidthIndex]( block, dstCoeff.buf, shift, 1, 0, skipWidth );
   }
   else //if (iWidth == 1) //1-D vertical transform
   {
     int shift = ( ( floorLog2(height) ) + bitDepth + TRANSFORM_MATRIX_SHIFT ) - maxLog2TrDynamicRange + COM16_C806_TRANS_PREC;
     CHECK( shift < 0, "Negative shift" );
     CHECKD( ( transformHeightIndex < 0 ), "There is a problem with the height." );
-    fastFwdTrans[trTypeVer][transformHeightIndex]( block, dstCoeff.buf, shift, 1, 0, skipHeight );
+    m_fwdTrans[trTypeVer][transformHeightIndex]( block, dstCoeff.buf, shift, 1, 0, skipHeight );
   }
 }
 
@@ -865,22 +888,22 @@ void TrQuant::xIT( const TransformUnit &tu, const ComponentID &compID, const CCo
     CHECK( shift_1st < 0, "Negative shift" );
     CHECK( shift_2nd < 0, "Negative shift" );
     TCoeff *tmp = ( TCoeff * ) alloca( width * height * sizeof( TCoeff ) );
-  fastInvTrans[trTypeVer][transformHeightIndex](pCoeff.buf, tmp, shift_1st, width, skipWidth, skipHeight, clipMinimum, clipMaximum);
-  fastInvTrans[trTypeHor][transformWidthIndex] (tmp,      block, shift_2nd, height,         0, skipWidth, clipMinimum, clipMaximum);
+  m_invTrans[trTypeVer][transformHeightIndex](pCoeff.buf, tmp, shift_1st, width, skipWidth, skipHeight, clipMinimum, clipMaximum);
+  m_invTrans[trTypeHor][transformWidthIndex] (tmp,      block, shift_2nd, height,         0, skipWidth, clipMinimum, clipMaximum);
   }
   else if( width == 1 ) //1-D vertical transform
   {
     int shift = ( TRANSFORM_MATRIX_SHIFT + maxLog2TrDynamicRange - 1 ) - bitDepth + COM16_C806_TRANS_PREC;
     CHECK( shift < 0, "Negative shift" );
     CHECK( ( transformHeightIndex < 0 ), "There is a problem with the height." );
-    fastInvTrans[trTypeVer][transformHeightIndex]( pCoeff.buf, block, shift + 1, 1, 0, skipHeight, clipMinimum, clipMaximum );
+    m_invTrans[trTypeVer][transformHeightIndex]( pCoeff.buf, block, shift + 1, 1, 0, skipHeight, clipMinimum, clipMaximum );
   }
   else //if(iHeight == 1) //1-D horizontal transform
   {
     const int      shift              = ( TRANSFORM_MATRIX_SHIFT + maxLog2TrDynamicRange - 1 ) - bitDepth + COM16_C806_TRANS_PREC;
     CHECK( shift < 0, "Negative shift" );
     CHECK( ( transformWidthIndex < 0 ), "There is a problem with the width." );
-    fastInvTrans[trTypeHor][transformWidthIndex]( pCoeff.buf, block, shift + 1, 1, 0, skipWidth, clipMinimum, clipMaximum );
+    m_invTrans[trTypeHor][transformWidthIndex]( pCoeff.buf, block, shift + 1, 1, 0, skipWidth, clipMinimum, clipMaximum );
   }
 
   Pel *resiBuf    = pResidual.buf;
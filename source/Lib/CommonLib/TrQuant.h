@@ -54,6 +54,9 @@
 typedef void FwdTrans(const TCoeff*, TCoeff*, int, int, int, int);
 typedef void InvTrans(const TCoeff*, TCoeff*, int, int, int, int, const TCoeff, const TCoeff);
 
+extern FwdTrans *fastFwdTrans[NUM_TRANS_TYPE][g_numTransformMatrixSizes];
+extern InvTrans *fastInvTrans[NUM_TRANS_TYPE][g_numTransformMatrixSizes];
+
 // ====================================================================================================================
 // Class definition
 // ====================================================================================================================
@@ -136,6 +139,17 @@ private:
   void                      (**m_invICT)(PelBuf&,PelBuf&);
   std::pair<int64_t,int64_t>(**m_fwdICT)(const PelBuf&,const PelBuf&,PelBuf&,PelBuf&);
 
+  FwdTrans *m_fwdTrans[NUM_TRANS_TYPE][g_numTransformMatrixSizes];
+  InvTrans *m_invTrans[NUM_TRANS_TYPE][g_numTransformMatrixSizes];
+  void    (*m_fwdLfnstNxN)( const TCoeff* src, TCoeff* dst, const int8_t* trMat, const int trSize, const int zeroOutSize );
+  void    (*m_invLfnstNxN)( const TCoeff* src, TCoeff* dst, const int8_t* trMat, const int trSize, const int zeroOutSize );
+
+#if ENABLE_SIMD_OPT_TRAFO && defined( TARGET_SIMD_X86 )
+  void initTrQuantX86();
+  template <X86_VEXT vext>
+  void _initTrQuantX86();
+#endif
+
 
   // forward Transform
   void xT               (const TransformUnit &tu, const ComponentID &compID, const CPelBuf &resi, CoeffBuf &dstCoeff, const int width, const int height);
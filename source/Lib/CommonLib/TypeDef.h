@@ -49,6 +49,7 @@
 #include <cstring>
 #include <assert.h>
 #include <cassert>
+#include <memory>
 
 #define CABAC_RETRAIN                                     1 // CABAC retraining based on VTM8rc1
 
@@ -261,6 +262,26 @@ typedef std::pair<int, int>  TrCost;
 #define JVET_J0090_MEMORY_BANDWITH_MEASURE                0
 #endif
 
+#ifndef ENABLE_QUANT_ZERO_TU_STATS
+#define ENABLE_QUANT_ZERO_TU_STATS                        0 ///< count the TUs for which the quantizers skip the trellis because all coefficients quantize to zero (reported per TU size and QP at the end of encoding)
+#endif
+
+#ifndef ENABLE_CS_COPY_STATS
+#define ENABLE_CS_COPY_STATS                              0 ///< count the bytes copied when coding structures are promoted in the CU RDO tree (reported per CTU at the end of encoding)
+#endif
+
+#ifndef CS_COPY_CODED_COEFFS_ONLY
+#define CS_COPY_CODED_COEFFS_ONLY                         1 ///< when a sub-structure is adopted by its parent, copy only the coefficient blocks with a coded cbf
+#endif
+
+#ifndef ENABLE_CTX_COPY_STATS
+#define ENABLE_CTX_COPY_STATS                             0 ///< count the bytes of CABAC context models copied between context stores (reported per CTU at the end of encoding)
+#endif
+
+#ifndef CTX_JOURNALED_COPY
+#define CTX_JOURNALED_COPY                                1 ///< journal the context models changed since a context store was copied, and copy only those between related stores
+#endif
+
 #ifndef EXTENSION_360_VIDEO
 #define EXTENSION_360_VIDEO                               0   ///< extension for 360/spherical video coding support; this macro should be controlled by makefile, as it would be used to control whether the library is built and linked
 #endif
@@ -359,13 +380,23 @@ typedef std::pair<int, int>  TrCost;
 #endif
 
 // SIMD optimizations
-#define SIMD_ENABLE                                       0
+#ifndef SIMD_ENABLE
+#define SIMD_ENABLE                                       0 ///< can be overridden by the makefile
+#endif
 #define ENABLE_SIMD_OPT                                 ( SIMD_ENABLE && !RExt__HIGH_BIT_DEPTH_SUPPORT )    ///< SIMD optimizations, no impact on RD performance
 #define ENABLE_SIMD_OPT_MCIF                            ( 1 && ENABLE_SIMD_OPT )                            ///< SIMD optimization for the interpolation filter, no impact on RD performance
 #define ENABLE_SIMD_OPT_BUFFER                          ( 1 && ENABLE_SIMD_OPT )                            ///< SIMD optimization for the buffer operations, no impact on RD performance
 #define ENABLE_SIMD_OPT_DIST                            ( 1 && ENABLE_SIMD_OPT )                            ///< SIMD optimization for the distortion calculations(SAD,SSE,HADAMARD), no impact on RD performance
 #define ENABLE_SIMD_OPT_AFFINE_ME                       ( 1 && ENABLE_SIMD_OPT )                            ///< SIMD optimization for affine ME, no impact on RD performance
 #define ENABLE_SIMD_OPT_ALF                             ( 1 && ENABLE_SIMD_OPT )                            ///< SIMD optimization for ALF
+#define ENABLE_SIMD_OPT_TRAFO                           ( 1 && ENABLE_SIMD_OPT )                            ///< SIMD optimization for the core transforms and LFNST, no impact on RD performance
+#define ENABLE_SIMD_OPT_DEPQUANT                        ( 1 && ENABLE_SIMD_OPT )                            ///< SIMD optimization for the dependent quantization trellis, no impact on RD performance
+#define ENABLE_SIMD_OPT_QUANT                           ( 1 && ENABLE_SIMD_OPT )                            ///< SIMD optimization for the all-zero check of the quantizers, no impact on RD performance
+#define ENABLE_SIMD_OPT_INTRAPRED                       ( 1 && ENABLE_SIMD_OPT )                            ///< SIMD optimization for the angular, planar and PDPC intra prediction, no impact on RD performance
+#define ENABLE_SIMD_OPT_MIP                             ( 1 && ENABLE_SIMD_OPT )                            ///< SIMD optimization for the matrix-based intra prediction, no impact on RD performance
+#define ENABLE_SIMD_OPT_HASH                            ( 1 && ENABLE_SIMD_OPT )                            ///< SIMD optimization for the CRC32C block hashes of the inter hash ME, no impact on RD performance
+#define ENABLE_SIMD_OPT_IBC                             ( 1 && ENABLE_SIMD_OPT )                            ///< SIMD optimization for the CRC32C block hashes of the IBC hash search, no impact on RD performance
+#define ENABLE_SIMD_OPT_BITSTREAM                       ( 1 && ENABLE_SIMD_OPT )                            ///< SIMD optimization for the emulation prevention byte scan of NAL units, no impact on the bitstream
 #if ENABLE_SIMD_OPT_BUFFER
 #define ENABLE_SIMD_OPT_BCW                               1                                                 ///< SIMD optimization for Bcw
 #endif
@@ -1518,14 +1549,36 @@ public:
 // dynamic cache
 // ---------------------------------------------------------------------------
 
+// Elements are allocated in contiguous slabs owned by the cache, and handed out in address order from a LIFO free list,
+// so units taken together stay adjacent in memory and recently released (cache-hot) ones are reused first. Each cache
+// is owned by a single encoder/decoder instance, so there is one per split-parallelism thread.
 template<typename T>
 class dynamic_cache
 {
-  std::vector<T*> m_cache;
+  static const size_t SLAB_SIZE = 64;
+
+  std::vector<T*>                   m_cache;
+  std::vector<std::unique_ptr<T[]>> m_slabs;
 #if ENABLE_SPLIT_PARALLELISM
   int64_t         m_cacheId;
 #endif
 
+  void allocSlab()
+  {
+    T* slab = new T[SLAB_SIZE];
+    m_slabs.emplace_back( slab );
+    m_cache.reserve( m_slabs.size() * SLAB_SIZE );
+
+    for( size_t i = SLAB_SIZE; i > 0; i-- )
+    {
+#if ENABLE_SPLIT_PARALLELISM
+      slab[i - 1].cacheId   = m_cacheId;
+      slab[i - 1].cacheUsed = true;
+#endif
+      m_cache.push_back( &slab[i - 1] );
+    }
+  }
+
 public:
 
 #if ENABLE_SPLIT_PARALLELISM
@@ -1543,32 +1596,23 @@ public:
 
   void deleteEntries()
   {
-    for( auto &p : m_cache )
-    {
-      delete p;
-      p = nullptr;
-    }
-
     m_cache.clear();
+    m_slabs.clear();
   }
 
   T* get()
   {
-    T* ret;
-
-    if( !m_cache.empty() )
+    if( m_cache.empty() )
     {
-      ret = m_cache.back();
-      m_cache.pop_back();
+      allocSlab();
+    }
+
+    T* ret = m_cache.back();
+    m_cache.pop_back();
 #if ENABLE_SPLIT_PARALLELISM
-      CHECK( ret->cacheId != m_cacheId, "Putting item into wrong cache!" );
-      CHECK( !ret->cacheUsed,           "Fetched an element that should've been in cache!!" );
+    CHECK( ret->cacheId != m_cacheId, "Putting item into wrong cache!" );
+    CHECK( !ret->cacheUsed,           "Fetched an element that should've been in cache!!" );
 #endif
-    }
-    else
-    {
-      ret = new T;
-    }
 
 #if ENABLE_SPLIT_PARALLELISM
     ret->cacheId   = m_cacheId;
@@ -801,6 +801,12 @@ void TransformUnit::init(TCoeff **coeffs, Pel **pcmbuf, bool **runType)
 }
 
 TransformUnit& TransformUnit::operator=(const TransformUnit& other)
+{
+  copyFrom( other, false );
+  return *this;
+}
+
+void TransformUnit::copyFrom(const TransformUnit& other, const bool codedCoeffsOnly)
 {
   CHECK( chromaFormat != other.chromaFormat, "Incompatible formats" );
 
@@ -811,7 +817,8 @@ TransformUnit& TransformUnit::operator=(const TransformUnit& other)
 
     uint32_t area = blocks[i].area();
 
-    if (m_coeffs[i] && other.m_coeffs[i] && m_coeffs[i] != other.m_coeffs[i]) memcpy(m_coeffs[i], other.m_coeffs[i], sizeof(TCoeff) * area);
+    // coefficients of blocks without a coded cbf are never read
+    if (m_coeffs[i] && other.m_coeffs[i] && m_coeffs[i] != other.m_coeffs[i] && (!codedCoeffsOnly || other.cbf[i])) memcpy(m_coeffs[i], other.m_coeffs[i], sizeof(TCoeff) * area);
     if (m_pcmbuf[i] && other.m_pcmbuf[i] && m_pcmbuf[i] != other.m_pcmbuf[i]) memcpy(m_pcmbuf[i], other.m_pcmbuf[i], sizeof(Pel   ) * area);
     if (cu->slice->getSPS()->getPLTMode() && i < 2)
     {
@@ -825,7 +832,6 @@ TransformUnit& TransformUnit::operator=(const TransformUnit& other)
   depth              = other.depth;
   noResidual         = other.noResidual;
   jointCbCr          = other.jointCbCr;
-  return *this;
 }
 
 void TransformUnit::copyComponentFrom(const TransformUnit& other, const ComponentID i)
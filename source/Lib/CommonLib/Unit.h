@@ -489,6 +489,7 @@ struct TransformUnit : public UnitArea
   void init(TCoeff **coeffs, Pel **pcmbuf, bool **runType);
 
   TransformUnit& operator=(const TransformUnit& other);
+  void copyFrom           (const TransformUnit& other, const bool codedCoeffsOnly);
   void copyComponentFrom  (const TransformUnit& other, const ComponentID compID);
   void checkTuNoResidual( unsigned idx );
   int  getTbAreaAfterCoefZeroOut(ComponentID compID) const;
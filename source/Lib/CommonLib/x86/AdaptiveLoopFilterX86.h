@@ -681,12 +681,228 @@ static void simdFilter7x7Blk(AlfClassifier **classifier, const PelUnitBuf &recDs
   }
 }
 
+#if JVET_Q0795_CCALF
+// gathers the luma samples co-located with 8 consecutive chroma samples
+template<bool subSampledX>
+static inline __m128i simdLoadCcAlfLuma(const Pel *src)
+{
+  if (subSampledX)
+  {
+    const __m128i mmMask = _mm_set1_epi32(0xffff);
+    const __m128i lo     = _mm_and_si128(_mm_loadu_si128((const __m128i *) src), mmMask);
+    const __m128i hi     = _mm_and_si128(_mm_loadu_si128((const __m128i *) (src + 8)), mmMask);
+    return _mm_packus_epi32(lo, hi);
+  }
+  return _mm_loadu_si128((const __m128i *) src);
+}
+
+#ifdef USE_AVX2
+template<bool subSampledX>
+static inline __m256i simdLoadCcAlfLuma256(const Pel *src)
+{
+  if (subSampledX)
+  {
+    const __m256i mmMask = _mm256_set1_epi32(0xffff);
+    const __m256i lo     = _mm256_and_si256(_mm256_loadu_si256((const __m256i *) src), mmMask);
+    const __m256i hi     = _mm256_and_si256(_mm256_loadu_si256((const __m256i *) (src + 16)), mmMask);
+    return _mm256_permute4x64_epi64(_mm256_packus_epi32(lo, hi), 0xd8);
+  }
+  return _mm256_loadu_si256((const __m256i *) src);
+}
+#endif
+
+template<X86_VEXT vext, bool subSampledX>
+static void simdFilterRowCcAlf(Pel *dst, const Pel *src, const int width, const ptrdiff_t offset1,
+                               const ptrdiff_t offset2, const ptrdiff_t offset3, const int16_t *filterCoeff,
+                               const ClpRng &clpRng)
+{
+  constexpr int SHIFT  = AdaptiveLoopFilter::m_scaleBits;
+  constexpr int ROUND  = 1 << (SHIFT - 1);
+  constexpr int SCALEX = subSampledX ? 1 : 0;
+
+  const int offset = 1 << clpRng.bd >> 1;
+
+  const int coeff01 = (int) ((uint16_t) filterCoeff[0] | ((uint32_t) (uint16_t) filterCoeff[1] << 16));
+  const int coeff23 = (int) ((uint16_t) filterCoeff[2] | ((uint32_t) (uint16_t) filterCoeff[3] << 16));
+  const int coeff45 = (int) ((uint16_t) filterCoeff[4] | ((uint32_t) (uint16_t) filterCoeff[5] << 16));
+  const int coeff6  = (uint16_t) filterCoeff[6];
+
+  int j = 0;
+#ifdef USE_AVX2
+  if (vext >= AVX2)
+  {
+    const __m256i mmC01    = _mm256_set1_epi32(coeff01);
+    const __m256i mmC23    = _mm256_set1_epi32(coeff23);
+    const __m256i mmC45    = _mm256_set1_epi32(coeff45);
+    const __m256i mmC6     = _mm256_set1_epi32(coeff6);
+    const __m256i mmRound  = _mm256_set1_epi32(ROUND);
+    const __m256i mmMinCc  = _mm256_set1_epi16(clpRng.min - offset);
+    const __m256i mmMaxCc  = _mm256_set1_epi16(clpRng.max - offset);
+    const __m256i mmMin    = _mm256_set1_epi16(clpRng.min);
+    const __m256i mmMax    = _mm256_set1_epi16(clpRng.max);
+
+    for (; j + 16 <= width; j += 16)
+    {
+      const Pel *cross = src + (j << SCALEX);
+
+      const __m256i cur = simdLoadCcAlfLuma256<subSampledX>(cross);
+      const __m256i d0  = _mm256_sub_epi16(simdLoadCcAlfLuma256<subSampledX>(cross + offset2), cur);
+      const __m256i d1  = _mm256_sub_epi16(simdLoadCcAlfLuma256<subSampledX>(cross - 1), cur);
+      const __m256i d2  = _mm256_sub_epi16(simdLoadCcAlfLuma256<subSampledX>(cross + 1), cur);
+      const __m256i d3  = _mm256_sub_epi16(simdLoadCcAlfLuma256<subSampledX>(cross + offset1 - 1), cur);
+      const __m256i d4  = _mm256_sub_epi16(simdLoadCcAlfLuma256<subSampledX>(cross + offset1), cur);
+      const __m256i d5  = _mm256_sub_epi16(simdLoadCcAlfLuma256<subSampledX>(cross + offset1 + 1), cur);
+      const __m256i d6  = _mm256_sub_epi16(simdLoadCcAlfLuma256<subSampledX>(cross + offset3), cur);
+
+      __m256i accumA = _mm256_madd_epi16(_mm256_unpacklo_epi16(d0, d1), mmC01);
+      __m256i accumB = _mm256_madd_epi16(_mm256_unpackhi_epi16(d0, d1), mmC01);
+      accumA = _mm256_add_epi32(accumA, _mm256_madd_epi16(_mm256_unpacklo_epi16(d2, d3), mmC23));
+      accumB = _mm256_add_epi32(accumB, _mm256_madd_epi16(_mm256_unpackhi_epi16(d2, d3), mmC23));
+      accumA = _mm256_add_epi32(accumA, _mm256_madd_epi16(_mm256_unpacklo_epi16(d4, d5), mmC45));
+      accumB = _mm256_add_epi32(accumB, _mm256_madd_epi16(_mm256_unpackhi_epi16(d4, d5), mmC45));
+      accumA = _mm256_add_epi32(accumA, _mm256_madd_epi16(_mm256_unpacklo_epi16(d6, _mm256_setzero_si256()), mmC6));
+      accumB = _mm256_add_epi32(accumB, _mm256_madd_epi16(_mm256_unpackhi_epi16(d6, _mm256_setzero_si256()), mmC6));
+
+      accumA = _mm256_srai_epi32(_mm256_add_epi32(accumA, mmRound), SHIFT);
+      accumB = _mm256_srai_epi32(_mm256_add_epi32(accumB, mmRound), SHIFT);
+
+      __m256i sum = _mm256_packs_epi32(accumA, accumB);
+      sum = _mm256_min_epi16(mmMaxCc, _mm256_max_epi16(sum, mmMinCc));
+      sum = _mm256_add_epi16(sum, _mm256_loadu_si256((const __m256i *) (dst + j)));
+      sum = _mm256_min_epi16(mmMax, _mm256_max_epi16(sum, mmMin));
+
+      _mm256_storeu_si256((__m256i *) (dst + j), sum);
+    }
+  }
+#endif
+
+  const __m128i mmC01    = _mm_set1_epi32(coeff01);
+  const __m128i mmC23    = _mm_set1_epi32(coeff23);
+  const __m128i mmC45    = _mm_set1_epi32(coeff45);
+  const __m128i mmC6     = _mm_set1_epi32(coeff6);
+  const __m128i mmRound  = _mm_set1_epi32(ROUND);
+  const __m128i mmMinCc  = _mm_set1_epi16(clpRng.min - offset);
+  const __m128i mmMaxCc  = _mm_set1_epi16(clpRng.max - offset);
+  const __m128i mmMin    = _mm_set1_epi16(clpRng.min);
+  const __m128i mmMax    = _mm_set1_epi16(clpRng.max);
+
+  for (; j + 8 <= width; j += 8)
+  {
+    const Pel *cross = src + (j << SCALEX);
+
+    const __m128i cur = simdLoadCcAlfLuma<subSampledX>(cross);
+    const __m128i d0  = _mm_sub_epi16(simdLoadCcAlfLuma<subSampledX>(cross + offset2), cur);
+    const __m128i d1  = _mm_sub_epi16(simdLoadCcAlfLuma<subSampledX>(cross - 1), cur);
+    const __m128i d2  = _mm_sub_epi16(simdLoadCcAlfLuma<subSampledX>(cross + 1), cur);
+    const __m128i d3  = _mm_sub_epi16(simdLoadCcAlfLuma<subSampledX>(cross + offset1 - 1), cur);
+    const __m128i d4  = _mm_sub_epi16(simdLoadCcAlfLuma<subSampledX>(cross + offset1), cur);
+    const __m128i d5  = _mm_sub_epi16(simdLoadCcAlfLuma<subSampledX>(cross + offset1 + 1), cur);
+    const __m128i d6  = _mm_sub_epi16(simdLoadCcAlfLuma<subSampledX>(cross + offset3), cur);
+
+    __m128i accumA = _mm_madd_epi16(_mm_unpacklo_epi16(d0, d1), mmC01);
+    __m128i accumB = _mm_madd_epi16(_mm_unpackhi_epi16(d0, d1), mmC01);
+    accumA = _mm_add_epi32(accumA, _mm_madd_epi16(_mm_unpacklo_epi16(d2, d3), mmC23));
+    accumB = _mm_add_epi32(accumB, _mm_madd_epi16(_mm_unpackhi_epi16(d2, d3), mmC23));
+    accumA = _mm_add_epi32(accumA, _mm_madd_epi16(_mm_unpacklo_epi16(d4, d5), mmC45));
+    accumB = _mm_add_epi32(accumB, _mm_madd_epi16(_mm_unpackhi_epi16(d4, d5), mmC45));
+    accumA = _mm_add_epi32(accumA, _mm_madd_epi16(_mm_unpacklo_epi16(d6, _mm_setzero_si128()), mmC6));
+    accumB = _mm_add_epi32(accumB, _mm_madd_epi16(_mm_unpackhi_epi16(d6, _mm_setzero_si128()), mmC6));
+
+    accumA = _mm_srai_epi32(_mm_add_epi32(accumA, mmRound), SHIFT);
+    accumB = _mm_srai_epi32(_mm_add_epi32(accumB, mmRound), SHIFT);
+
+    __m128i sum = _mm_packs_epi32(accumA, accumB);
+    sum = _mm_min_epi16(mmMaxCc, _mm_max_epi16(sum, mmMinCc));
+    sum = _mm_add_epi16(sum, _mm_loadu_si128((const __m128i *) (dst + j)));
+    sum = _mm_min_epi16(mmMax, _mm_max_epi16(sum, mmMin));
+
+    _mm_storeu_si128((__m128i *) (dst + j), sum);
+  }
+
+  for (; j < width; j++)
+  {
+    const Pel *cross = src + (j << SCALEX);
+    const Pel  cur   = cross[0];
+
+    int sum = filterCoeff[0] * (cross[offset2] - cur) + filterCoeff[1] * (cross[-1] - cur)
+            + filterCoeff[2] * (cross[1] - cur) + filterCoeff[3] * (cross[offset1 - 1] - cur)
+            + filterCoeff[4] * (cross[offset1] - cur) + filterCoeff[5] * (cross[offset1 + 1] - cur)
+            + filterCoeff[6] * (cross[offset3] - cur);
+
+    sum    = (sum + ROUND) >> SHIFT;
+    sum    = ClipPel(sum + offset, clpRng) - offset;
+    dst[j] = ClipPel(sum + dst[j], clpRng);
+  }
+}
+
+template<X86_VEXT vext>
+static void simdFilterBlkCcAlf(const PelBuf &dstBuf, const CPelUnitBuf &recSrc, const Area &blkDst,
+                               const Area &blkSrc, const ComponentID compId, const int16_t *filterCoeff,
+                               const ClpRngs &clpRngs, CodingStructure &cs, int vbCTUHeight, int vbPos)
+{
+  CHECK(1 << floorLog2(vbCTUHeight) != vbCTUHeight, "Not a power of 2");
+  CHECK(!isChroma(compId), "Must be chroma");
+
+  const ChromaFormat nChromaFormat = cs.slice->getSPS()->getChromaFormatIdc();
+  const int          scaleX        = getComponentScaleX(compId, nChromaFormat);
+  const int          scaleY        = getComponentScaleY(compId, nChromaFormat);
+
+  CHECK(blkDst.y % 4, "Wrong startHeight in filtering");
+  CHECK(blkDst.x % 4, "Wrong startWidth in filtering");
+  CHECK(blkDst.height % 4, "Wrong endHeight in filtering");
+  CHECK(blkDst.width % 4, "Wrong endWidth in filtering");
+
+  const CPelBuf   srcBuf     = recSrc.get(COMPONENT_Y);
+  const ptrdiff_t lumaStride = srcBuf.stride;
+  const Pel *     lumaPtr    = srcBuf.buf + blkSrc.y * lumaStride + blkSrc.x;
+
+  const ptrdiff_t chromaStride = dstBuf.stride;
+  Pel *           chromaPtr    = dstBuf.buf + blkDst.y * chromaStride + blkDst.x;
+
+  const ClpRng &clpRng = clpRngs.comp[compId];
+
+  for (int i = 0; i < blkDst.height; i++)
+  {
+    ptrdiff_t offset1 = lumaStride;
+    ptrdiff_t offset2 = -lumaStride;
+    ptrdiff_t offset3 = 2 * lumaStride;
+
+    const int pos = ((blkDst.y + i) << scaleY) & (vbCTUHeight - 1);
+    if (pos == (vbPos - 2) || pos == (vbPos + 1))
+    {
+      offset3 = offset1;
+    }
+    else if (pos == (vbPos - 1) || pos == vbPos)
+    {
+      offset1 = 0;
+      offset2 = 0;
+      offset3 = 0;
+    }
+
+    if (scaleX)
+    {
+      simdFilterRowCcAlf<vext, true>(chromaPtr, lumaPtr, blkDst.width, offset1, offset2, offset3, filterCoeff, clpRng);
+    }
+    else
+    {
+      simdFilterRowCcAlf<vext, false>(chromaPtr, lumaPtr, blkDst.width, offset1, offset2, offset3, filterCoeff, clpRng);
+    }
+
+    chromaPtr += chromaStride;
+    lumaPtr += lumaStride << scaleY;
+  }
+}
+#endif
+
 template <X86_VEXT vext>
 void AdaptiveLoopFilter::_initAdaptiveLoopFilterX86()
 {
   m_deriveClassificationBlk = simdDeriveClassificationBlk<vext>;
   m_filter5x5Blk = simdFilter5x5Blk<vext>;
   m_filter7x7Blk = simdFilter7x7Blk<vext>;
+#if JVET_Q0795_CCALF
+  m_filterCcAlf = simdFilterBlkCcAlf<vext>;
+#endif
 }
 
 template void AdaptiveLoopFilter::_initAdaptiveLoopFilterX86<SIMDX86>();
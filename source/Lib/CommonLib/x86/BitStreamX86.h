@@ -0,0 +1,98 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2020, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/**
+ * \file
+ * \brief Implementation of the zero pair scan used by the emulation prevention of NAL units
+ */
+
+#include "CommonDefX86.h"
+#include "../BitStream.h"
+
+#if ENABLE_SIMD_OPT_BITSTREAM
+#ifdef TARGET_SIMD_X86
+
+template<X86_VEXT vext>
+static size_t simdFindZeroPair( const uint8_t* buf, size_t size )
+{
+  // a position starts a zero pair when both the byte and its successor are zero, i.e. when (buf[i] | buf[i+1]) == 0
+  size_t i = 0;
+#ifdef USE_AVX2
+  if( vext >= AVX2 )
+  {
+    const __m256i vzero = _mm256_setzero_si256();
+    for( ; i + 33 <= size; i += 32 )
+    {
+      const __m256i vcur  = _mm256_loadu_si256( ( const __m256i* ) ( buf + i ) );
+      const __m256i vnext = _mm256_loadu_si256( ( const __m256i* ) ( buf + i + 1 ) );
+      const uint32_t mask = _mm256_movemask_epi8( _mm256_cmpeq_epi8( _mm256_or_si256( vcur, vnext ), vzero ) );
+      if( mask )
+      {
+        return i + floorLog2( mask & ( ~mask + 1 ) );
+      }
+    }
+  }
+#endif
+  const __m128i vzero = _mm_setzero_si128();
+  for( ; i + 17 <= size; i += 16 )
+  {
+    const __m128i vcur  = _mm_loadu_si128( ( const __m128i* ) ( buf + i ) );
+    const __m128i vnext = _mm_loadu_si128( ( const __m128i* ) ( buf + i + 1 ) );
+    const uint32_t mask = _mm_movemask_epi8( _mm_cmpeq_epi8( _mm_or_si128( vcur, vnext ), vzero ) );
+    if( mask )
+    {
+      return i + floorLog2( mask & ( ~mask + 1 ) );
+    }
+  }
+  for( ; i + 1 < size; i++ )
+  {
+    if( ( buf[i] | buf[i + 1] ) == 0 )
+    {
+      return i;
+    }
+  }
+  return size;
+}
+
+template <X86_VEXT vext>
+void BitstreamOps::_initBitstreamOpsX86()
+{
+  findZeroPair = simdFindZeroPair<vext>;
+}
+
+template void BitstreamOps::_initBitstreamOpsX86<SIMDX86>();
+
+#endif //#ifdef TARGET_SIMD_X86
+#endif
+//! \}
@@ -1048,6 +1048,125 @@ void linTf_SSE_entry( const Pel* src, int srcStride, Pel *dst, int dstStride, in
   }
 }
 
+template<X86_VEXT vext>
+uint64_t calcSSE_SIMD( const Pel* src0, int src0Stride, const Pel* src1, int src1Stride, int width, int height )
+{
+  if( width < 8 )
+  {
+    return calcSSECore( src0, src0Stride, src1, src1Stride, width, height );
+  }
+
+  // the sample differences fit 16 bits and the sums of two squares 32 bits, they are accumulated in 64 bits
+  uint64_t sum = 0;
+#ifdef USE_AVX2
+  if( vext >= AVX2 && width >= 16 )
+  {
+    const __m256i vzero = _mm256_setzero_si256();
+    __m256i vsum = vzero;
+    for( int y = 0; y < height; y++ )
+    {
+      int x = 0;
+      for( ; x + 16 <= width; x += 16 )
+      {
+        const __m256i vdiff = _mm256_sub_epi16( _mm256_loadu_si256( ( const __m256i* ) ( src0 + x ) ), _mm256_loadu_si256( ( const __m256i* ) ( src1 + x ) ) );
+        const __m256i vsqr  = _mm256_madd_epi16( vdiff, vdiff );
+        vsum = _mm256_add_epi64( vsum, _mm256_add_epi64( _mm256_unpacklo_epi32( vsqr, vzero ), _mm256_unpackhi_epi32( vsqr, vzero ) ) );
+      }
+      for( ; x < width; x++ )
+      {
+        const int64_t diff = (int64_t)src0[x] - (int64_t)src1[x];
+        sum += uint64_t( diff * diff );
+      }
+      src0 += src0Stride;
+      src1 += src1Stride;
+    }
+    const __m128i vsum128 = _mm_add_epi64( _mm256_castsi256_si128( vsum ), _mm256_extracti128_si256( vsum, 1 ) );
+    return sum + uint64_t( _mm_cvtsi128_si64( vsum128 ) ) + uint64_t( _mm_extract_epi64( vsum128, 1 ) );
+  }
+#endif
+  const __m128i vzero = _mm_setzero_si128();
+  __m128i vsum = vzero;
+  for( int y = 0; y < height; y++ )
+  {
+    int x = 0;
+    for( ; x + 8 <= width; x += 8 )
+    {
+      const __m128i vdiff = _mm_sub_epi16( _mm_loadu_si128( ( const __m128i* ) ( src0 + x ) ), _mm_loadu_si128( ( const __m128i* ) ( src1 + x ) ) );
+      const __m128i vsqr  = _mm_madd_epi16( vdiff, vdiff );
+      vsum = _mm_add_epi64( vsum, _mm_add_epi64( _mm_unpacklo_epi32( vsqr, vzero ), _mm_unpackhi_epi32( vsqr, vzero ) ) );
+    }
+    for( ; x < width; x++ )
+    {
+      const int64_t diff = (int64_t)src0[x] - (int64_t)src1[x];
+      sum += uint64_t( diff * diff );
+    }
+    src0 += src0Stride;
+    src1 += src1Stride;
+  }
+  return sum + uint64_t( _mm_cvtsi128_si64( vsum ) ) + uint64_t( _mm_extract_epi64( vsum, 1 ) );
+}
+
+template<X86_VEXT vext>
+uint64_t calcHPActivity_SIMD( const Pel* src, int srcStride, int width, int height )
+{
+  if( width < 4 )
+  {
+    return calcHPActivityCore( src, srcStride, width, height );
+  }
+
+  // the filter responses need 32 bits, a row sum of a lane fits unsigned 32 bits
+  uint64_t sum = 0;
+  for( int y = 0; y < height; y++ )
+  {
+    const Pel* a = src - srcStride;
+    const Pel* c = src;
+    const Pel* b = src + srcStride;
+    int x = 0;
+#ifdef USE_AVX2
+    if( vext >= AVX2 && width >= 8 )
+    {
+      __m256i vsum = _mm256_setzero_si256();
+      for( ; x + 8 <= width; x += 8 )
+      {
+#define LOAD8( p ) _mm256_cvtepi16_epi32( _mm_loadu_si128( ( const __m128i* ) ( p ) ) )
+        const __m256i vc     = LOAD8( c + x );
+        const __m256i vcross = _mm256_add_epi32( _mm256_add_epi32( LOAD8( c + x - 1 ), LOAD8( c + x + 1 ) ), _mm256_add_epi32( LOAD8( a + x ), LOAD8( b + x ) ) );
+        const __m256i vdiag  = _mm256_add_epi32( _mm256_add_epi32( LOAD8( a + x - 1 ), LOAD8( a + x + 1 ) ), _mm256_add_epi32( LOAD8( b + x - 1 ), LOAD8( b + x + 1 ) ) );
+#undef LOAD8
+        const __m256i vf     = _mm256_sub_epi32( _mm256_add_epi32( _mm256_slli_epi32( vc, 3 ), _mm256_slli_epi32( vc, 2 ) ), _mm256_add_epi32( _mm256_slli_epi32( vcross, 1 ), vdiag ) );
+        vsum = _mm256_add_epi32( vsum, _mm256_abs_epi32( vf ) );
+      }
+      const __m256i vzero = _mm256_setzero_si256();
+      const __m256i vsum64 = _mm256_add_epi64( _mm256_unpacklo_epi32( vsum, vzero ), _mm256_unpackhi_epi32( vsum, vzero ) );
+      const __m128i vsum128 = _mm_add_epi64( _mm256_castsi256_si128( vsum64 ), _mm256_extracti128_si256( vsum64, 1 ) );
+      sum += uint64_t( _mm_cvtsi128_si64( vsum128 ) ) + uint64_t( _mm_extract_epi64( vsum128, 1 ) );
+    }
+#endif
+    __m128i vsum = _mm_setzero_si128();
+    for( ; x + 4 <= width; x += 4 )
+    {
+#define LOAD4( p ) _mm_cvtepi16_epi32( _mm_loadl_epi64( ( const __m128i* ) ( p ) ) )
+      const __m128i vc     = LOAD4( c + x );
+      const __m128i vcross = _mm_add_epi32( _mm_add_epi32( LOAD4( c + x - 1 ), LOAD4( c + x + 1 ) ), _mm_add_epi32( LOAD4( a + x ), LOAD4( b + x ) ) );
+      const __m128i vdiag  = _mm_add_epi32( _mm_add_epi32( LOAD4( a + x - 1 ), LOAD4( a + x + 1 ) ), _mm_add_epi32( LOAD4( b + x - 1 ), LOAD4( b + x + 1 ) ) );
+#undef LOAD4
+      const __m128i vf     = _mm_sub_epi32( _mm_add_epi32( _mm_slli_epi32( vc, 3 ), _mm_slli_epi32( vc, 2 ) ), _mm_add_epi32( _mm_slli_epi32( vcross, 1 ), vdiag ) );
+      vsum = _mm_add_epi32( vsum, _mm_abs_epi32( vf ) );
+    }
+    const __m128i vzero = _mm_setzero_si128();
+    const __m128i vsum64 = _mm_add_epi64( _mm_unpacklo_epi32( vsum, vzero ), _mm_unpackhi_epi32( vsum, vzero ) );
+    sum += uint64_t( _mm_cvtsi128_si64( vsum64 ) ) + uint64_t( _mm_extract_epi64( vsum64, 1 ) );
+    for( ; x < width; x++ )
+    {
+      const int f = 12 * (int)c[x] - 2 * ((int)c[x-1] + (int)c[x+1] + (int)a[x] + (int)b[x])
+                       - (int)a[x-1] - (int)a[x+1] - (int)b[x-1] - (int)b[x+1];
+      sum += abs( f );
+    }
+    src += srcStride;
+  }
+  return sum;
+}
+
 template<X86_VEXT vext>
 void PelBufferOps::_initPelBufOpsX86()
 {
@@ -1074,6 +1193,8 @@ void PelBufferOps::_initPelBufOpsX86()
   profGradFilter = gradFilter_SSE<vext, false>;
   applyPROF      = applyPROF_SSE<vext>;
   roundIntVector = roundIntVector_SIMD<vext>;
+  calcSSE        = calcSSE_SIMD<vext>;
+  calcHPActivity = calcHPActivity_SIMD<vext>;
 }
 
 template void PelBufferOps::_initPelBufOpsX86<SIMDX86>();
@@ -0,0 +1,168 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2020, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/** \file     DepQuantX86.h
+    \brief    SIMD version of the rate-distortion decisions of the dependent quantization trellis
+*/
+
+//! \ingroup CommonLib
+//! \{
+
+#include "CommonDefX86.h"
+#include "../DepQuant.h"
+
+#if ENABLE_SIMD_OPT_DEPQUANT
+#ifdef TARGET_SIMD_X86
+
+#ifdef USE_AVX2
+/** Evaluates the transitions of the four trellis states with 4x64-bit rd-costs.
+*  The candidates of all four decisions are tested in the same order as in checkRdCostsCore (strict less-than),
+*  so that the selected paths are identical.
+*/
+template<X86_VEXT vext>
+void checkRdCosts_SIMD( const DQIntern::StateMem& prevStates, const DQIntern::ScanPosType spt, const DQIntern::PQData* pqData, DQIntern::Decision* decisions )
+{
+  // levels per state: states 0 and 1 use the quantization indexes (A,B) = (0,2), states 2 and 3 use (3,1)
+  const __m128i vlevA   = _mm_setr_epi32( pqData[0].absLevel, pqData[0].absLevel, pqData[3].absLevel, pqData[3].absLevel );
+  const __m128i vlevB   = _mm_setr_epi32( pqData[2].absLevel, pqData[2].absLevel, pqData[1].absLevel, pqData[1].absLevel );
+  const __m256i vdistA  = _mm256_setr_epi64x( pqData[0].deltaDist, pqData[0].deltaDist, pqData[3].deltaDist, pqData[3].deltaDist );
+  const __m256i vdistB  = _mm256_setr_epi64x( pqData[2].deltaDist, pqData[2].deltaDist, pqData[1].deltaDist, pqData[1].deltaDist );
+
+  const __m128i vlane   = _mm_setr_epi32( 0, 1, 2, 3 );
+  const __m128i vone    = _mm_set1_epi32( 1 );
+  const __m128i vthree  = _mm_set1_epi32( 3 );
+  const __m128i vfour   = _mm_set1_epi32( 4 );
+  const __m128i vrmax   = _mm_set1_epi32( sizeof( DQIntern::g_goRiceBits[0] ) / sizeof( int32_t ) - 1 );
+
+  const __m128i vregBin = _mm_cmpgt_epi32( _mm_loadu_si128( ( const __m128i* ) prevStates.remRegBins ), vthree );
+  const __m128i vrice   = _mm_slli_epi32( _mm_cvtepi8_epi32( _mm_cvtsi32_si128( *( const int32_t* ) prevStates.goRicePar  ) ), 5 );
+  const __m128i vrZero  = _mm_cvtepi8_epi32( _mm_cvtsi32_si128( *( const int32_t* ) prevStates.goRiceZero ) );
+  const __m128i vsig0   = _mm_loadu_si128( ( const __m128i* ) prevStates.sigFracBits[0] );
+  const __m128i vsig1   = _mm_loadu_si128( ( const __m128i* ) prevStates.sigFracBits[1] );
+  const int32_t* goRice = &DQIntern::g_goRiceBits[0][0];
+
+  // rates for the regular coded bins
+  __m128i vidxA   = _mm_min_epi32( vlevA, _mm_add_epi32( vfour, _mm_and_si128( vlevA, vone ) ) );
+  __m128i vidxB   = _mm_min_epi32( vlevB, _mm_add_epi32( vfour, _mm_and_si128( vlevB, vone ) ) );
+  __m128i vrateA  = _mm_i32gather_epi32( &prevStates.coeffFracBits[0][0], _mm_add_epi32( _mm_slli_epi32( vidxA, 2 ), vlane ), 4 );
+  __m128i vrateB  = _mm_i32gather_epi32( &prevStates.coeffFracBits[0][0], _mm_add_epi32( _mm_slli_epi32( vidxB, 2 ), vlane ), 4 );
+  __m128i vvalA   = _mm_min_epi32( vrmax, _mm_max_epi32( _mm_setzero_si128(), _mm_srai_epi32( _mm_sub_epi32( vlevA, vfour ), 1 ) ) );
+  __m128i vvalB   = _mm_min_epi32( vrmax, _mm_max_epi32( _mm_setzero_si128(), _mm_srai_epi32( _mm_sub_epi32( vlevB, vfour ), 1 ) ) );
+  vrateA          = _mm_add_epi32( vrateA, _mm_and_si128( _mm_cmpgt_epi32( vlevA, vthree ), _mm_i32gather_epi32( goRice, _mm_add_epi32( vrice, vvalA ), 4 ) ) );
+  vrateB          = _mm_add_epi32( vrateB, _mm_and_si128( _mm_cmpgt_epi32( vlevB, vthree ), _mm_i32gather_epi32( goRice, _mm_add_epi32( vrice, vvalB ), 4 ) ) );
+  __m128i vrateZ  = vsig0;
+  __m128i vvalidZ = _mm_set1_epi32( -1 );
+
+  if( spt == DQIntern::SCAN_ISCSBB )
+  {
+    vrateA = _mm_add_epi32( vrateA, vsig1 );
+    vrateB = _mm_add_epi32( vrateB, vsig1 );
+  }
+  else if( spt == DQIntern::SCAN_SOCSBB )
+  {
+    const __m128i vsbb1 = _mm_loadu_si128( ( const __m128i* ) prevStates.sbbFracBits[1] );
+    vrateA = _mm_add_epi32( vrateA, _mm_add_epi32( vsbb1, vsig1 ) );
+    vrateB = _mm_add_epi32( vrateB, _mm_add_epi32( vsbb1, vsig1 ) );
+    vrateZ = _mm_add_epi32( vrateZ, vsbb1 );
+  }
+  else
+  {
+    const __m128i vsig = _mm_xor_si128( _mm_cmpeq_epi32( _mm_cvtepi8_epi32( _mm_cvtsi32_si128( *( const int32_t* ) prevStates.numSigSbb ) ), _mm_setzero_si128() ), vvalidZ );
+    vrateA  = _mm_add_epi32( vrateA, _mm_and_si128( vsig, vsig1 ) );
+    vrateB  = _mm_add_epi32( vrateB, _mm_and_si128( vsig, vsig1 ) );
+    vrateZ  = _mm_and_si128( vsig, vsig0 );
+    vvalidZ = vsig;
+  }
+
+  // rates for the bypass coded levels
+  {
+    const __m128i vbase   = _mm_set1_epi32( 1 << SCALE_BITS );
+    const __m128i vbidxA  = _mm_blendv_epi8( _mm_min_epi32( vlevA, vrmax ), _mm_sub_epi32( vlevA, vone ), _mm_xor_si128( _mm_cmpgt_epi32( vlevA, vrZero ), _mm_set1_epi32( -1 ) ) );
+    const __m128i vbidxB  = _mm_blendv_epi8( _mm_min_epi32( vlevB, vrmax ), _mm_sub_epi32( vlevB, vone ), _mm_xor_si128( _mm_cmpgt_epi32( vlevB, vrZero ), _mm_set1_epi32( -1 ) ) );
+    const __m128i vbrateA = _mm_add_epi32( vbase, _mm_i32gather_epi32( goRice, _mm_add_epi32( vrice, vbidxA ), 4 ) );
+    const __m128i vbrateB = _mm_add_epi32( vbase, _mm_i32gather_epi32( goRice, _mm_add_epi32( vrice, vbidxB ), 4 ) );
+    const __m128i vbrateZ = _mm_i32gather_epi32( goRice, _mm_add_epi32( vrice, vrZero ), 4 );
+
+    vrateA  = _mm_blendv_epi8( vbrateA, vrateA, vregBin );
+    vrateB  = _mm_blendv_epi8( vbrateB, vrateB, vregBin );
+    vrateZ  = _mm_blendv_epi8( vbrateZ, vrateZ, vregBin );
+    vvalidZ = _mm_or_si128( vvalidZ, _mm_xor_si128( vregBin, _mm_set1_epi32( -1 ) ) );
+  }
+
+  // rd-costs per state
+  const __m256i vcost   = _mm256_loadu_si256( ( const __m256i* ) prevStates.rdCost );
+  const __m256i vcostA  = _mm256_add_epi64( _mm256_add_epi64( vcost, vdistA ), _mm256_cvtepi32_epi64( vrateA ) );
+  const __m256i vcostB  = _mm256_add_epi64( _mm256_add_epi64( vcost, vdistB ), _mm256_cvtepi32_epi64( vrateB ) );
+  const __m256i vcostZ  = _mm256_blendv_epi8( _mm256_set1_epi64x( std::numeric_limits<int64_t>::max() ), _mm256_add_epi64( vcost, _mm256_cvtepi32_epi64( vrateZ ) ), _mm256_cvtepi32_epi64( vvalidZ ) );
+
+  // current decisions, the (absLevel, prevId) pair of a decision is handled as one 64-bit value
+  const __m256i vdec01  = _mm256_loadu_si256( ( const __m256i* ) &decisions[0] );
+  const __m256i vdec23  = _mm256_loadu_si256( ( const __m256i* ) &decisions[2] );
+  const __m256i vlo     = _mm256_permute2x128_si256( vdec01, vdec23, 0x20 );
+  const __m256i vhi     = _mm256_permute2x128_si256( vdec01, vdec23, 0x31 );
+  __m256i       vbest   = _mm256_unpacklo_epi64( vlo, vhi );
+  __m256i       vinfo   = _mm256_unpackhi_epi64( vlo, vhi );
+
+#define CHECK_CAND(cost,info) { const __m256i vcand = cost; const __m256i vmask = _mm256_cmpgt_epi64( vbest, vcand ); vbest = _mm256_blendv_epi8( vbest, vcand, vmask ); vinfo = _mm256_blendv_epi8( vinfo, info, vmask ); }
+  // decision 0: A0, Z0, B1 | decision 1: A2, Z2, B3 | decision 2: B0, A1, Z1 | decision 3: B2, A3, Z3
+  CHECK_CAND( _mm256_blend_epi32( _mm256_permute4x64_epi64( vcostA, 0x88 ), _mm256_permute4x64_epi64( vcostB, 0x88 ), 0xF0 ),
+              _mm256_setr_epi32( pqData[0].absLevel, 0, pqData[3].absLevel, 2, pqData[2].absLevel, 0, pqData[1].absLevel, 2 ) );
+  CHECK_CAND( _mm256_blend_epi32( _mm256_permute4x64_epi64( vcostZ, 0xD8 ), _mm256_permute4x64_epi64( vcostA, 0xD8 ), 0xF0 ),
+              _mm256_setr_epi32( 0, 0, 0, 2, pqData[0].absLevel, 1, pqData[3].absLevel, 3 ) );
+  CHECK_CAND( _mm256_blend_epi32( _mm256_permute4x64_epi64( vcostB, 0xDD ), _mm256_permute4x64_epi64( vcostZ, 0xDD ), 0xF0 ),
+              _mm256_setr_epi32( pqData[2].absLevel, 1, pqData[1].absLevel, 3, 0, 1, 0, 3 ) );
+#undef CHECK_CAND
+
+  const __m256i vres02 = _mm256_unpacklo_epi64( vbest, vinfo );
+  const __m256i vres13 = _mm256_unpackhi_epi64( vbest, vinfo );
+  _mm256_storeu_si256( ( __m256i* ) &decisions[0], _mm256_permute2x128_si256( vres02, vres13, 0x20 ) );
+  _mm256_storeu_si256( ( __m256i* ) &decisions[2], _mm256_permute2x128_si256( vres02, vres13, 0x31 ) );
+}
+#endif
+
+template<X86_VEXT vext>
+void DepQuant::_initDepQuantX86()
+{
+#ifdef USE_AVX2
+  // the 64-bit comparisons require AVX2
+  m_checkRdCosts = checkRdCosts_SIMD<vext>;
+#endif
+}
+
+template void DepQuant::_initDepQuantX86<SIMDX86>();
+
+#endif //#ifdef TARGET_SIMD_X86
+#endif
+
+//! \}
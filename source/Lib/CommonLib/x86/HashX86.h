@@ -0,0 +1,76 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2020, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/**
+ * \file
+ * \brief Implementation of the CRC32C block hashes of the TComHash class
+ */
+
+#include "CommonDefX86.h"
+#include "../Hash.h"
+
+#if ENABLE_SIMD_OPT_HASH
+#ifdef TARGET_SIMD_X86
+
+#include <nmmintrin.h>
+
+template<X86_VEXT vext>
+static uint32_t simdCalcCRC32C(const unsigned char* p, int length)
+{
+  uint32_t crc = 0;
+  int i = 0;
+  for (; i + 4 <= length; i += 4)
+  {
+    uint32_t word;
+    memcpy(&word, p + i, sizeof(word));
+    crc = _mm_crc32_u32(crc, word);
+  }
+  for (; i < length; i++)
+  {
+    crc = _mm_crc32_u8(crc, p[i]);
+  }
+  return crc;
+}
+
+template <X86_VEXT vext>
+void TComHash::_initTComHashX86()
+{
+  m_calcCRC32C = simdCalcCRC32C<vext>;
+}
+
+template void TComHash::_initTComHashX86<SIMDX86>();
+
+#endif //#ifdef TARGET_SIMD_X86
+#endif
+//! \}
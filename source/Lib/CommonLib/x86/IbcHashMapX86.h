@@ -39,6 +39,7 @@
 #include "CommonDefX86.h"
 #include "../IbcHashMap.h"
 
+#if ENABLE_SIMD_OPT_IBC
 #ifdef TARGET_SIMD_X86
 
 #include <nmmintrin.h>
@@ -49,14 +50,56 @@ static uint32_t simdComputeCrc32c16bit(uint32_t crc, const Pel pel)
   return _mm_crc32_u16(crc, pel);
 }
 
+// a row of four samples is hashed with one 64-bit crc32, same result as four 16-bit steps
+template<X86_VEXT vext>
+static uint32_t simdCalcBlockHash(const Pel* pel, const int stride, const int width, const int height, uint32_t crc)
+{
+#if defined( __x86_64__ ) || defined( _M_X64 )
+  if (width == 4)
+  {
+    uint64_t crc64 = crc;
+    for (int y = 0; y < height; y++)
+    {
+      uint64_t row;
+      memcpy(&row, pel, sizeof(row));
+      crc64 = _mm_crc32_u64(crc64, row);
+      pel += stride;
+    }
+    return (uint32_t)crc64;
+  }
+#endif
+  if (width == 2)
+  {
+    for (int y = 0; y < height; y++)
+    {
+      uint32_t row;
+      memcpy(&row, pel, sizeof(row));
+      crc = _mm_crc32_u32(crc, row);
+      pel += stride;
+    }
+    return crc;
+  }
+  for (int y = 0; y < height; y++)
+  {
+    for (int x = 0; x < width; x++)
+    {
+      crc = _mm_crc32_u16(crc, pel[x]);
+    }
+    pel += stride;
+  }
+  return crc;
+}
+
 template <X86_VEXT vext>
 void IbcHashMap::_initIbcHashMapX86()
 {
   m_computeCrc32c = simdComputeCrc32c16bit<vext>;
+  m_calcBlockHash = simdCalcBlockHash<vext>;
 }
 
 template void IbcHashMap::_initIbcHashMapX86<SIMDX86>();
 
 
 #endif //#ifdef TARGET_SIMD_X86
+#endif
 //! \}
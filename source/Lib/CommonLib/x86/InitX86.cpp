@@ -48,7 +48,11 @@
 
 #include "CommonLib/AdaptiveLoopFilter.h"
 
+#include "CommonLib/IntraPrediction.h"
+
 #include "CommonLib/IbcHashMap.h"
+#include "CommonLib/Hash.h"
+#include "CommonLib/BitStream.h"
 
 #ifdef TARGET_SIMD_X86
 
@@ -167,6 +171,161 @@ void AdaptiveLoopFilter::initAdaptiveLoopFilterX86()
 }
 #endif
 
+#if ENABLE_SIMD_OPT_TRAFO
+void TrQuant::initTrQuantX86()
+{
+  auto vext = read_x86_extension_flags();
+  switch ( vext )
+  {
+  case AVX512:
+  case AVX2:
+    _initTrQuantX86<AVX2>();
+    break;
+  case AVX:
+    _initTrQuantX86<AVX>();
+    break;
+  case SSE42:
+  case SSE41:
+    _initTrQuantX86<SSE41>();
+    break;
+  default:
+    break;
+  }
+}
+#endif
+
+#if ENABLE_SIMD_OPT_DEPQUANT
+void DepQuant::initDepQuantX86()
+{
+  auto vext = read_x86_extension_flags();
+  switch ( vext )
+  {
+  case AVX512:
+  case AVX2:
+    _initDepQuantX86<AVX2>();
+    break;
+  case AVX:
+    _initDepQuantX86<AVX>();
+    break;
+  case SSE42:
+  case SSE41:
+    _initDepQuantX86<SSE41>();
+    break;
+  default:
+    break;
+  }
+}
+#endif
+
+#if ENABLE_SIMD_OPT_QUANT
+void Quant::initQuantX86()
+{
+  auto vext = read_x86_extension_flags();
+  switch ( vext )
+  {
+  case AVX512:
+  case AVX2:
+    _initQuantX86<AVX2>();
+    break;
+  case AVX:
+    _initQuantX86<AVX>();
+    break;
+  case SSE42:
+  case SSE41:
+    _initQuantX86<SSE41>();
+    break;
+  default:
+    break;
+  }
+}
+#endif
+
+#if ENABLE_SIMD_OPT_INTRAPRED
+void IntraPrediction::initIntraPredictionX86()
+{
+  auto vext = read_x86_extension_flags();
+  switch ( vext )
+  {
+  case AVX512:
+  case AVX2:
+    _initIntraPredictionX86<AVX2>();
+    break;
+  case AVX:
+    _initIntraPredictionX86<AVX>();
+    break;
+  case SSE42:
+  case SSE41:
+    _initIntraPredictionX86<SSE41>();
+    break;
+  default:
+    break;
+  }
+}
+#endif
+
+#if ENABLE_SIMD_OPT_MIP
+void MatrixIntraPrediction::initMatrixIntraPredictionX86()
+{
+  auto vext = read_x86_extension_flags();
+  switch ( vext )
+  {
+  case AVX512:
+  case AVX2:
+    _initMatrixIntraPredictionX86<AVX2>();
+    break;
+  case AVX:
+    _initMatrixIntraPredictionX86<AVX>();
+    break;
+  case SSE42:
+  case SSE41:
+    _initMatrixIntraPredictionX86<SSE41>();
+    break;
+  default:
+    break;
+  }
+}
+#endif
+
+#if ENABLE_SIMD_OPT_HASH
+void TComHash::initTComHashX86()
+{
+  auto vext = read_x86_extension_flags();
+  switch (vext)
+  {
+  case AVX512:
+  case AVX2:
+  case AVX:
+  case SSE42:
+    _initTComHashX86<SSE42>();
+    break;
+  case SSE41:
+  default:
+    break;
+  }
+}
+#endif
+
+#if ENABLE_SIMD_OPT_BITSTREAM
+void BitstreamOps::initBitstreamOpsX86()
+{
+  auto vext = read_x86_extension_flags();
+  switch (vext)
+  {
+  case AVX512:
+  case AVX2:
+    _initBitstreamOpsX86<AVX2>();
+    break;
+  case AVX:
+  case SSE42:
+  case SSE41:
+    _initBitstreamOpsX86<SSE41>();
+    break;
+  default:
+    break;
+  }
+}
+#endif
+
 #if ENABLE_SIMD_OPT_IBC
 void IbcHashMap::initIbcHashMapX86()
 {
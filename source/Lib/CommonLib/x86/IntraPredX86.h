@@ -0,0 +1,351 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2020, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/** \file     IntraPredX86.h
+    \brief    SIMD version of the angular, planar and position dependent intra prediction
+*/
+
+//! \ingroup CommonLib
+//! \{
+
+#include "CommonDefX86.h"
+#include "../IntraPrediction.h"
+#include "../InterpolationFilter.h"
+
+#if ENABLE_SIMD_OPT_INTRAPRED
+#ifdef TARGET_SIMD_X86
+
+template<X86_VEXT vext>
+void IntraPrediction::xPredIntraAngLuma_SIMD( Pel* pDst, const ptrdiff_t dstStride, const Pel* refMain, const int width, const int height, int deltaPos, const int intraPredAngle, const bool useCubicFilter, const ClpRng& clpRng )
+{
+  if( width & 3 )
+  {
+    xPredIntraAngLumaCore( pDst, dstStride, refMain, width, height, deltaPos, intraPredAngle, useCubicFilter, clpRng );
+    return;
+  }
+
+  const __m128i vmin    = _mm_set1_epi16( clpRng.min );
+  const __m128i vmax    = _mm_set1_epi16( clpRng.max );
+  const __m128i voffset = _mm_set1_epi32( 32 );
+#ifdef USE_AVX2
+  const __m256i vmin256    = _mm256_set1_epi16( clpRng.min );
+  const __m256i vmax256    = _mm256_set1_epi16( clpRng.max );
+  const __m256i voffset256 = _mm256_set1_epi32( 32 );
+#endif
+
+  for( int y = 0; y < height; y++, deltaPos += intraPredAngle, pDst += dstStride )
+  {
+    const int deltaInt   = deltaPos >> 5;
+    const int deltaFract = deltaPos & 31;
+
+    const TFilterCoeff  intraSmoothingFilter[4] = { TFilterCoeff( 16 - ( deltaFract >> 1 ) ), TFilterCoeff( 32 - ( deltaFract >> 1 ) ), TFilterCoeff( 16 + ( deltaFract >> 1 ) ), TFilterCoeff( deltaFract >> 1 ) };
+    const TFilterCoeff* f                       = useCubicFilter ? InterpolationFilter::getChromaFilterTable( deltaFract ) : intraSmoothingFilter;
+
+    // coefficient pairs for the interleaved samples (p0,p1) and (p2,p3)
+    const int f01 = int( uint16_t( f[0] ) | ( uint32_t( uint16_t( f[1] ) ) << 16 ) );
+    const int f23 = int( uint16_t( f[2] ) | ( uint32_t( uint16_t( f[3] ) ) << 16 ) );
+
+    const Pel* ref = refMain + deltaInt;
+    int x = 0;
+#ifdef USE_AVX2
+    if( vext >= AVX2 )
+    {
+      const __m256i vf01 = _mm256_set1_epi32( f01 );
+      const __m256i vf23 = _mm256_set1_epi32( f23 );
+      for( ; x + 16 <= width; x += 16 )
+      {
+        const __m256i vp0 = _mm256_loadu_si256( ( const __m256i* ) &ref[x + 0] );
+        const __m256i vp1 = _mm256_loadu_si256( ( const __m256i* ) &ref[x + 1] );
+        const __m256i vp2 = _mm256_loadu_si256( ( const __m256i* ) &ref[x + 2] );
+        const __m256i vp3 = _mm256_loadu_si256( ( const __m256i* ) &ref[x + 3] );
+
+        // the lane-wise unpacking and packing cancel out, the samples stay in order
+        __m256i vlo = _mm256_add_epi32( _mm256_madd_epi16( _mm256_unpacklo_epi16( vp0, vp1 ), vf01 ), _mm256_madd_epi16( _mm256_unpacklo_epi16( vp2, vp3 ), vf23 ) );
+        __m256i vhi = _mm256_add_epi32( _mm256_madd_epi16( _mm256_unpackhi_epi16( vp0, vp1 ), vf01 ), _mm256_madd_epi16( _mm256_unpackhi_epi16( vp2, vp3 ), vf23 ) );
+        vlo = _mm256_srai_epi32( _mm256_add_epi32( vlo, voffset256 ), 6 );
+        vhi = _mm256_srai_epi32( _mm256_add_epi32( vhi, voffset256 ), 6 );
+
+        const __m256i vres = _mm256_min_epi16( vmax256, _mm256_max_epi16( vmin256, _mm256_packs_epi32( vlo, vhi ) ) );
+        _mm256_storeu_si256( ( __m256i* ) &pDst[x], vres );
+      }
+    }
+#endif
+    const __m128i vf01 = _mm_set1_epi32( f01 );
+    const __m128i vf23 = _mm_set1_epi32( f23 );
+    for( ; x + 8 <= width; x += 8 )
+    {
+      const __m128i vp0 = _mm_loadu_si128( ( const __m128i* ) &ref[x + 0] );
+      const __m128i vp1 = _mm_loadu_si128( ( const __m128i* ) &ref[x + 1] );
+      const __m128i vp2 = _mm_loadu_si128( ( const __m128i* ) &ref[x + 2] );
+      const __m128i vp3 = _mm_loadu_si128( ( const __m128i* ) &ref[x + 3] );
+
+      __m128i vlo = _mm_add_epi32( _mm_madd_epi16( _mm_unpacklo_epi16( vp0, vp1 ), vf01 ), _mm_madd_epi16( _mm_unpacklo_epi16( vp2, vp3 ), vf23 ) );
+      __m128i vhi = _mm_add_epi32( _mm_madd_epi16( _mm_unpackhi_epi16( vp0, vp1 ), vf01 ), _mm_madd_epi16( _mm_unpackhi_epi16( vp2, vp3 ), vf23 ) );
+      vlo = _mm_srai_epi32( _mm_add_epi32( vlo, voffset ), 6 );
+      vhi = _mm_srai_epi32( _mm_add_epi32( vhi, voffset ), 6 );
+
+      const __m128i vres = _mm_min_epi16( vmax, _mm_max_epi16( vmin, _mm_packs_epi32( vlo, vhi ) ) );
+      _mm_storeu_si128( ( __m128i* ) &pDst[x], vres );
+    }
+    if( x < width )
+    {
+      const __m128i vp0 = _mm_loadl_epi64( ( const __m128i* ) &ref[x + 0] );
+      const __m128i vp1 = _mm_loadl_epi64( ( const __m128i* ) &ref[x + 1] );
+      const __m128i vp2 = _mm_loadl_epi64( ( const __m128i* ) &ref[x + 2] );
+      const __m128i vp3 = _mm_loadl_epi64( ( const __m128i* ) &ref[x + 3] );
+
+      __m128i vsum = _mm_add_epi32( _mm_madd_epi16( _mm_unpacklo_epi16( vp0, vp1 ), vf01 ), _mm_madd_epi16( _mm_unpacklo_epi16( vp2, vp3 ), vf23 ) );
+      vsum = _mm_srai_epi32( _mm_add_epi32( vsum, voffset ), 6 );
+
+      const __m128i vres = _mm_min_epi16( vmax, _mm_max_epi16( vmin, _mm_packs_epi32( vsum, vsum ) ) );
+      _mm_storel_epi64( ( __m128i* ) &pDst[x], vres );
+    }
+  }
+}
+
+template<X86_VEXT vext>
+void IntraPrediction::xPredIntraAngChroma_SIMD( Pel* pDst, const ptrdiff_t dstStride, const Pel* refMain, const int width, const int height, int deltaPos, const int intraPredAngle )
+{
+  if( width & 3 )
+  {
+    xPredIntraAngChromaCore( pDst, dstStride, refMain, width, height, deltaPos, intraPredAngle );
+    return;
+  }
+
+  // p0 + ( ( f * ( p1 - p0 ) + 16 ) >> 5 ) is evaluated as ( ( 32 - f ) * p0 + f * p1 + 16 ) >> 5
+  const __m128i voffset = _mm_set1_epi32( 16 );
+
+  for( int y = 0; y < height; y++, deltaPos += intraPredAngle, pDst += dstStride )
+  {
+    const int deltaInt   = deltaPos >> 5;
+    const int deltaFract = deltaPos & 31;
+    const int f01        = ( 32 - deltaFract ) | ( deltaFract << 16 );
+
+    const Pel* ref = refMain + deltaInt + 1;
+    int x = 0;
+#ifdef USE_AVX2
+    if( vext >= AVX2 )
+    {
+      const __m256i vf01       = _mm256_set1_epi32( f01 );
+      const __m256i voffset256 = _mm256_set1_epi32( 16 );
+      for( ; x + 16 <= width; x += 16 )
+      {
+        const __m256i vp0 = _mm256_loadu_si256( ( const __m256i* ) &ref[x + 0] );
+        const __m256i vp1 = _mm256_loadu_si256( ( const __m256i* ) &ref[x + 1] );
+
+        const __m256i vlo = _mm256_srai_epi32( _mm256_add_epi32( _mm256_madd_epi16( _mm256_unpacklo_epi16( vp0, vp1 ), vf01 ), voffset256 ), 5 );
+        const __m256i vhi = _mm256_srai_epi32( _mm256_add_epi32( _mm256_madd_epi16( _mm256_unpackhi_epi16( vp0, vp1 ), vf01 ), voffset256 ), 5 );
+        _mm256_storeu_si256( ( __m256i* ) &pDst[x], _mm256_packs_epi32( vlo, vhi ) );
+      }
+    }
+#endif
+    const __m128i vf01 = _mm_set1_epi32( f01 );
+    for( ; x + 8 <= width; x += 8 )
+    {
+      const __m128i vp0 = _mm_loadu_si128( ( const __m128i* ) &ref[x + 0] );
+      const __m128i vp1 = _mm_loadu_si128( ( const __m128i* ) &ref[x + 1] );
+
+      const __m128i vlo = _mm_srai_epi32( _mm_add_epi32( _mm_madd_epi16( _mm_unpacklo_epi16( vp0, vp1 ), vf01 ), voffset ), 5 );
+      const __m128i vhi = _mm_srai_epi32( _mm_add_epi32( _mm_madd_epi16( _mm_unpackhi_epi16( vp0, vp1 ), vf01 ), voffset ), 5 );
+      _mm_storeu_si128( ( __m128i* ) &pDst[x], _mm_packs_epi32( vlo, vhi ) );
+    }
+    if( x < width )
+    {
+      const __m128i vp0 = _mm_loadl_epi64( ( const __m128i* ) &ref[x + 0] );
+      const __m128i vp1 = _mm_loadl_epi64( ( const __m128i* ) &ref[x + 1] );
+
+      const __m128i vsum = _mm_srai_epi32( _mm_add_epi32( _mm_madd_epi16( _mm_unpacklo_epi16( vp0, vp1 ), vf01 ), voffset ), 5 );
+      _mm_storel_epi64( ( __m128i* ) &pDst[x], _mm_packs_epi32( vsum, vsum ) );
+    }
+  }
+}
+
+template<X86_VEXT vext>
+void IntraPrediction::xPredIntraPlanar_SIMD( const CPelBuf &pSrc, PelBuf &pDst )
+{
+  const int width  = pDst.width;
+  const int height = pDst.height;
+
+  if( width & 3 )
+  {
+    xPredIntraPlanarCore( pSrc, pDst );
+    return;
+  }
+
+  const int log2W      = floorLog2( width );
+  const int log2H      = floorLog2( height );
+  const int finalShift = 1 + log2W + log2H;
+
+  // vertical predictor and its increment per row, horizontal predictor is (left << log2W) + (x + 1) * (topRight - left)
+  int vertPred[MAX_CU_SIZE], vertStep[MAX_CU_SIZE];
+
+  const int bottomLeft = pSrc.at( height + 1, 1 );
+  const int topRight   = pSrc.at( width  + 1, 0 );
+
+  for( int x = 0; x < width; x += 4 )
+  {
+    const __m128i vtop = _mm_cvtepi16_epi32( _mm_loadl_epi64( ( const __m128i* ) &pSrc.buf[x + 1] ) );
+    _mm_storeu_si128( ( __m128i* ) &vertPred[x], _mm_slli_epi32( vtop, log2H ) );
+    _mm_storeu_si128( ( __m128i* ) &vertStep[x], _mm_sub_epi32( _mm_set1_epi32( bottomLeft ), vtop ) );
+  }
+
+  const __m128i vshiftH = _mm_cvtsi32_si128( log2H );
+  const __m128i vshiftW = _mm_cvtsi32_si128( log2W );
+  const __m128i vshiftF = _mm_cvtsi32_si128( finalShift );
+  Pel*          pred    = pDst.buf;
+
+  for( int y = 0; y < height; y++, pred += pDst.stride )
+  {
+    const int left   = pSrc.at( y + 1, 1 );
+    const int horInc = topRight - left;
+    int x = 0;
+#ifdef USE_AVX2
+    if( vext >= AVX2 && ( width & 7 ) == 0 )
+    {
+      const __m256i voffset = _mm256_set1_epi32( 1 << ( log2W + log2H ) );
+      const __m256i vinc    = _mm256_set1_epi32( horInc << 3 );
+      __m256i       vhor    = _mm256_add_epi32( _mm256_set1_epi32( left << log2W ), _mm256_mullo_epi32( _mm256_set1_epi32( horInc ), _mm256_setr_epi32( 1, 2, 3, 4, 5, 6, 7, 8 ) ) );
+      for( ; x < width; x += 8 )
+      {
+        __m256i vvert = _mm256_add_epi32( _mm256_loadu_si256( ( const __m256i* ) &vertPred[x] ), _mm256_loadu_si256( ( const __m256i* ) &vertStep[x] ) );
+        _mm256_storeu_si256( ( __m256i* ) &vertPred[x], vvert );
+
+        __m256i vsum = _mm256_add_epi32( _mm256_sll_epi32( vhor, vshiftH ), _mm256_sll_epi32( vvert, vshiftW ) );
+        vsum         = _mm256_sra_epi32( _mm256_add_epi32( vsum, voffset ), vshiftF );
+        vsum         = _mm256_permute4x64_epi64( _mm256_packs_epi32( vsum, vsum ), 0x08 );
+        _mm_storeu_si128( ( __m128i* ) &pred[x], _mm256_castsi256_si128( vsum ) );
+
+        vhor = _mm256_add_epi32( vhor, vinc );
+      }
+    }
+#endif
+    const __m128i voffset = _mm_set1_epi32( 1 << ( log2W + log2H ) );
+    const __m128i vinc    = _mm_set1_epi32( horInc << 2 );
+    __m128i       vhor    = _mm_add_epi32( _mm_set1_epi32( ( left << log2W ) + x * horInc ), _mm_mullo_epi32( _mm_set1_epi32( horInc ), _mm_setr_epi32( 1, 2, 3, 4 ) ) );
+    for( ; x < width; x += 4 )
+    {
+      __m128i vvert = _mm_add_epi32( _mm_loadu_si128( ( const __m128i* ) &vertPred[x] ), _mm_loadu_si128( ( const __m128i* ) &vertStep[x] ) );
+      _mm_storeu_si128( ( __m128i* ) &vertPred[x], vvert );
+
+      __m128i vsum = _mm_add_epi32( _mm_sll_epi32( vhor, vshiftH ), _mm_sll_epi32( vvert, vshiftW ) );
+      vsum         = _mm_sra_epi32( _mm_add_epi32( vsum, voffset ), vshiftF );
+      _mm_storel_epi64( ( __m128i* ) &pred[x], _mm_packs_epi32( vsum, vsum ) );
+
+      vhor = _mm_add_epi32( vhor, vinc );
+    }
+  }
+}
+
+template<X86_VEXT vext>
+void IntraPrediction::xPredIntraSampleFilter_SIMD( const CPelBuf &pSrc, PelBuf &pDst )
+{
+  const int width  = pDst.width;
+  const int height = pDst.height;
+
+  if( width & 3 )
+  {
+    xPredIntraSampleFilterCore( pSrc, pDst );
+    return;
+  }
+
+  const int scale = ( ( floorLog2( width ) - 2 + floorLog2( height ) - 2 + 2 ) >> 2 );
+  CHECK( scale < 0 || scale > 31, "PDPC: scale < 0 || scale > 31" );
+
+  // the left weights vanish beyond xEnd, rows without top weight leave those samples unchanged
+  int wLeft[MAX_CU_SIZE];
+  int xEnd = 0;
+  for( int x = 0; x < width; x++ )
+  {
+    wLeft[x] = 32 >> std::min( 31, ( ( x << 1 ) >> scale ) );
+    xEnd     = wLeft[x] ? ( ( x + 4 ) & ~3 ) : xEnd;
+  }
+
+  const Pel*    top     = pSrc.buf + 1;
+  const __m128i voffset = _mm_set1_epi32( 32 );
+  Pel*          dst     = pDst.buf;
+
+  for( int y = 0; y < height; y++, dst += pDst.stride )
+  {
+    const int     wT    = 32 >> std::min( 31, ( ( y << 1 ) >> scale ) );
+    const int     xMax  = wT ? width : xEnd;
+    const __m128i vwT   = _mm_set1_epi32( wT );
+    const __m128i vleft = _mm_set1_epi32( pSrc.at( y + 1, 1 ) );
+    int x = 0;
+#ifdef USE_AVX2
+    if( vext >= AVX2 )
+    {
+      const __m256i vwT256     = _mm256_set1_epi32( wT );
+      const __m256i vleft256   = _mm256_set1_epi32( pSrc.at( y + 1, 1 ) );
+      const __m256i voffset256 = _mm256_set1_epi32( 32 );
+      for( ; x + 8 <= xMax; x += 8 )
+      {
+        const __m256i vval = _mm256_cvtepi16_epi32( _mm_loadu_si128( ( const __m128i* ) &dst[x] ) );
+        const __m256i vtop = _mm256_cvtepi16_epi32( _mm_loadu_si128( ( const __m128i* ) &top[x] ) );
+        const __m256i vwL  = _mm256_loadu_si256( ( const __m256i* ) &wLeft[x] );
+
+        __m256i vsum = _mm256_add_epi32( _mm256_mullo_epi32( vwL, _mm256_sub_epi32( vleft256, vval ) ), _mm256_mullo_epi32( vwT256, _mm256_sub_epi32( vtop, vval ) ) );
+        vsum         = _mm256_add_epi32( vval, _mm256_srai_epi32( _mm256_add_epi32( vsum, voffset256 ), 6 ) );
+        vsum         = _mm256_permute4x64_epi64( _mm256_packs_epi32( vsum, vsum ), 0x08 );
+        _mm_storeu_si128( ( __m128i* ) &dst[x], _mm256_castsi256_si128( vsum ) );
+      }
+    }
+#endif
+    for( ; x < xMax; x += 4 )
+    {
+      const __m128i vval = _mm_cvtepi16_epi32( _mm_loadl_epi64( ( const __m128i* ) &dst[x] ) );
+      const __m128i vtop = _mm_cvtepi16_epi32( _mm_loadl_epi64( ( const __m128i* ) &top[x] ) );
+      const __m128i vwL  = _mm_loadu_si128( ( const __m128i* ) &wLeft[x] );
+
+      __m128i vsum = _mm_add_epi32( _mm_mullo_epi32( vwL, _mm_sub_epi32( vleft, vval ) ), _mm_mullo_epi32( vwT, _mm_sub_epi32( vtop, vval ) ) );
+      vsum         = _mm_add_epi32( vval, _mm_srai_epi32( _mm_add_epi32( vsum, voffset ), 6 ) );
+      _mm_storel_epi64( ( __m128i* ) &dst[x], _mm_packs_epi32( vsum, vsum ) );
+    }
+  }
+}
+
+template<X86_VEXT vext>
+void IntraPrediction::_initIntraPredictionX86()
+{
+  m_intraPredAngLuma      = xPredIntraAngLuma_SIMD<vext>;
+  m_intraPredAngChroma    = xPredIntraAngChroma_SIMD<vext>;
+  m_intraPredPlanar       = xPredIntraPlanar_SIMD<vext>;
+  m_intraPredSampleFilter = xPredIntraSampleFilter_SIMD<vext>;
+}
+
+template void IntraPrediction::_initIntraPredictionX86<SIMDX86>();
+
+#endif //#ifdef TARGET_SIMD_X86
+#endif
+
+//! \}
@@ -0,0 +1,215 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2020, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/** \file     MatrixIntraPredX86.h
+    \brief    SIMD version of the matrix-vector product and the upsampling of the matrix-based intra prediction
+*/
+
+//! \ingroup CommonLib
+//! \{
+
+#include "CommonDefX86.h"
+#include "../MatrixIntraPrediction.h"
+
+#if ENABLE_SIMD_OPT_MIP
+#ifdef TARGET_SIMD_X86
+
+template<X86_VEXT vext>
+void MatrixIntraPrediction::computeReducedPred_SIMD( int* const result, const int* const input, const uint8_t* matrix, const int inputSize, const int outputSize,
+                                                     const bool redSize, const int offset, const int shift, const int inputOffset, const int bitDepth )
+{
+  const __m128i voffset    = _mm_set1_epi32( offset );
+  const __m128i vinpOffset = _mm_set1_epi32( inputOffset );
+  const __m128i vshift     = _mm_cvtsi32_si128( shift );
+  const __m128i vmax       = _mm_set1_epi32( ( 1 << bitDepth ) - 1 );
+  const __m128i vzero      = _mm_setzero_si128();
+
+  if( inputSize == 4 )
+  {
+    // the four inputs are duplicated, so that each register holds the weights of two outputs
+    const __m128i vinp = _mm_loadu_si128( ( const __m128i* ) input );
+    const __m128i vin  = _mm_packs_epi32( vinp, vinp );
+
+    for( int o = 0; o < outputSize; o += 4 )
+    {
+      const __m128i vw   = _mm_loadu_si128( ( const __m128i* ) &matrix[o * 4] );
+      const __m128i vs01 = _mm_madd_epi16( _mm_cvtepu8_epi16( vw ), vin );
+      const __m128i vs23 = _mm_madd_epi16( _mm_cvtepu8_epi16( _mm_unpackhi_epi64( vw, vw ) ), vin );
+
+      __m128i vsum = _mm_hadd_epi32( vs01, vs23 );
+      vsum         = _mm_add_epi32( _mm_sra_epi32( _mm_add_epi32( vsum, voffset ), vshift ), vinpOffset );
+      _mm_storeu_si128( ( __m128i* ) &result[o], _mm_min_epi32( vmax, _mm_max_epi32( vzero, vsum ) ) );
+    }
+  }
+  else
+  {
+    // the reduced matrix has no weights for the first input, its rows are one weight shorter
+    const int numCols = inputSize - ( redSize ? 1 : 0 );
+    int16_t   inp[8]  = { 0, 0, 0, 0, 0, 0, 0, 0 };
+    for( int k = 0; k < numCols; k++ )
+    {
+      inp[k] = int16_t( input[k + ( redSize ? 1 : 0 )] );
+    }
+    const __m128i vin = _mm_loadu_si128( ( const __m128i* ) inp );
+
+    for( int o = 0; o < outputSize; o += 4 )
+    {
+      __m128i vs[4];
+      for( int i = 0; i < 4; i++ )
+      {
+        const uint8_t* weight = &matrix[( o + i ) * numCols];
+        __m128i        vw;
+        if( numCols < 8 && o + i == outputSize - 1 )
+        {
+          // do not read beyond the end of the matrix
+          uint8_t lastRow[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+          memcpy( lastRow, weight, numCols );
+          vw = _mm_loadl_epi64( ( const __m128i* ) lastRow );
+        }
+        else
+        {
+          vw = _mm_loadl_epi64( ( const __m128i* ) weight );
+        }
+        vs[i] = _mm_madd_epi16( _mm_cvtepu8_epi16( vw ), vin );
+      }
+
+      __m128i vsum = _mm_hadd_epi32( _mm_hadd_epi32( vs[0], vs[1] ), _mm_hadd_epi32( vs[2], vs[3] ) );
+      vsum         = _mm_add_epi32( _mm_sra_epi32( _mm_add_epi32( vsum, voffset ), vshift ), vinpOffset );
+      _mm_storeu_si128( ( __m128i* ) &result[o], _mm_min_epi32( vmax, _mm_max_epi32( vzero, vsum ) ) );
+    }
+  }
+}
+
+template<X86_VEXT vext>
+void MatrixIntraPrediction::predictionUpsampling1D_SIMD( int* const dst, const int* const src, const int* const bndry,
+                                                         const SizeType srcSizeUpsmpDim, const SizeType srcSizeOrthDim,
+                                                         const SizeType srcStep, const SizeType srcStride,
+                                                         const SizeType dstStep, const SizeType dstStride,
+                                                         const SizeType bndryStep,
+                                                         const unsigned int upsmpFactor )
+{
+  // ( before * ( f - pos ) + behind * pos + r ) >> log2( f ) is evaluated as before + ( ( ( behind - before ) * pos + r ) >> log2( f ) )
+  const int     log2UpsmpFactor = floorLog2( upsmpFactor );
+  const __m128i vround          = _mm_set1_epi32( 1 << ( log2UpsmpFactor - 1 ) );
+  const __m128i vshift          = _mm_cvtsi32_si128( log2UpsmpFactor );
+
+  if( srcStride == 1 && dstStride == 1 && bndryStep == 1 && ( srcSizeOrthDim & 3 ) == 0 )
+  {
+    // vertical upsampling, the samples of a row are processed in parallel
+    SizeType x = 0;
+#ifdef USE_AVX2
+    if( vext >= AVX2 )
+    {
+      const __m256i vround256 = _mm256_set1_epi32( 1 << ( log2UpsmpFactor - 1 ) );
+      for( ; x + 8 <= srcSizeOrthDim; x += 8 )
+      {
+        __m256i vbefore = _mm256_loadu_si256( ( const __m256i* ) &bndry[x] );
+        int*    currDst = dst + x;
+        for( SizeType k = 0; k < srcSizeUpsmpDim; k++ )
+        {
+          const __m256i vbehind = _mm256_loadu_si256( ( const __m256i* ) &src[k * srcStep + x] );
+          const __m256i vdiff   = _mm256_sub_epi32( vbehind, vbefore );
+          __m256i       vdelta  = vround256;
+          for( unsigned pos = 1; pos <= upsmpFactor; pos++, currDst += dstStep )
+          {
+            vdelta = _mm256_add_epi32( vdelta, vdiff );
+            _mm256_storeu_si256( ( __m256i* ) currDst, _mm256_add_epi32( vbefore, _mm256_sra_epi32( vdelta, vshift ) ) );
+          }
+          vbefore = vbehind;
+        }
+      }
+    }
+#endif
+    for( ; x < srcSizeOrthDim; x += 4 )
+    {
+      __m128i vbefore = _mm_loadu_si128( ( const __m128i* ) &bndry[x] );
+      int*    currDst = dst + x;
+      for( SizeType k = 0; k < srcSizeUpsmpDim; k++ )
+      {
+        const __m128i vbehind = _mm_loadu_si128( ( const __m128i* ) &src[k * srcStep + x] );
+        const __m128i vdiff   = _mm_sub_epi32( vbehind, vbefore );
+        __m128i       vdelta  = vround;
+        for( unsigned pos = 1; pos <= upsmpFactor; pos++, currDst += dstStep )
+        {
+          vdelta = _mm_add_epi32( vdelta, vdiff );
+          _mm_storeu_si128( ( __m128i* ) currDst, _mm_add_epi32( vbefore, _mm_sra_epi32( vdelta, vshift ) ) );
+        }
+        vbefore = vbehind;
+      }
+    }
+  }
+  else if( srcStep == 1 && dstStep == 1 && upsmpFactor >= 4 )
+  {
+    // horizontal upsampling, the interpolated samples between two source samples are processed in parallel
+    const __m128i vpos0 = _mm_setr_epi32( 1, 2, 3, 4 );
+    for( SizeType y = 0; y < srcSizeOrthDim; y++ )
+    {
+      const int* srcLine = src + y * srcStride;
+      int*       currDst = dst + y * dstStride;
+      int        before  = bndry[y * bndryStep + bndryStep - 1];
+      for( SizeType k = 0; k < srcSizeUpsmpDim; k++ )
+      {
+        const int     behind   = srcLine[k];
+        const __m128i vbefore  = _mm_set1_epi32( before );
+        const __m128i vdiff    = _mm_set1_epi32( behind - before );
+        const __m128i vdiffInc = _mm_slli_epi32( vdiff, 2 );
+        __m128i       vdelta   = _mm_add_epi32( _mm_mullo_epi32( vdiff, vpos0 ), vround );
+        for( unsigned pos = 0; pos < upsmpFactor; pos += 4, currDst += 4 )
+        {
+          _mm_storeu_si128( ( __m128i* ) currDst, _mm_add_epi32( vbefore, _mm_sra_epi32( vdelta, vshift ) ) );
+          vdelta = _mm_add_epi32( vdelta, vdiffInc );
+        }
+        before = behind;
+      }
+    }
+  }
+  else
+  {
+    predictionUpsampling1DCore( dst, src, bndry, srcSizeUpsmpDim, srcSizeOrthDim, srcStep, srcStride, dstStep, dstStride, bndryStep, upsmpFactor );
+  }
+}
+
+template<X86_VEXT vext>
+void MatrixIntraPrediction::_initMatrixIntraPredictionX86()
+{
+  m_computeReducedPred     = computeReducedPred_SIMD<vext>;
+  m_predictionUpsampling1D = predictionUpsampling1D_SIMD<vext>;
+}
+
+template void MatrixIntraPrediction::_initMatrixIntraPredictionX86<SIMDX86>();
+
+#endif //#ifdef TARGET_SIMD_X86
+#endif
+
+//! \}
@@ -0,0 +1,91 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2020, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/** \file     QuantX86.h
+    \brief    SIMD version of the all-zero check of the quantizers
+*/
+
+//! \ingroup CommonLib
+//! \{
+
+#include "CommonDefX86.h"
+#include "../Quant.h"
+
+#if ENABLE_SIMD_OPT_QUANT
+#ifdef TARGET_SIMD_X86
+
+template<X86_VEXT vext>
+TCoeff maxAbsCoeff_SIMD( const TCoeff* src, const int numCoeff )
+{
+  int i = 0;
+  __m128i vmax = _mm_setzero_si128();
+
+#ifdef USE_AVX2
+  if( vext >= AVX2 && numCoeff >= 8 )
+  {
+    __m256i vmax256 = _mm256_setzero_si256();
+    for( ; i + 8 <= numCoeff; i += 8 )
+    {
+      vmax256 = _mm256_max_epi32( vmax256, _mm256_abs_epi32( _mm256_loadu_si256( ( const __m256i* ) &src[i] ) ) );
+    }
+    vmax = _mm_max_epi32( _mm256_castsi256_si128( vmax256 ), _mm256_extracti128_si256( vmax256, 1 ) );
+  }
+#endif
+  for( ; i + 4 <= numCoeff; i += 4 )
+  {
+    vmax = _mm_max_epi32( vmax, _mm_abs_epi32( _mm_loadu_si128( ( const __m128i* ) &src[i] ) ) );
+  }
+  vmax = _mm_max_epi32( vmax, _mm_shuffle_epi32( vmax, 0x4E ) );
+  vmax = _mm_max_epi32( vmax, _mm_shuffle_epi32( vmax, 0xB1 ) );
+
+  TCoeff maxAbs = _mm_cvtsi128_si32( vmax );
+  for( ; i < numCoeff; i++ )
+  {
+    maxAbs = std::max<TCoeff>( maxAbs, abs( src[i] ) );
+  }
+  return maxAbs;
+}
+
+template<X86_VEXT vext>
+void Quant::_initQuantX86()
+{
+  m_maxAbsCoeff = maxAbsCoeff_SIMD<vext>;
+}
+
+template void Quant::_initQuantX86<SIMDX86>();
+
+#endif //#ifdef TARGET_SIMD_X86
+#endif
+
+//! \}
@@ -0,0 +1,471 @@
+/* The copyright in this software is being made available under the BSD
+ * License, included below. This software may be subject to other third party
+ * and contributor rights, including patent rights, and no such rights are
+ * granted under this license.
+ *
+ * Copyright (c) 2010-2020, ITU/ISO/IEC
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ *  * Redistributions of source code must retain the above copyright notice,
+ *    this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+ *    be used to endorse or promote products derived from this software without
+ *    specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+ * BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+ * THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/** \file     TrQuantX86.h
+    \brief    SIMD version of the core transforms and of the low frequency non-separable transform
+*/
+
+//! \ingroup CommonLib
+//! \{
+
+#include "CommonDefX86.h"
+#include "../Rom.h"
+#include "../TrQuant.h"
+#include "../TrQuant_EMT.h"
+
+#if ENABLE_SIMD_OPT_TRAFO
+#ifdef TARGET_SIMD_X86
+
+static inline const TMatrixCoeff* getTrMatrix( const int trType, const int trSize, const int dir )
+{
+  switch( trType )
+  {
+  case DCT2:
+    switch( trSize )
+    {
+    case  4: return g_trCoreDCT2P4 [dir][0];
+    case  8: return g_trCoreDCT2P8 [dir][0];
+    case 16: return g_trCoreDCT2P16[dir][0];
+    case 32: return g_trCoreDCT2P32[dir][0];
+    case 64: return g_trCoreDCT2P64[dir][0];
+    default: break;
+    }
+    break;
+  case DCT8:
+    switch( trSize )
+    {
+    case  4: return g_trCoreDCT8P4 [dir][0];
+    case  8: return g_trCoreDCT8P8 [dir][0];
+    case 16: return g_trCoreDCT8P16[dir][0];
+    case 32: return g_trCoreDCT8P32[dir][0];
+    default: break;
+    }
+    break;
+  case DST7:
+    switch( trSize )
+    {
+    case  4: return g_trCoreDST7P4 [dir][0];
+    case  8: return g_trCoreDST7P8 [dir][0];
+    case 16: return g_trCoreDST7P16[dir][0];
+    case 32: return g_trCoreDST7P32[dir][0];
+    default: break;
+    }
+    break;
+  default:
+    break;
+  }
+  THROW( "Unsupported transform" );
+  return nullptr;
+}
+
+// checks that a block of coefficients can be processed with 16-bit multiplications (width has to be a multiple of 4)
+static inline bool fitsInt16( const TCoeff* src, const int stride, const int width, const int height )
+{
+  const __m128i vmin = _mm_set1_epi32( std::numeric_limits<int16_t>::min() );
+  const __m128i vmax = _mm_set1_epi32( std::numeric_limits<int16_t>::max() );
+  __m128i       vout = _mm_setzero_si128();
+
+  for( int y = 0; y < height; y++, src += stride )
+  {
+    for( int x = 0; x < width; x += 4 )
+    {
+      __m128i v = _mm_loadu_si128( ( const __m128i* ) &src[x] );
+      vout      = _mm_or_si128( vout, _mm_or_si128( _mm_cmpgt_epi32( v, vmax ), _mm_cmplt_epi32( v, vmin ) ) );
+    }
+  }
+
+  return _mm_testz_si128( vout, vout );
+}
+
+static inline bool isZeroBlock( const TCoeff* src, const int stride, const int width, const int height )
+{
+  __m128i vacc = _mm_setzero_si128();
+
+  for( int y = 0; y < height; y++, src += stride )
+  {
+    for( int x = 0; x < width; x += 4 )
+    {
+      vacc = _mm_or_si128( vacc, _mm_loadu_si128( ( const __m128i* ) &src[x] ) );
+    }
+  }
+
+  return _mm_testz_si128( vacc, vacc );
+}
+
+// packs 4 lines of trSize samples into trSize/2 vectors, where vector p holds the sample pairs ( 2p, 2p+1 ) of the 4 lines
+template<int trSize>
+static inline void packFwdLines( const TCoeff* src, __m128i* vsrc )
+{
+  for( int k = 0; k < trSize; k += 4 )
+  {
+    __m128i a = _mm_packs_epi32( _mm_loadu_si128( ( const __m128i* ) &src[             k] ), _mm_loadu_si128( ( const __m128i* ) &src[    trSize + k] ) );
+    __m128i b = _mm_packs_epi32( _mm_loadu_si128( ( const __m128i* ) &src[2 * trSize + k] ), _mm_loadu_si128( ( const __m128i* ) &src[3 * trSize + k] ) );
+    a = _mm_shuffle_epi32( a, 0xD8 );
+    b = _mm_shuffle_epi32( b, 0xD8 );
+
+    vsrc[( k >> 1 )    ] = _mm_unpacklo_epi64( a, b );
+    vsrc[( k >> 1 ) + 1] = _mm_unpackhi_epi64( a, b );
+  }
+}
+
+template<X86_VEXT vext, int trSize>
+static void fwdTransCore_SIMD( const TCoeff* src, TCoeff* dst, const int shift, const int line, const int reducedLine, const int numRows, const TMatrixCoeff* trMat )
+{
+  const int rnd = shift > 0 ? 1 << ( shift - 1 ) : 0;
+  int       i   = 0;
+
+#ifdef USE_AVX2
+  if( vext >= AVX2 )
+  {
+    const __m256i vrnd = _mm256_set1_epi32( rnd );
+    __m128i       vlo[trSize >> 1], vhi[trSize >> 1];
+    __m256i       vsrc[trSize >> 1];
+
+    for( ; i + 8 <= reducedLine; i += 8 )
+    {
+      packFwdLines<trSize>( src + ( i     ) * trSize, vlo );
+      packFwdLines<trSize>( src + ( i + 4 ) * trSize, vhi );
+
+      for( int p = 0; p < ( trSize >> 1 ); p++ )
+      {
+        vsrc[p] = _mm256_inserti128_si256( _mm256_castsi128_si256( vlo[p] ), vhi[p], 1 );
+      }
+
+      for( int j = 0; j < numRows; j++ )
+      {
+        const TMatrixCoeff* t    = trMat + j * trSize;
+        __m256i             vacc = vrnd;
+
+        for( int k = 0; k < trSize; k += 4 )
+        {
+          const __m128i vc = _mm_loadl_epi64( ( const __m128i* ) &t[k] );
+          vacc = _mm256_add_epi32( vacc, _mm256_madd_epi16( vsrc[( k >> 1 )    ], _mm256_broadcastd_epi32( vc ) ) );
+          vacc = _mm256_add_epi32( vacc, _mm256_madd_epi16( vsrc[( k >> 1 ) + 1], _mm256_broadcastd_epi32( _mm_srli_si128( vc, 4 ) ) ) );
+        }
+
+        _mm256_storeu_si256( ( __m256i* ) &dst[j * line + i], _mm256_srai_epi32( vacc, shift ) );
+      }
+    }
+  }
+#endif
+
+  const __m128i vrnd = _mm_set1_epi32( rnd );
+  __m128i       vsrc[trSize >> 1];
+
+  for( ; i < reducedLine; i += 4 )
+  {
+    packFwdLines<trSize>( src + i * trSize, vsrc );
+
+    for( int j = 0; j < numRows; j++ )
+    {
+      const TMatrixCoeff* t    = trMat + j * trSize;
+      __m128i             vacc = vrnd;
+
+      for( int k = 0; k < trSize; k += 4 )
+      {
+        const __m128i vc = _mm_loadl_epi64( ( const __m128i* ) &t[k] );
+        vacc = _mm_add_epi32( vacc, _mm_madd_epi16( vsrc[( k >> 1 )    ], _mm_shuffle_epi32( vc, 0x00 ) ) );
+        vacc = _mm_add_epi32( vacc, _mm_madd_epi16( vsrc[( k >> 1 ) + 1], _mm_shuffle_epi32( vc, 0x55 ) ) );
+      }
+
+      _mm_storeu_si128( ( __m128i* ) &dst[j * line + i], _mm_srai_epi32( vacc, shift ) );
+    }
+  }
+}
+
+template<X86_VEXT vext, int trSize>
+static void invTransCore_SIMD( const TCoeff* src, TCoeff* dst, const int shift, const int line, const int reducedLine, const int numRows, const TCoeff outputMinimum, const TCoeff outputMaximum, const TMatrixCoeff* trMat )
+{
+  const int numPairs = ( numRows + 1 ) >> 1;
+  int       i        = 0;
+
+#ifdef USE_AVX2
+  if( vext >= AVX2 )
+  {
+    const __m256i vrnd = _mm256_set1_epi32( 1 << ( shift - 1 ) );
+    const __m256i vmin = _mm256_set1_epi32( outputMinimum );
+    const __m256i vmax = _mm256_set1_epi32( outputMaximum );
+    __m256i       vsrc[trSize >> 1];
+
+    for( ; i + 8 <= reducedLine; i += 8 )
+    {
+      for( int p = 0; p < numPairs; p++ )
+      {
+        const __m256i r0 = _mm256_loadu_si256( ( const __m256i* ) &src[2 * p * line + i] );
+        const __m256i r1 = 2 * p + 1 < numRows ? _mm256_loadu_si256( ( const __m256i* ) &src[( 2 * p + 1 ) * line + i] ) : _mm256_setzero_si256();
+        const __m256i rr = _mm256_packs_epi32( r0, r1 );
+        vsrc[p]          = _mm256_unpacklo_epi16( rr, _mm256_srli_si256( rr, 8 ) );
+      }
+
+      for( int j = 0; j < trSize; j += 4 )
+      {
+        __m256i vacc[4] = { vrnd, vrnd, vrnd, vrnd };
+
+        for( int p = 0; p < numPairs; p++ )
+        {
+          const __m128i vc = _mm_unpacklo_epi16( _mm_loadl_epi64( ( const __m128i* ) &trMat[2 * p * trSize + j] ), _mm_loadl_epi64( ( const __m128i* ) &trMat[( 2 * p + 1 ) * trSize + j] ) );
+          vacc[0] = _mm256_add_epi32( vacc[0], _mm256_madd_epi16( vsrc[p], _mm256_broadcastd_epi32( vc ) ) );
+          vacc[1] = _mm256_add_epi32( vacc[1], _mm256_madd_epi16( vsrc[p], _mm256_broadcastd_epi32( _mm_srli_si128( vc,  4 ) ) ) );
+          vacc[2] = _mm256_add_epi32( vacc[2], _mm256_madd_epi16( vsrc[p], _mm256_broadcastd_epi32( _mm_srli_si128( vc,  8 ) ) ) );
+          vacc[3] = _mm256_add_epi32( vacc[3], _mm256_madd_epi16( vsrc[p], _mm256_broadcastd_epi32( _mm_srli_si128( vc, 12 ) ) ) );
+        }
+
+        // transpose within the 128-bit lanes, lane 0 holds lines i..i+3, lane 1 holds lines i+4..i+7
+        const __m256i t0 = _mm256_unpacklo_epi32( vacc[0], vacc[1] );
+        const __m256i t1 = _mm256_unpackhi_epi32( vacc[0], vacc[1] );
+        const __m256i t2 = _mm256_unpacklo_epi32( vacc[2], vacc[3] );
+        const __m256i t3 = _mm256_unpackhi_epi32( vacc[2], vacc[3] );
+        vacc[0] = _mm256_unpacklo_epi64( t0, t2 );
+        vacc[1] = _mm256_unpackhi_epi64( t0, t2 );
+        vacc[2] = _mm256_unpacklo_epi64( t1, t3 );
+        vacc[3] = _mm256_unpackhi_epi64( t1, t3 );
+
+        for( int m = 0; m < 4; m++ )
+        {
+          const __m256i vres = _mm256_min_epi32( vmax, _mm256_max_epi32( vmin, _mm256_srai_epi32( vacc[m], shift ) ) );
+          _mm_storeu_si128( ( __m128i* ) &dst[( i + m     ) * trSize + j], _mm256_castsi256_si128( vres ) );
+          _mm_storeu_si128( ( __m128i* ) &dst[( i + m + 4 ) * trSize + j], _mm256_extracti128_si256( vres, 1 ) );
+        }
+      }
+    }
+  }
+#endif
+
+  const __m128i vrnd = _mm_set1_epi32( 1 << ( shift - 1 ) );
+  const __m128i vmin = _mm_set1_epi32( outputMinimum );
+  const __m128i vmax = _mm_set1_epi32( outputMaximum );
+  __m128i       vsrc[trSize >> 1];
+
+  for( ; i < reducedLine; i += 4 )
+  {
+    for( int p = 0; p < numPairs; p++ )
+    {
+      const __m128i r0 = _mm_loadu_si128( ( const __m128i* ) &src[2 * p * line + i] );
+      const __m128i r1 = 2 * p + 1 < numRows ? _mm_loadu_si128( ( const __m128i* ) &src[( 2 * p + 1 ) * line + i] ) : _mm_setzero_si128();
+      const __m128i rr = _mm_packs_epi32( r0, r1 );
+      vsrc[p]          = _mm_unpacklo_epi16( rr, _mm_srli_si128( rr, 8 ) );
+    }
+
+    for( int j = 0; j < trSize; j += 4 )
+    {
+      __m128i vacc[4] = { vrnd, vrnd, vrnd, vrnd };
+
+      for( int p = 0; p < numPairs; p++ )
+      {
+        const __m128i vc = _mm_unpacklo_epi16( _mm_loadl_epi64( ( const __m128i* ) &trMat[2 * p * trSize + j] ), _mm_loadl_epi64( ( const __m128i* ) &trMat[( 2 * p + 1 ) * trSize + j] ) );
+        vacc[0] = _mm_add_epi32( vacc[0], _mm_madd_epi16( vsrc[p], _mm_shuffle_epi32( vc, 0x00 ) ) );
+        vacc[1] = _mm_add_epi32( vacc[1], _mm_madd_epi16( vsrc[p], _mm_shuffle_epi32( vc, 0x55 ) ) );
+        vacc[2] = _mm_add_epi32( vacc[2], _mm_madd_epi16( vsrc[p], _mm_shuffle_epi32( vc, 0xAA ) ) );
+        vacc[3] = _mm_add_epi32( vacc[3], _mm_madd_epi16( vsrc[p], _mm_shuffle_epi32( vc, 0xFF ) ) );
+      }
+
+      TRANSPOSE4x4( vacc );
+
+      for( int m = 0; m < 4; m++ )
+      {
+        const __m128i vres = _mm_min_epi32( vmax, _mm_max_epi32( vmin, _mm_srai_epi32( vacc[m], shift ) ) );
+        _mm_storeu_si128( ( __m128i* ) &dst[( i + m ) * trSize + j], vres );
+      }
+    }
+  }
+}
+
+/** 1D forward transform as a matrix multiplication on 16-bit samples
+*  The set of output rows that is computed and zeroed matches the corresponding partial butterfly in TrQuant_EMT.cpp.
+*  Falls back to the reference implementation if the line count is no multiple of 4 or the input exceeds 16 bits.
+*/
+template<X86_VEXT vext, int trType, int trSize>
+void fastForwardTrafo_SIMD( const TCoeff *src, TCoeff *dst, int shift, int line, int iSkipLine, int iSkipLine2 )
+{
+  const int  reducedLine = line - iSkipLine;
+  const int  cutoff      = trSize - iSkipLine2;
+  // the DCT-II butterflies up to 32 points and the 4-point DST-VII/DCT-VIII always produce all outputs
+  const bool zeroOut     = trSize == 64 || ( trType != DCT2 && trSize > 4 );
+  const int  numRows     = trSize == 64 ? ( iSkipLine2 ? std::min( 32, cutoff ) : trSize ) : ( zeroOut ? cutoff : trSize );
+
+  if( ( reducedLine & 3 ) || !fitsInt16( src, trSize, trSize, reducedLine ) )
+  {
+    fastFwdTrans[trType][floorLog2( trSize ) - 1]( src, dst, shift, line, iSkipLine, iSkipLine2 );
+    return;
+  }
+
+  fwdTransCore_SIMD<vext, trSize>( src, dst, shift, line, reducedLine, numRows, getTrMatrix( trType, trSize, TRANSFORM_FORWARD ) );
+
+  if( iSkipLine )
+  {
+    TCoeff* pCoef = dst + reducedLine;
+    for( int j = 0; j < ( zeroOut ? cutoff : trSize ); j++ )
+    {
+      memset( pCoef, 0, sizeof( TCoeff ) * iSkipLine );
+      pCoef += line;
+    }
+  }
+
+  if( zeroOut && iSkipLine2 )
+  {
+    memset( dst + line * cutoff, 0, sizeof( TCoeff ) * line * iSkipLine2 );
+  }
+}
+
+/** 1D inverse transform as a matrix multiplication on 16-bit coefficients
+*  Coefficient rows that are known to be zero are excluded from the multiplication.
+*  Falls back to the reference implementation if the line count is no multiple of 4 or the input exceeds 16 bits.
+*/
+template<X86_VEXT vext, int trType, int trSize>
+void fastInverseTrafo_SIMD( const TCoeff *src, TCoeff *dst, int shift, int line, int iSkipLine, int iSkipLine2, const TCoeff outputMinimum, const TCoeff outputMaximum )
+{
+  const int reducedLine = line - iSkipLine;
+  const int cutoff      = trSize - iSkipLine2;
+  // number of coefficient rows read by the reference implementation
+  int       numRows     = trSize == 64 ? ( iSkipLine2 >= 32 ? 32 : trSize ) : ( trType != DCT2 && trSize == 8 ) ? cutoff : trSize;
+
+  if( ( reducedLine & 3 ) || !fitsInt16( src, line, reducedLine, numRows ) )
+  {
+    fastInvTrans[trType][floorLog2( trSize ) - 1]( src, dst, shift, line, iSkipLine, iSkipLine2, outputMinimum, outputMaximum );
+    return;
+  }
+
+  if( numRows > cutoff && isZeroBlock( src + cutoff * line, line, reducedLine, numRows - cutoff ) )
+  {
+    numRows = cutoff;
+  }
+
+  invTransCore_SIMD<vext, trSize>( src, dst, shift, line, reducedLine, numRows, outputMinimum, outputMaximum, getTrMatrix( trType, trSize, TRANSFORM_INVERSE ) );
+
+  if( iSkipLine )
+  {
+    memset( dst + reducedLine * trSize, 0, sizeof( TCoeff ) * iSkipLine * trSize );
+  }
+}
+
+template<X86_VEXT vext>
+void fwdLfnstNxN_SIMD( const TCoeff* src, TCoeff* dst, const int8_t* trMat, const int trSize, const int zeroOutSize )
+{
+  const __m128i vrnd = _mm_set1_epi32( 64 );
+
+  for( int j = 0; j < zeroOutSize; j += 4 )
+  {
+    __m128i vacc[4];
+
+    for( int n = 0; n < 4; n++ )
+    {
+      const int8_t* m = trMat + ( j + n ) * trSize;
+      vacc[n]         = _mm_setzero_si128();
+
+      for( int i = 0; i < trSize; i += 16 )
+      {
+        const __m128i vm = _mm_loadu_si128( ( const __m128i* ) &m[i] );
+        vacc[n] = _mm_add_epi32( vacc[n], _mm_mullo_epi32( _mm_loadu_si128( ( const __m128i* ) &src[i     ] ), _mm_cvtepi8_epi32( vm ) ) );
+        vacc[n] = _mm_add_epi32( vacc[n], _mm_mullo_epi32( _mm_loadu_si128( ( const __m128i* ) &src[i +  4] ), _mm_cvtepi8_epi32( _mm_srli_si128( vm,  4 ) ) ) );
+        vacc[n] = _mm_add_epi32( vacc[n], _mm_mullo_epi32( _mm_loadu_si128( ( const __m128i* ) &src[i +  8] ), _mm_cvtepi8_epi32( _mm_srli_si128( vm,  8 ) ) ) );
+        vacc[n] = _mm_add_epi32( vacc[n], _mm_mullo_epi32( _mm_loadu_si128( ( const __m128i* ) &src[i + 12] ), _mm_cvtepi8_epi32( _mm_srli_si128( vm, 12 ) ) ) );
+      }
+    }
+
+    const __m128i vsum = _mm_hadd_epi32( _mm_hadd_epi32( vacc[0], vacc[1] ), _mm_hadd_epi32( vacc[2], vacc[3] ) );
+    _mm_storeu_si128( ( __m128i* ) &dst[j], _mm_srai_epi32( _mm_add_epi32( vsum, vrnd ), 7 ) );
+  }
+
+  ::memset( dst + zeroOutSize, 0, ( trSize - zeroOutSize ) * sizeof( TCoeff ) );
+}
+
+template<X86_VEXT vext>
+void invLfnstNxN_SIMD( const TCoeff* src, TCoeff* dst, const int8_t* trMat, const int trSize, const int zeroOutSize )
+{
+  const __m128i vrnd = _mm_set1_epi32( 64 );
+  const __m128i vmin = _mm_set1_epi32( std::numeric_limits<int16_t>::min() );
+  const __m128i vmax = _mm_set1_epi32( std::numeric_limits<int16_t>::max() );
+
+  for( int j = 0; j < trSize; j += 16 )
+  {
+    __m128i vacc[4] = { vrnd, vrnd, vrnd, vrnd };
+
+    for( int i = 0; i < zeroOutSize; i++ )
+    {
+      const __m128i vs = _mm_set1_epi32( src[i] );
+      const __m128i vm = _mm_loadu_si128( ( const __m128i* ) &trMat[i * trSize + j] );
+      vacc[0] = _mm_add_epi32( vacc[0], _mm_mullo_epi32( vs, _mm_cvtepi8_epi32( vm ) ) );
+      vacc[1] = _mm_add_epi32( vacc[1], _mm_mullo_epi32( vs, _mm_cvtepi8_epi32( _mm_srli_si128( vm,  4 ) ) ) );
+      vacc[2] = _mm_add_epi32( vacc[2], _mm_mullo_epi32( vs, _mm_cvtepi8_epi32( _mm_srli_si128( vm,  8 ) ) ) );
+      vacc[3] = _mm_add_epi32( vacc[3], _mm_mullo_epi32( vs, _mm_cvtepi8_epi32( _mm_srli_si128( vm, 12 ) ) ) );
+    }
+
+    for( int n = 0; n < 4; n++ )
+    {
+      _mm_storeu_si128( ( __m128i* ) &dst[j + 4 * n], _mm_min_epi32( vmax, _mm_max_epi32( vmin, _mm_srai_epi32( vacc[n], 7 ) ) ) );
+    }
+  }
+}
+
+template<X86_VEXT vext>
+void TrQuant::_initTrQuantX86()
+{
+  m_fwdTrans[DCT2][1] = fastForwardTrafo_SIMD<vext, DCT2,  4>;
+  m_fwdTrans[DCT2][2] = fastForwardTrafo_SIMD<vext, DCT2,  8>;
+  m_fwdTrans[DCT2][3] = fastForwardTrafo_SIMD<vext, DCT2, 16>;
+  m_fwdTrans[DCT2][4] = fastForwardTrafo_SIMD<vext, DCT2, 32>;
+  m_fwdTrans[DCT2][5] = fastForwardTrafo_SIMD<vext, DCT2, 64>;
+  m_fwdTrans[DCT8][1] = fastForwardTrafo_SIMD<vext, DCT8,  4>;
+  m_fwdTrans[DCT8][2] = fastForwardTrafo_SIMD<vext, DCT8,  8>;
+  m_fwdTrans[DCT8][3] = fastForwardTrafo_SIMD<vext, DCT8, 16>;
+  m_fwdTrans[DCT8][4] = fastForwardTrafo_SIMD<vext, DCT8, 32>;
+  m_fwdTrans[DST7][1] = fastForwardTrafo_SIMD<vext, DST7,  4>;
+  m_fwdTrans[DST7][2] = fastForwardTrafo_SIMD<vext, DST7,  8>;
+  m_fwdTrans[DST7][3] = fastForwardTrafo_SIMD<vext, DST7, 16>;
+  m_fwdTrans[DST7][4] = fastForwardTrafo_SIMD<vext, DST7, 32>;
+
+  m_invTrans[DCT2][1] = fastInverseTrafo_SIMD<vext, DCT2,  4>;
+  m_invTrans[DCT2][2] = fastInverseTrafo_SIMD<vext, DCT2,  8>;
+  m_invTrans[DCT2][3] = fastInverseTrafo_SIMD<vext, DCT2, 16>;
+  m_invTrans[DCT2][4] = fastInverseTrafo_SIMD<vext, DCT2, 32>;
+  m_invTrans[DCT2][5] = fastInverseTrafo_SIMD<vext, DCT2, 64>;
+  m_invTrans[DCT8][1] = fastInverseTrafo_SIMD<vext, DCT8,  4>;
+  m_invTrans[DCT8][2] = fastInverseTrafo_SIMD<vext, DCT8,  8>;
+  m_invTrans[DCT8][3] = fastInverseTrafo_SIMD<vext, DCT8, 16>;
+  m_invTrans[DCT8][4] = fastInverseTrafo_SIMD<vext, DCT8, 32>;
+  m_invTrans[DST7][1] = fastInverseTrafo_SIMD<vext, DST7,  4>;
+  m_invTrans[DST7][2] = fastInverseTrafo_SIMD<vext, DST7,  8>;
+  m_invTrans[DST7][3] = fastInverseTrafo_SIMD<vext, DST7, 16>;
+  m_invTrans[DST7][4] = fastInverseTrafo_SIMD<vext, DST7, 32>;
+
+  m_fwdLfnstNxN = fwdLfnstNxN_SIMD<vext>;
+  m_invLfnstNxN = invLfnstNxN_SIMD<vext>;
+}
+
+template void TrQuant::_initTrQuantX86<SIMDX86>();
+
+#endif //#ifdef TARGET_SIMD_X86
+#endif
+
+//! \}
@@ -0,0 +1 @@
+#include "../MatrixIntraPredX86.h"
@@ -0,0 +1 @@
+#include "../BitStreamX86.h"
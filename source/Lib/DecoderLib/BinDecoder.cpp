@@ -38,11 +38,6 @@
 
 #include "BinDecoder.h"
 #include "CommonLib/Rom.h"
-#if RExt__DECODER_DEBUG_BIT_STATISTICS
-#include "CommonLib/CodingStatistics.h"
-#endif
-
-#include "CommonLib/dtrace_next.h"
 
 #define CNT_OFFSET 0
 
@@ -52,9 +47,14 @@ template <class BinProbModel>
 BinDecoderBase::BinDecoderBase( const BinProbModel* dummy )
   : Ctx         ( dummy )
   , m_Bitstream ( 0 )
+  , m_bufPtr    ( nullptr )
+  , m_bufSize   ( 0 )
+  , m_bufStart  ( 0 )
+  , m_bufPos    ( 0 )
   , m_Range     ( 0 )
   , m_Value     ( 0 )
   , m_bitsNeeded( 0 )
+  , m_numBins   ( 0 )
 {}
 
 
@@ -76,17 +76,35 @@ void BinDecoderBase::start()
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
   CodingStatistics::UpdateCABACStat(STATS__CABAC_INITIALISATION, 512, 510, 0);
 #endif
+  CHECK( m_Bitstream->getNumBitsLeft() < 16, "FIFO exceeded" );
+  const std::vector<uint8_t>& fifo = m_Bitstream->getFifo();
+  m_bufPtr      = fifo.data();
+  m_bufSize     = uint32_t( fifo.size() );
+  m_bufStart    = m_Bitstream->getByteLocation();
   m_Range       = 510;
-  m_Value       = ( m_Bitstream->readByte() << 8 ) + m_Bitstream->readByte();
-  m_bitsNeeded  = -8;
+  m_Value       = 0;
+  for( uint32_t i = 0; i < 5; i++ )
+  {
+    m_Value     = ( m_Value << 8 ) + ( m_bufStart + i < m_bufSize ? m_bufPtr[m_bufStart + i] : 0 );
+  }
+  m_bufPos      = m_bufStart + 5;
+  m_bitsNeeded  = -32;
 }
 
 
 void BinDecoderBase::finish()
 {
+  // advance the bitstream over the bytes consumed by the arithmetic decoder
+  const uint32_t numBytes = getNumBytesConsumed();
+  for( uint32_t i = 0; i < numBytes; i++ )
+  {
+    m_Bitstream->readByte();
+  }
+  m_bufStart   += numBytes;
+
   unsigned lastByte;
   m_Bitstream->peekPreviousByte( lastByte );
-  CHECK( ( ( lastByte << ( 8 + m_bitsNeeded ) ) & 0xff ) != 0x80,
+  CHECK( ( ( lastByte << ( 8 + getBitsNeededByteWise() ) ) & 0xff ) != 0x80,
         "No proper stop/alignment pattern at end of CABAC stream." );
 }
 
@@ -98,30 +116,6 @@ void BinDecoderBase::reset( int qp, int initId )
 }
 
 
-unsigned BinDecoderBase::decodeBinEP()
-{
-  m_Value            += m_Value;
-  if( ++m_bitsNeeded >= 0 )
-  {
-    m_Value          += m_Bitstream->readByte();
-    m_bitsNeeded      = -8;
-  }
-
-  unsigned bin = 0;
-  unsigned SR  = m_Range << 7;
-  if( m_Value >= SR )
-  {
-    m_Value   -= SR;
-    bin        = 1;
-  }
-#if RExt__DECODER_DEBUG_BIT_STATISTICS
-  CodingStatistics::IncrementStatisticEP( *ptype, 1, int(bin) );
-#endif
-  DTRACE( g_trace_ctx, D_CABAC, "%d" "  " "%d" "  EP=%d \n",  DTRACE_GET_COUNTER( g_trace_ctx, D_CABAC ), m_Range, bin );
-  return bin;
-}
-
-
 unsigned BinDecoderBase::decodeBinsEP( unsigned numBins )
 {
 #if ENABLE_TRACING
@@ -132,13 +126,21 @@ unsigned BinDecoderBase::decodeBinsEP( unsigned numBins )
   {
     return decodeAlignedBinsEP( numBins );
   }
+  m_numBins       += numBins;
   unsigned remBins = numBins;
   unsigned bins    = 0;
-  while(   remBins > 8 )
+  while( remBins > 0 )
   {
-    m_Value     = ( m_Value << 8 ) + ( m_Bitstream->readByte() << ( 8 + m_bitsNeeded ) );
-    unsigned SR =   m_Range << 15;
-    for( int i = 0; i < 8; i++ )
+    // shift in as many bins as the look-ahead holds, refill once and then resolve them
+    const unsigned numBinsChunk = std::min<unsigned>( remBins, std::min<int>( 7 - m_bitsNeeded, VALUE_EXT_BITS ) );
+    m_bitsNeeded   += numBinsChunk;
+    m_Value       <<= numBinsChunk;
+    if( m_bitsNeeded >= 0 )
+    {
+      refill();
+    }
+    uint64_t SR = uint64_t( m_Range ) << ( numBinsChunk + 7 + VALUE_EXT_BITS );
+    for( unsigned i = 0; i < numBinsChunk; i++ )
     {
       bins += bins;
       SR  >>= 1;
@@ -148,25 +150,7 @@ unsigned BinDecoderBase::decodeBinsEP( unsigned numBins )
         m_Value -= SR;
       }
     }
-    remBins -= 8;
-  }
-  m_bitsNeeded   += remBins;
-  m_Value       <<= remBins;
-  if( m_bitsNeeded >= 0 )
-  {
-    m_Value      += m_Bitstream->readByte() << m_bitsNeeded;
-    m_bitsNeeded -= 8;
-  }
-  unsigned SR = m_Range << ( remBins + 7 );
-  for ( int i = 0; i < remBins; i++ )
-  {
-    bins += bins;
-    SR  >>= 1;
-    if( m_Value >= SR )
-    {
-      bins    ++;
-      m_Value -= SR;
-    }
+    remBins -= numBinsChunk;
   }
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
   CodingStatistics::IncrementStatisticEP( *ptype, numBins, int(bins) );
@@ -212,13 +196,14 @@ unsigned BinDecoderBase::decodeRemAbsEP(unsigned goRicePar, unsigned cutoff, int
 
 unsigned BinDecoderBase::decodeBinTrm()
 {
+  m_numBins++;
   m_Range    -= 2;
-  unsigned SR = m_Range << 7;
+  uint64_t SR = uint64_t( m_Range ) << ( 7 + VALUE_EXT_BITS );
   if( m_Value >= SR )
   {
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
     CodingStatistics::UpdateCABACStat     ( STATS__CABAC_TRM_BITS,       m_Range+2, 2, 1 );
-    CodingStatistics::IncrementStatisticEP( STATS__BYTE_ALIGNMENT_BITS, -m_bitsNeeded, 0 );
+    CodingStatistics::IncrementStatisticEP( STATS__BYTE_ALIGNMENT_BITS, -getBitsNeededByteWise(), 0 );
 #endif
     return 1;
   }
@@ -233,8 +218,7 @@ unsigned BinDecoderBase::decodeBinTrm()
       m_Value += m_Value;
       if( ++m_bitsNeeded == 0 )
       {
-        m_Value      += m_Bitstream->readByte();
-        m_bitsNeeded  = -8;
+        refill();
       }
     }
     return 0;
@@ -258,6 +242,7 @@ unsigned BinDecoderBase::decodeAlignedBinsEP( unsigned numBins )
 #if ENABLE_TRACING
   int numBinsOrig = numBins;
 #endif
+  m_numBins       += numBins;
   unsigned remBins = numBins;
   unsigned bins    = 0;
   while(   remBins > 0 )
@@ -266,21 +251,21 @@ unsigned BinDecoderBase::decodeAlignedBinsEP( unsigned numBins )
     //   > The comparison against the symbol range of 128 is simply a test on the next-most-significant bit
     //   > "Subtracting" the symbol range if the decoded bin is 1 simply involves clearing that bit.
     //  As a result, the required bins are simply the <binsToRead> next-most-significant bits of m_Value
-    //  (m_Value is stored MSB-aligned in a 16-bit buffer - hence the shift of 15)
+    //  (m_Value is stored MSB-aligned in a 16+VALUE_EXT_BITS-bit buffer - hence the shift of 15+VALUE_EXT_BITS)
     //
-    //    m_Value = |0|V|V|V|V|V|V|V|V|B|B|B|B|B|B|B|        (V = usable bit, B = potential buffered bit (buffer refills when m_bitsNeeded >= 0))
+    //    m_Value = |0|V|V|V|V|V|V|V|V|V|V|...|V|B|B|...|B|        (V = usable bit, B = potential buffered bit (buffer refills when m_bitsNeeded >= 0))
     //
-    unsigned binsToRead = std::min<unsigned>( remBins, 8 ); //read bytes if able to take advantage of the system's byte-read function
-    unsigned binMask    = ( 1 << binsToRead ) - 1;
-    unsigned newBins    = ( m_Value >> (15 - binsToRead) ) & binMask;
-    bins                = ( bins    << binsToRead) | newBins;
-    m_Value             = ( m_Value << binsToRead) & 0x7FFF;
-    remBins            -= binsToRead;
-    m_bitsNeeded       += binsToRead;
+    const int      valueBits  = 15 + VALUE_EXT_BITS;
+    const unsigned binsToRead = std::min<unsigned>( remBins, std::min<int>( 7 - m_bitsNeeded, VALUE_EXT_BITS ) );
+    const unsigned binMask    = ( 1u << binsToRead ) - 1;
+    const unsigned newBins    = unsigned( m_Value >> ( valueBits - binsToRead ) ) & binMask;
+    bins                      = ( bins    << binsToRead) | newBins;
+    m_Value                   = ( m_Value << binsToRead) & ( ( uint64_t( 1 ) << valueBits ) - 1 );
+    remBins                  -= binsToRead;
+    m_bitsNeeded             += binsToRead;
     if( m_bitsNeeded >= 0 )
     {
-      m_Value          |= m_Bitstream->readByte() << m_bitsNeeded;
-      m_bitsNeeded     -= 8;
+      refill();
     }
   }
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
@@ -305,62 +290,5 @@ TBinDecoder<BinProbModel>::TBinDecoder()
 {}
 
 
-template <class BinProbModel>
-unsigned TBinDecoder<BinProbModel>::decodeBin( unsigned ctxId )
-{
-  BinProbModel& rcProbModel = m_Ctx[ctxId];
-  unsigned      bin         = rcProbModel.mps();
-  uint32_t      LPS         = rcProbModel.getLPS( m_Range );
-
-  DTRACE( g_trace_ctx, D_CABAC, "%d" " %d " "%d" "  " "[%d:%d]" "  " "%2d(MPS=%d)"  "  " , DTRACE_GET_COUNTER( g_trace_ctx, D_CABAC ), ctxId, m_Range, m_Range-LPS, LPS, ( unsigned int )( rcProbModel.state() ), m_Value < ( ( m_Range - LPS ) << 7 ) );
-  //DTRACE( g_trace_ctx, D_CABAC, " %d " "%d" "  " "[%d:%d]" "  " "%2d(MPS=%d)"  "  ", DTRACE_GET_COUNTER( g_trace_ctx, D_CABAC ), m_Range, m_Range - LPS, LPS, (unsigned int)( rcProbModel.state() ), m_Value < ( ( m_Range - LPS ) << 7 ) );
-
-  m_Range   -=  LPS;
-  uint32_t      SR          = m_Range << 7;
-  if( m_Value < SR )
-  {
-#if RExt__DECODER_DEBUG_BIT_STATISTICS
-    CodingStatistics::UpdateCABACStat( *ptype, m_Range+LPS, m_Range, int( bin ) );
-#endif
-    // MPS path
-    if( m_Range < 256 )
-    {
-      int numBits   = rcProbModel.getRenormBitsRange( m_Range );
-      m_Range     <<= numBits;
-      m_Value     <<= numBits;
-      m_bitsNeeded += numBits;
-      if( m_bitsNeeded >= 0 )
-      {
-        m_Value      += m_Bitstream->readByte() << m_bitsNeeded;
-        m_bitsNeeded -= 8;
-      }
-    }
-  }
-  else
-  {
-    bin = 1 - bin;
-#if RExt__DECODER_DEBUG_BIT_STATISTICS
-    CodingStatistics::UpdateCABACStat( *ptype, m_Range+LPS, LPS, int( bin ) );
-#endif
-    // LPS path
-    int numBits   = rcProbModel.getRenormBitsLPS( LPS );
-    m_Value      -= SR;
-    m_Value       = m_Value << numBits;
-    m_Range       = LPS     << numBits;
-    m_bitsNeeded += numBits;
-    if( m_bitsNeeded >= 0 )
-    {
-      m_Value      += m_Bitstream->readByte() << m_bitsNeeded;
-      m_bitsNeeded -= 8;
-    }
-  }
-  rcProbModel.update( bin );
-  //DTRACE_DECR_COUNTER( g_trace_ctx, D_CABAC );
-  DTRACE_WITHOUT_COUNT( g_trace_ctx, D_CABAC, "  -  " "%d" "\n", bin );
-  return  bin;
-}
-
-
 
 template class TBinDecoder<BinProbModel_Std>;
-
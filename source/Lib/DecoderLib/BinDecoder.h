@@ -40,14 +40,20 @@
 
 #include "CommonLib/Contexts.h"
 #include "CommonLib/BitStream.h"
+#include "CommonLib/dtrace_next.h"
 
 
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
-class CodingStatisticsClassType;
+#include "CommonLib/CodingStatistics.h"
 #endif
 
 
 
+// The arithmetic decoder keeps VALUE_EXT_BITS look-ahead bits below the 16-bit CABAC value window
+// (m_Value = window << VALUE_EXT_BITS) and refills them 32 bits at a time straight from the
+// substream buffer. m_bitsNeeded counts the free bits in the look-ahead part (refill when >= 0).
+// Bits below the window never influence a comparison, so the decoded bins are identical to the
+// byte-wise engine; finish() hands the bytes that engine would have read back to the bitstream.
 class BinDecoderBase : public Ctx
 {
 protected:
@@ -66,22 +72,74 @@ public:
 #endif
 
 public:
-  virtual unsigned  decodeBin           ( unsigned ctxId    ) = 0;
-
-public:
-  unsigned          decodeBinEP         ();
+  unsigned          decodeBinEP         ()
+  {
+    m_numBins++;
+    m_Value            += m_Value;
+    if( ++m_bitsNeeded >= 0 )
+    {
+      refill();
+    }
+
+    unsigned bin = 0;
+    uint64_t SR  = uint64_t( m_Range ) << ( 7 + VALUE_EXT_BITS );
+    if( m_Value >= SR )
+    {
+      m_Value   -= SR;
+      bin        = 1;
+    }
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+    CodingStatistics::IncrementStatisticEP( *ptype, 1, int(bin) );
+#endif
+    DTRACE( g_trace_ctx, D_CABAC, "%d" "  " "%d" "  EP=%d \n",  DTRACE_GET_COUNTER( g_trace_ctx, D_CABAC ), m_Range, bin );
+    return bin;
+  }
   unsigned          decodeBinsEP        ( unsigned numBins  );
   unsigned          decodeRemAbsEP      ( unsigned goRicePar, unsigned cutoff, int maxLog2TrDynamicRange );
   unsigned          decodeBinTrm        ();
   void              align               ();
-  unsigned          getNumBitsRead      () { return m_Bitstream->getNumBitsRead() + m_bitsNeeded; }
+  unsigned          getNumBitsRead      () { return m_Bitstream->getNumBitsRead() + 8 * getNumBytesConsumed() + getBitsNeededByteWise(); }
+  uint64_t          getNumBinsDecoded   () const { return m_numBins; }
 private:
   unsigned          decodeAlignedBinsEP ( unsigned numBins  );
 protected:
+  enum { VALUE_EXT_BITS = 24 };
+
+  void              refill              ()
+  {
+    // m_bitsNeeded is in [0,7] here: append the next 32 bits below the valid ones
+    const uint8_t* p = m_bufPtr + m_bufPos;
+    uint32_t    word;
+    if( m_bufPos + 4 <= m_bufSize )
+    {
+      word = ( uint32_t( p[0] ) << 24 ) | ( uint32_t( p[1] ) << 16 ) | ( uint32_t( p[2] ) << 8 ) | uint32_t( p[3] );
+    }
+    else
+    {
+      // read beyond the end of the substream: pad with zeros, these bits are never evaluated
+      word = 0;
+      for( uint32_t i = 0; i < 4; i++ )
+      {
+        word = ( word << 8 ) | ( m_bufPos + i < m_bufSize ? uint32_t( p[i] ) : 0 );
+      }
+    }
+    m_bufPos       += 4;
+    m_Value        += uint64_t( word ) << m_bitsNeeded;
+    m_bitsNeeded   -= 32;
+  }
+  // number of bytes and bit position the byte-wise engine would have reached in the substream
+  uint32_t          getNumBytesConsumed   () const { return m_bufPos - m_bufStart - 3 + ( ( m_bitsNeeded + 32 ) >> 3 ); }
+  int32_t           getBitsNeededByteWise () const { return -8 + ( ( m_bitsNeeded + 32 ) & 7 ); }
+
   InputBitstream*   m_Bitstream;
+  const uint8_t*    m_bufPtr;
+  uint32_t          m_bufSize;
+  uint32_t          m_bufStart;
+  uint32_t          m_bufPos;
   uint32_t          m_Range;
-  uint32_t          m_Value;
+  uint64_t          m_Value;
   int32_t           m_bitsNeeded;
+  uint64_t          m_numBins;
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
   const CodingStatisticsClassType* ptype;
 #endif
@@ -90,12 +148,61 @@ protected:
 
 
 template <class BinProbModel>
-class TBinDecoder : public BinDecoderBase
+class TBinDecoder final : public BinDecoderBase
 {
 public:
   TBinDecoder ();
   ~TBinDecoder() {}
-  unsigned decodeBin ( unsigned ctxId );
+  unsigned decodeBin ( unsigned ctxId )
+  {
+    m_numBins++;
+    BinProbModel& rcProbModel = m_Ctx[ctxId];
+    unsigned      bin         = rcProbModel.mps();
+    uint32_t      LPS         = rcProbModel.getLPS( m_Range );
+
+    DTRACE( g_trace_ctx, D_CABAC, "%d" " %d " "%d" "  " "[%d:%d]" "  " "%2d(MPS=%d)"  "  " , DTRACE_GET_COUNTER( g_trace_ctx, D_CABAC ), ctxId, m_Range, m_Range-LPS, LPS, ( unsigned int )( rcProbModel.state() ), m_Value < ( uint64_t( m_Range - LPS ) << ( 7 + VALUE_EXT_BITS ) ) );
+
+    m_Range   -=  LPS;
+    uint64_t      SR          = uint64_t( m_Range ) << ( 7 + VALUE_EXT_BITS );
+    if( m_Value < SR )
+    {
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+      CodingStatistics::UpdateCABACStat( *ptype, m_Range+LPS, m_Range, int( bin ) );
+#endif
+      // MPS path
+      if( m_Range < 256 )
+      {
+        int numBits   = rcProbModel.getRenormBitsRange( m_Range );
+        m_Range     <<= numBits;
+        m_Value     <<= numBits;
+        m_bitsNeeded += numBits;
+        if( m_bitsNeeded >= 0 )
+        {
+          refill();
+        }
+      }
+    }
+    else
+    {
+      bin = 1 - bin;
+#if RExt__DECODER_DEBUG_BIT_STATISTICS
+      CodingStatistics::UpdateCABACStat( *ptype, m_Range+LPS, LPS, int( bin ) );
+#endif
+      // LPS path
+      int numBits   = rcProbModel.getRenormBitsLPS( LPS );
+      m_Value      -= SR;
+      m_Value       = m_Value << numBits;
+      m_Range       = LPS     << numBits;
+      m_bitsNeeded += numBits;
+      if( m_bitsNeeded >= 0 )
+      {
+        refill();
+      }
+    }
+    rcProbModel.update( bin );
+    DTRACE_WITHOUT_COUNT( g_trace_ctx, D_CABAC, "  -  " "%d" "\n", bin );
+    return  bin;
+  }
 private:
   CtxStore<BinProbModel>& m_Ctx;
 };
@@ -468,6 +468,7 @@ DecLib::DecLib()
   , m_decodedPictureHashSEIEnabled(false)
   , m_numberOfChecksumErrorsDetected(0)
   , m_warningMessageSkipPicture(false)
+  , m_parseOnly(false)
   , m_prefixSEINALUs()
   , m_debugPOC( -1 )
   , m_debugCTU( -1 )
@@ -486,6 +487,9 @@ DecLib::DecLib()
 #if ENABLE_SIMD_OPT_BUFFER
   g_pelBufOP.initPelBufOpsX86();
 #endif
+#if ENABLE_SIMD_OPT_BITSTREAM
+  g_bitstreamOps.initBitstreamOpsX86();
+#endif
 }
 
 DecLib::~DecLib()
@@ -628,7 +632,7 @@ Picture* DecLib::xGetNewPicBuffer( const SPS &sps, const PPS &pps, const uint32_
 
 void DecLib::executeLoopFilters()
 {
-  if( !m_pcPic )
+  if( !m_pcPic || m_parseOnly )
   {
     return; // nothing to deblock
   }
@@ -129,6 +129,7 @@ private:
   uint32_t                    m_numberOfChecksumErrorsDetected;
 
   bool                    m_warningMessageSkipPicture;
+  bool                    m_parseOnly;                     ///< parse the slice data without reconstruction (benchmark mode)
 
   std::list<InputNALUnit*> m_prefixSEINALUs; /// Buffered up prefix SEI NAL Units.
   int                     m_debugPOC;
@@ -174,6 +175,8 @@ public:
   void  destroy ();
 
   void  setDecodedPictureHashSEIEnabled(int enabled) { m_decodedPictureHashSEIEnabled=enabled; }
+  void  setParseOnly                   (bool b)      { m_parseOnly = b; m_cSliceDecoder.setParseOnly( b ); }
+  uint64_t getNumBinsDecoded           () const      { return m_cSliceDecoder.getNumBinsDecoded(); }
 
   void  init(
 #if JVET_J0090_MEMORY_BANDWITH_MEASURE
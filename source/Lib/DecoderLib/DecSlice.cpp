@@ -49,6 +49,7 @@
 //////////////////////////////////////////////////////////////////////
 
 DecSlice::DecSlice()
+  : m_parseOnly( false )
 {
 }
 
@@ -231,7 +232,10 @@ void DecSlice::decompressSlice( Slice* slice, InputBitstream* bitstream, int deb
     }
     cabacReader.coding_tree_unit( cs, ctuArea, pic->m_prevQP, ctuRsAddr );
 
-    m_pcCuDecoder->decompressCtu( cs, ctuArea );
+    if( !m_parseOnly )
+    {
+      m_pcCuDecoder->decompressCtu( cs, ctuArea );
+    }
 
     if( ctuXPosInCtus == tileXPosInCtus && wavefrontsEnabled )
     {
@@ -61,6 +61,7 @@ private:
   // access channel
   CABACDecoder*   m_CABACDecoder;
   DecCu*          m_pcCuDecoder;
+  bool            m_parseOnly;                          ///< parse the CTUs without reconstructing them
 
   Ctx             m_entropyCodingSyncContextState;      ///< context storage for state of contexts at the wavefront/WPP/entropy-coding-sync second CTU of tile-row
 #if JVET_Q0501_PALETTE_WPP_INIT_ABOVECTU
@@ -76,6 +77,9 @@ public:
   void  destroy           ();
 
   void  decompressSlice   ( Slice* slice, InputBitstream* bitstream, int debugCTU );
+
+  void      setParseOnly      ( bool b )  { m_parseOnly = b; }
+  uint64_t  getNumBinsDecoded () const  { return m_CABACDecoder->getCABACReader( 0 )->get_num_bins_decoded(); }
 };
 
 //! \}
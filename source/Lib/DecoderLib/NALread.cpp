@@ -39,6 +39,7 @@
 
 #include <vector>
 #include <algorithm>
+#include <cstring>
 #include <ostream>
 
 #include "NALread.h"
@@ -58,33 +59,44 @@ using namespace std;
 //! \{
 static void convertPayloadToRBSP(vector<uint8_t>& nalUnitBuf, InputBitstream *bitstream, bool isVclNalUnit)
 {
-  uint32_t zeroCount = 0;
-  vector<uint8_t>::iterator it_read, it_write;
+  uint8_t*     buf      = nalUnitBuf.data();
+  const size_t size     = nalUnitBuf.size();
+  size_t       readPos  = 0;
+  size_t       writePos = 0;
 
-  uint32_t pos = 0;
   bitstream->clearEmulationPreventionByteLocation();
-  for (it_read = it_write = nalUnitBuf.begin(); it_read != nalUnitBuf.end(); it_read++, it_write++, pos++)
+  // jump from one 00 00 pair to the next and move the bytes in between in one go
+  while (readPos < size)
   {
-    CHECK(zeroCount >= 2 && *it_read < 0x03, "Zero count is '2' and read value is small than '3'");
-    if (zeroCount == 2 && *it_read == 0x03)
+    const size_t zeroPos = readPos + g_bitstreamOps.findZeroPair(buf + readPos, size - readPos);
+    const size_t copyEnd = std::min(zeroPos + 2, size);
+    if (writePos != readPos)
     {
-      bitstream->pushEmulationPreventionByteLocation( pos );
-      pos++;
-      it_read++;
-      zeroCount = 0;
+      memmove(buf + writePos, buf + readPos, copyEnd - readPos);
+    }
+    writePos += copyEnd - readPos;
+    readPos   = copyEnd;
+    if (readPos >= size)
+    {
+      break;
+    }
+    CHECK(buf[readPos] < 0x03, "Zero count is '2' and read value is small than '3'");
+    if (buf[readPos] == 0x03)
+    {
+      bitstream->pushEmulationPreventionByteLocation( uint32_t( readPos ) );
+      readPos++;
 #if RExt__DECODER_DEBUG_BIT_STATISTICS
       CodingStatistics::IncrementStatisticEP(STATS__EMULATION_PREVENTION_3_BYTES, 8, 0);
 #endif
-      if (it_read == nalUnitBuf.end())
+      if (readPos == size)
       {
         break;
       }
-      CHECK(*it_read > 0x03, "Read a value bigger than '3'");
+      CHECK(buf[readPos] > 0x03, "Read a value bigger than '3'");
     }
-    zeroCount = (*it_read == 0x00) ? zeroCount+1 : 0;
-    *it_write = *it_read;
   }
-  CHECK(zeroCount != 0, "Zero count not '0'");
+  CHECK(size > 0 && nalUnitBuf[size - 1] == 0x00, "Zero count not '0'");
+  vector<uint8_t>::iterator it_write = nalUnitBuf.begin() + writePos;
 
   if (isVclNalUnit)
   {
@@ -83,8 +83,9 @@ static std::vector<uint32_t> writeAnnexB(std::ostream& out, const AccessUnit& au
       out.write(reinterpret_cast<const char*>(start_code_prefix+1), 3);
       size += 3;
     }
-    out << nalu.m_nalUnitData.str();
-    size += uint32_t(nalu.m_nalUnitData.str().size());
+    const std::string nalUnitData = nalu.m_nalUnitData.str();
+    out.write(nalUnitData.data(), nalUnitData.size());
+    size += uint32_t(nalUnitData.size());
 
     annexBsizes.push_back(size);
   }
@@ -39,8 +39,20 @@
 #include "CommonLib/Picture.h"
 #include "CommonLib/CodingStructure.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #define AlfCtx(c) SubCtx( Ctx::Alf, c)
-std::vector<double> EncAdaptiveLoopFilter::m_lumaLevelToWeightPLUT;
+
+static int getNumStatsThreads( const int numCtus )
+{
+#ifdef _OPENMP
+  return std::max( 1, std::min( numCtus, omp_get_max_threads() ) );
+#else
+  return 1;
+#endif
+}
 
 #if JVET_Q0795_CCALF
 #include <algorithm>
@@ -486,14 +498,18 @@ void EncAdaptiveLoopFilter::create( const EncCfg* encCfg, const int picWidth, co
   {
     m_ctuEnableFlagTmp[compIdx] = new uint8_t[m_numCTUsInPic];
     m_ctuEnableFlagTmp2[compIdx] = new uint8_t[m_numCTUsInPic];
+    m_ctuEnableFlagDerived[compIdx] = new uint8_t[m_numCTUsInPic];
     if( isLuma( ComponentID(compIdx) ) )
     {
       m_ctuAlternativeTmp[compIdx] = nullptr;
+      m_ctuAlternativeDerived[compIdx] = nullptr;
     }
     else
     {
       m_ctuAlternativeTmp[compIdx] = new uint8_t[m_numCTUsInPic];
       std::fill_n( m_ctuAlternativeTmp[compIdx], m_numCTUsInPic, 0 );
+      m_ctuAlternativeDerived[compIdx] = new uint8_t[m_numCTUsInPic];
+      std::fill_n( m_ctuAlternativeDerived[compIdx], m_numCTUsInPic, 0 );
     }
     ChannelType chType = toChannelType( ComponentID( compIdx ) );
     int numClasses = compIdx ? 1 : MAX_NUM_ALF_CLASSES;
@@ -534,7 +550,7 @@ void EncAdaptiveLoopFilter::create( const EncCfg* encCfg, const int picWidth, co
   }
 
 
-  m_ctbDistortionFixedFilter = new double[m_numCTUsInPic];
+  m_ctbDistortionFilterSet = new double[m_numCTUsInPic * ( NUM_FIXED_FILTER_SETS + ALF_CTB_MAX_NUM_APS )];
   for (int comp = 0; comp < MAX_NUM_COMPONENT; comp++)
   {
     m_ctbDistortionUnfilter[comp] = new double[m_numCTUsInPic];
@@ -634,6 +650,18 @@ void EncAdaptiveLoopFilter::destroy()
       m_ctuAlternativeTmp[compIdx] = nullptr;
     }
 
+    if( m_ctuEnableFlagDerived[compIdx] )
+    {
+      delete[] m_ctuEnableFlagDerived[compIdx];
+      m_ctuEnableFlagDerived[compIdx] = nullptr;
+    }
+
+    if( m_ctuAlternativeDerived[compIdx] )
+    {
+      delete[] m_ctuAlternativeDerived[compIdx];
+      m_ctuAlternativeDerived[compIdx] = nullptr;
+    }
+
     if( m_alfCovariance[compIdx] )
     {
       ChannelType chType = toChannelType( ComponentID( compIdx ) );
@@ -702,8 +730,8 @@ void EncAdaptiveLoopFilter::destroy()
   }
 
 
-  delete[] m_ctbDistortionFixedFilter;
-  m_ctbDistortionFixedFilter = nullptr;
+  delete[] m_ctbDistortionFilterSet;
+  m_ctbDistortionFilterSet = nullptr;
   for (int comp = 0; comp < MAX_NUM_COMPONENT; comp++)
   {
     delete[] m_ctbDistortionUnfilter[comp];
@@ -1316,6 +1344,11 @@ void EncAdaptiveLoopFilter::alfEncoder( CodingStructure& cs, AlfParam& alfParam,
           copyCtuAlternativeChroma( m_ctuAlternativeTmp, m_ctuAlternative );
       }
 
+      // CTU decisions the current filters have been derived from
+      copyCtuEnableFlag( m_ctuEnableFlagDerived, m_ctuEnableFlag, channel );
+      if( isChroma( channel ) )
+        copyCtuAlternativeChroma( m_ctuAlternativeDerived, m_ctuAlternative );
+
       //3. CTU decision
       double distUnfilter = 0;
       double prevItCost = MAX_DOUBLE;
@@ -1348,12 +1381,22 @@ void EncAdaptiveLoopFilter::alfEncoder( CodingStructure& cs, AlfParam& alfParam,
             break;
           }
           prevItCost = cost;
+
+          if( isSameCtuEnableFlag( m_ctuEnableFlagDerived, m_ctuEnableFlag, channel ) && ( isLuma( channel ) || isSameCtuAlternativeChroma( m_ctuAlternativeDerived, m_ctuAlternative ) ) )
+          {
+            // Converged: re-deriving the filters from the same CTU decisions reproduces them exactly,
+            // so the next decision pass would return the same cost and terminate the loop anyway
+            break;
+          }
         }
         else
         {
           // unfiltered distortion is added due to some CTBs may not use filter
           // no need to reset CABAC here, since uiCoeffBits is not affected
           /*cost = */getFilterCoeffAndCost( cs, distUnfilter, channel, true, iShapeIdx, uiCoeffBits );
+          copyCtuEnableFlag( m_ctuEnableFlagDerived, m_ctuEnableFlag, channel );
+          if( isChroma( channel ) )
+            copyCtuAlternativeChroma( m_ctuAlternativeDerived, m_ctuAlternative );
         }
       }//for iter
       // Decrease number of alternatives and reset ctu params and filters
@@ -1554,8 +1597,8 @@ double EncAdaptiveLoopFilter::mergeFiltersAndCost( AlfParam& alfParam, AlfFilter
 {
   int numFiltersBest = 0;
   int numFilters = MAX_NUM_ALF_CLASSES;
-  static bool codedVarBins[MAX_NUM_ALF_CLASSES];
-  static double errorForce0CoeffTab[MAX_NUM_ALF_CLASSES][2];
+  static thread_local bool codedVarBins[MAX_NUM_ALF_CLASSES];
+  static thread_local double errorForce0CoeffTab[MAX_NUM_ALF_CLASSES][2];
 
   double cost, cost0, dist, distForce0, costMin = MAX_DOUBLE;
   int coeffBits, coeffBitsForce0;
@@ -1736,7 +1779,7 @@ int EncAdaptiveLoopFilter::lengthFilterCoeffs( AlfFilterShape& alfShape, const i
 
 double EncAdaptiveLoopFilter::getDistForce0( AlfFilterShape& alfShape, const int numFilters, double errorTabForce0Coeff[MAX_NUM_ALF_CLASSES][2], bool* codedVarBins )
 {
-  static int bitsVarBin[MAX_NUM_ALF_CLASSES];
+  static thread_local int bitsVarBin[MAX_NUM_ALF_CLASSES];
 
   for( int ind = 0; ind < numFilters; ++ind )
   {
@@ -1747,7 +1790,7 @@ double EncAdaptiveLoopFilter::getDistForce0( AlfFilterShape& alfShape, const int
     }
   }
 
-  static int zeroBitsVarBin = 0;
+  static thread_local int zeroBitsVarBin = 0;
   for (int i = 0; i < alfShape.numCoeff - 1; i++)
   {
     zeroBitsVarBin += lengthGolomb(0, 3);
@@ -1863,7 +1906,7 @@ double EncAdaptiveLoopFilter::deriveCoeffQuant( int *filterClipp, int *filterCoe
   const int min_value = -factor + 1;
 
 const int numCoeff = shape.numCoeff;
-  static double filterCoeff[MAX_NUM_ALF_LUMA_COEFF];
+  static thread_local double filterCoeff[MAX_NUM_ALF_LUMA_COEFF];
 
   cov.optimizeFilter( shape, filterClipp, filterCoeff, optimizeClip );
   roundFiltCoeff( filterCoeffQuant, filterCoeff, numCoeff, factor );
@@ -1946,13 +1989,13 @@ void EncAdaptiveLoopFilter::roundFiltCoeffCCALF( int *filterCoeffQuant, double *
 
 void EncAdaptiveLoopFilter::mergeClasses( const AlfFilterShape& alfShape, AlfCovariance* cov, AlfCovariance* covMerged, int clipMerged[MAX_NUM_ALF_CLASSES][MAX_NUM_ALF_CLASSES][MAX_NUM_ALF_LUMA_COEFF], const int numClasses, short filterIndices[MAX_NUM_ALF_CLASSES][MAX_NUM_ALF_CLASSES] )
 {
-  static int tmpClip[MAX_NUM_ALF_LUMA_COEFF];
-  static int bestMergeClip[MAX_NUM_ALF_LUMA_COEFF];
-  static double err[MAX_NUM_ALF_CLASSES];
-  static double bestMergeErr;
-  static bool availableClass[MAX_NUM_ALF_CLASSES];
-  static uint8_t indexList[MAX_NUM_ALF_CLASSES];
-  static uint8_t indexListTemp[MAX_NUM_ALF_CLASSES];
+  static thread_local int tmpClip[MAX_NUM_ALF_LUMA_COEFF];
+  static thread_local int bestMergeClip[MAX_NUM_ALF_LUMA_COEFF];
+  static thread_local double err[MAX_NUM_ALF_CLASSES];
+  static thread_local double bestMergeErr;
+  static thread_local bool availableClass[MAX_NUM_ALF_CLASSES];
+  static thread_local uint8_t indexList[MAX_NUM_ALF_CLASSES];
+  static thread_local uint8_t indexListTemp[MAX_NUM_ALF_CLASSES];
   int numRemaining = numClasses;
 
   memset( filterIndices, 0, sizeof( short ) * MAX_NUM_ALF_CLASSES * MAX_NUM_ALF_CLASSES );
@@ -2180,129 +2223,145 @@ void EncAdaptiveLoopFilter::deriveStatsForFiltering( PelUnitBuf& orgYuv, PelUnit
   int horVirBndryPos[] = { 0, 0, 0 };
   int verVirBndryPos[] = { 0, 0, 0 };
 
-  for( int yPos = 0; yPos < m_picHeight; yPos += m_maxCUHeight )
+  // CTUs crossed by virtual boundaries use the shared padding buffer m_tempBuf2, they are done in the sequential pass
+  std::vector<bool> isCrossed( m_numCTUsInPic );
+  for( int ctuRsAddr = 0; ctuRsAddr < m_numCTUsInPic; ctuRsAddr++ )
   {
-    for( int xPos = 0; xPos < m_picWidth; xPos += m_maxCUWidth )
+    const int xPos = ( ctuRsAddr % m_numCTUsInWidth ) * m_maxCUWidth;
+    const int yPos = ( ctuRsAddr / m_numCTUsInWidth ) * m_maxCUHeight;
+    const int width = ( xPos + m_maxCUWidth > m_picWidth ) ? ( m_picWidth - xPos ) : m_maxCUWidth;
+    const int height = ( yPos + m_maxCUHeight > m_picHeight ) ? ( m_picHeight - yPos ) : m_maxCUHeight;
+    int rasterSliceAlfPad = 0;
+    isCrossed[ctuRsAddr] = isCrossedByVirtualBoundaries( cs, xPos, yPos, width, height, clipTop, clipBottom, clipLeft, clipRight, numHorVirBndry, numVerVirBndry, horVirBndryPos, verVirBndryPos, rasterSliceAlfPad );
+  }
+
+  // the statistics of a CTU only depend on its own samples, the CTUs are independent
+  const int numThreads = getNumStatsThreads( m_numCTUsInPic );
+#pragma omp parallel for schedule(dynamic) num_threads(numThreads) if(numThreads > 1)
+  for( int ctuRsAddr = 0; ctuRsAddr < m_numCTUsInPic; ctuRsAddr++ )
+  {
+    if( isCrossed[ctuRsAddr] )
     {
-      const int width = ( xPos + m_maxCUWidth > m_picWidth ) ? ( m_picWidth - xPos ) : m_maxCUWidth;
-      const int height = ( yPos + m_maxCUHeight > m_picHeight ) ? ( m_picHeight - yPos ) : m_maxCUHeight;
-      int rasterSliceAlfPad = 0;
-      if( isCrossedByVirtualBoundaries( cs, xPos, yPos, width, height, clipTop, clipBottom, clipLeft, clipRight, numHorVirBndry, numVerVirBndry, horVirBndryPos, verVirBndryPos, rasterSliceAlfPad ) )
-      {
-        int yStart = yPos;
-        for( int i = 0; i <= numHorVirBndry; i++ )
-        {
-          const int yEnd = i == numHorVirBndry ? yPos + height : horVirBndryPos[i];
-          const int h = yEnd - yStart;
-          const bool clipT = ( i == 0 && clipTop ) || ( i > 0 ) || ( yStart == 0 );
-          const bool clipB = ( i == numHorVirBndry && clipBottom ) || ( i < numHorVirBndry ) || ( yEnd == pcv.lumaHeight );
-          int xStart = xPos;
-          for( int j = 0; j <= numVerVirBndry; j++ )
-          {
-            const int xEnd = j == numVerVirBndry ? xPos + width : verVirBndryPos[j];
-            const int w = xEnd - xStart;
-            const bool clipL = ( j == 0 && clipLeft ) || ( j > 0 ) || ( xStart == 0 );
-            const bool clipR = ( j == numVerVirBndry && clipRight ) || ( j < numVerVirBndry ) || ( xEnd == pcv.lumaWidth );
-            const int wBuf = w + (clipL ? 0 : MAX_ALF_PADDING_SIZE) + (clipR ? 0 : MAX_ALF_PADDING_SIZE);
-            const int hBuf = h + (clipT ? 0 : MAX_ALF_PADDING_SIZE) + (clipB ? 0 : MAX_ALF_PADDING_SIZE);
-            PelUnitBuf recBuf = m_tempBuf2.subBuf( UnitArea( cs.area.chromaFormat, Area( 0, 0, wBuf, hBuf ) ) );
-            recBuf.copyFrom( recYuv.subBuf( UnitArea( cs.area.chromaFormat, Area( xStart - (clipL ? 0 : MAX_ALF_PADDING_SIZE), yStart - (clipT ? 0 : MAX_ALF_PADDING_SIZE), wBuf, hBuf ) ) ) );
-            // pad top-left unavailable samples for raster slice
-            if ( xStart == xPos && yStart == yPos && ( rasterSliceAlfPad & 1 ) )
-            {
-              recBuf.padBorderPel( MAX_ALF_PADDING_SIZE, 1 );
-            }
+      continue;
+    }
+    const int xPos = ( ctuRsAddr % m_numCTUsInWidth ) * m_maxCUWidth;
+    const int yPos = ( ctuRsAddr / m_numCTUsInWidth ) * m_maxCUHeight;
+    const int width = ( xPos + m_maxCUWidth > m_picWidth ) ? ( m_picWidth - xPos ) : m_maxCUWidth;
+    const int height = ( yPos + m_maxCUHeight > m_picHeight ) ? ( m_picHeight - yPos ) : m_maxCUHeight;
+    const UnitArea area( m_chromaFormat, Area( xPos, yPos, width, height ) );
 
-            // pad bottom-right unavailable samples for raster slice
-            if ( xEnd == xPos + width && yEnd == yPos + height && ( rasterSliceAlfPad & 2 ) )
-            {
-              recBuf.padBorderPel( MAX_ALF_PADDING_SIZE, 2 );
-            }
-            recBuf.extendBorderPel( MAX_ALF_PADDING_SIZE );
-            recBuf = recBuf.subBuf( UnitArea ( cs.area.chromaFormat, Area( clipL ? 0 : MAX_ALF_PADDING_SIZE, clipT ? 0 : MAX_ALF_PADDING_SIZE, w, h ) ) );
+    for( int compIdx = 0; compIdx < numberOfComponents; compIdx++ )
+    {
+      const ComponentID compID = ComponentID( compIdx );
+      const CompArea& compArea = area.block( compID );
 
-            const UnitArea area( m_chromaFormat, Area( 0, 0, w, h ) );
-            const UnitArea areaDst( m_chromaFormat, Area( xStart, yStart, w, h ) );
-            for( int compIdx = 0; compIdx < numberOfComponents; compIdx++ )
-            {
-              const ComponentID compID = ComponentID( compIdx );
-              const CompArea& compArea = area.block( compID );
+      int  recStride = recYuv.get( compID ).stride;
+      Pel* rec = recYuv.get( compID ).bufAt( compArea );
 
-              int  recStride = recBuf.get( compID ).stride;
-              Pel* rec = recBuf.get( compID ).bufAt( compArea );
+      int  orgStride = orgYuv.get( compID ).stride;
+      Pel* org = orgYuv.get( compID ).bufAt( compArea );
 
-              int  orgStride = orgYuv.get(compID).stride;
-              Pel* org = orgYuv.get(compID).bufAt(xStart >> ::getComponentScaleX(compID, m_chromaFormat), yStart >> ::getComponentScaleY(compID, m_chromaFormat));
-              ChannelType chType = toChannelType( compID );
+      ChannelType chType = toChannelType( compID );
 
-              for( int shape = 0; shape != m_filterShapes[chType].size(); shape++ )
-              {
-              const CompArea& compAreaDst = areaDst.block( compID );
-                getBlkStats(m_alfCovariance[compIdx][shape][ctuRsAddr], m_filterShapes[chType][shape], compIdx ? nullptr : m_classifier, org, orgStride, rec, recStride, compAreaDst, compArea, chType
-                  , ((compIdx == 0) ? m_alfVBLumaCTUHeight : m_alfVBChmaCTUHeight)
-                  , (compIdx == 0) ? m_alfVBLumaPos : m_alfVBChmaPos
-                );
-              }
-            }
+      for( int shape = 0; shape != m_filterShapes[chType].size(); shape++ )
+      {
+        getBlkStats(m_alfCovariance[compIdx][shape][ctuRsAddr], m_filterShapes[chType][shape], compIdx ? nullptr : m_classifier, org, orgStride, rec, recStride, compArea, compArea, chType
+          , ((compIdx == 0) ? m_alfVBLumaCTUHeight : m_alfVBChmaCTUHeight)
+          , (compIdx == 0) ? m_alfVBLumaPos : m_alfVBChmaPos
+        );
+      }
+    }
+  }
 
-            xStart = xEnd;
+  // sequential pass in raster order, the frame statistics are summed in the same order for any number of threads
+  for( int ctuRsAddr = 0; ctuRsAddr < m_numCTUsInPic; ctuRsAddr++ )
+  {
+    if( isCrossed[ctuRsAddr] )
+    {
+      const int xPos = ( ctuRsAddr % m_numCTUsInWidth ) * m_maxCUWidth;
+      const int yPos = ( ctuRsAddr / m_numCTUsInWidth ) * m_maxCUHeight;
+      const int width = ( xPos + m_maxCUWidth > m_picWidth ) ? ( m_picWidth - xPos ) : m_maxCUWidth;
+      const int height = ( yPos + m_maxCUHeight > m_picHeight ) ? ( m_picHeight - yPos ) : m_maxCUHeight;
+      int rasterSliceAlfPad = 0;
+      isCrossedByVirtualBoundaries( cs, xPos, yPos, width, height, clipTop, clipBottom, clipLeft, clipRight, numHorVirBndry, numVerVirBndry, horVirBndryPos, verVirBndryPos, rasterSliceAlfPad );
+      int yStart = yPos;
+      for( int i = 0; i <= numHorVirBndry; i++ )
+      {
+        const int yEnd = i == numHorVirBndry ? yPos + height : horVirBndryPos[i];
+        const int h = yEnd - yStart;
+        const bool clipT = ( i == 0 && clipTop ) || ( i > 0 ) || ( yStart == 0 );
+        const bool clipB = ( i == numHorVirBndry && clipBottom ) || ( i < numHorVirBndry ) || ( yEnd == pcv.lumaHeight );
+        int xStart = xPos;
+        for( int j = 0; j <= numVerVirBndry; j++ )
+        {
+          const int xEnd = j == numVerVirBndry ? xPos + width : verVirBndryPos[j];
+          const int w = xEnd - xStart;
+          const bool clipL = ( j == 0 && clipLeft ) || ( j > 0 ) || ( xStart == 0 );
+          const bool clipR = ( j == numVerVirBndry && clipRight ) || ( j < numVerVirBndry ) || ( xEnd == pcv.lumaWidth );
+          const int wBuf = w + (clipL ? 0 : MAX_ALF_PADDING_SIZE) + (clipR ? 0 : MAX_ALF_PADDING_SIZE);
+          const int hBuf = h + (clipT ? 0 : MAX_ALF_PADDING_SIZE) + (clipB ? 0 : MAX_ALF_PADDING_SIZE);
+          PelUnitBuf recBuf = m_tempBuf2.subBuf( UnitArea( cs.area.chromaFormat, Area( 0, 0, wBuf, hBuf ) ) );
+          recBuf.copyFrom( recYuv.subBuf( UnitArea( cs.area.chromaFormat, Area( xStart - (clipL ? 0 : MAX_ALF_PADDING_SIZE), yStart - (clipT ? 0 : MAX_ALF_PADDING_SIZE), wBuf, hBuf ) ) ) );
+          // pad top-left unavailable samples for raster slice
+          if ( xStart == xPos && yStart == yPos && ( rasterSliceAlfPad & 1 ) )
+          {
+            recBuf.padBorderPel( MAX_ALF_PADDING_SIZE, 1 );
           }
 
-          yStart = yEnd;
-        }
+          // pad bottom-right unavailable samples for raster slice
+          if ( xEnd == xPos + width && yEnd == yPos + height && ( rasterSliceAlfPad & 2 ) )
+          {
+            recBuf.padBorderPel( MAX_ALF_PADDING_SIZE, 2 );
+          }
+          recBuf.extendBorderPel( MAX_ALF_PADDING_SIZE );
+          recBuf = recBuf.subBuf( UnitArea ( cs.area.chromaFormat, Area( clipL ? 0 : MAX_ALF_PADDING_SIZE, clipT ? 0 : MAX_ALF_PADDING_SIZE, w, h ) ) );
 
-        for( int compIdx = 0; compIdx < numberOfComponents; compIdx++ )
-        {
-          const ComponentID compID = ComponentID( compIdx );
+          const UnitArea area( m_chromaFormat, Area( 0, 0, w, h ) );
+          const UnitArea areaDst( m_chromaFormat, Area( xStart, yStart, w, h ) );
+          for( int compIdx = 0; compIdx < numberOfComponents; compIdx++ )
+          {
+            const ComponentID compID = ComponentID( compIdx );
+            const CompArea& compArea = area.block( compID );
 
-          ChannelType chType = toChannelType( compID );
+            int  recStride = recBuf.get( compID ).stride;
+            Pel* rec = recBuf.get( compID ).bufAt( compArea );
 
-          for( int shape = 0; shape != m_filterShapes[chType].size(); shape++ )
-          {
-            const int numClasses = isLuma( compID ) ? MAX_NUM_ALF_CLASSES : 1;
+            int  orgStride = orgYuv.get(compID).stride;
+            Pel* org = orgYuv.get(compID).bufAt(xStart >> ::getComponentScaleX(compID, m_chromaFormat), yStart >> ::getComponentScaleY(compID, m_chromaFormat));
+            ChannelType chType = toChannelType( compID );
 
-            for( int classIdx = 0; classIdx < numClasses; classIdx++ )
+            for( int shape = 0; shape != m_filterShapes[chType].size(); shape++ )
             {
-              m_alfCovarianceFrame[chType][shape][isLuma( compID ) ? classIdx : 0] += m_alfCovariance[compIdx][shape][ctuRsAddr][classIdx];
+            const CompArea& compAreaDst = areaDst.block( compID );
+              getBlkStats(m_alfCovariance[compIdx][shape][ctuRsAddr], m_filterShapes[chType][shape], compIdx ? nullptr : m_classifier, org, orgStride, rec, recStride, compAreaDst, compArea, chType
+                , ((compIdx == 0) ? m_alfVBLumaCTUHeight : m_alfVBChmaCTUHeight)
+                , (compIdx == 0) ? m_alfVBLumaPos : m_alfVBChmaPos
+              );
             }
           }
+
+          xStart = xEnd;
         }
-      }
-      else
-      {
-      const UnitArea area( m_chromaFormat, Area( xPos, yPos, width, height ) );
 
-      for( int compIdx = 0; compIdx < numberOfComponents; compIdx++ )
-      {
-        const ComponentID compID = ComponentID( compIdx );
-        const CompArea& compArea = area.block( compID );
+        yStart = yEnd;
+      }
+    }
 
-        int  recStride = recYuv.get( compID ).stride;
-        Pel* rec = recYuv.get( compID ).bufAt( compArea );
+    for( int compIdx = 0; compIdx < numberOfComponents; compIdx++ )
+    {
+      const ComponentID compID = ComponentID( compIdx );
 
-        int  orgStride = orgYuv.get( compID ).stride;
-        Pel* org = orgYuv.get( compID ).bufAt( compArea );
+      ChannelType chType = toChannelType( compID );
 
-        ChannelType chType = toChannelType( compID );
+      for( int shape = 0; shape != m_filterShapes[chType].size(); shape++ )
+      {
+        const int numClasses = isLuma( compID ) ? MAX_NUM_ALF_CLASSES : 1;
 
-        for( int shape = 0; shape != m_filterShapes[chType].size(); shape++ )
+        for( int classIdx = 0; classIdx < numClasses; classIdx++ )
         {
-          getBlkStats(m_alfCovariance[compIdx][shape][ctuRsAddr], m_filterShapes[chType][shape], compIdx ? nullptr : m_classifier, org, orgStride, rec, recStride, compArea, compArea, chType
-            , ((compIdx == 0) ? m_alfVBLumaCTUHeight : m_alfVBChmaCTUHeight)
-            , (compIdx == 0) ? m_alfVBLumaPos : m_alfVBChmaPos
-          );
-
-
-          const int numClasses = isLuma( compID ) ? MAX_NUM_ALF_CLASSES : 1;
-
-          for( int classIdx = 0; classIdx < numClasses; classIdx++ )
-          {
-            m_alfCovarianceFrame[chType][shape][isLuma( compID ) ? classIdx : 0] += m_alfCovariance[compIdx][shape][ctuRsAddr][classIdx];
-          }
+          m_alfCovarianceFrame[chType][shape][isLuma( compID ) ? classIdx : 0] += m_alfCovariance[compIdx][shape][ctuRsAddr][classIdx];
         }
       }
-      }
-      ctuRsAddr++;
     }
   }
 }
@@ -2311,9 +2370,11 @@ void EncAdaptiveLoopFilter::getBlkStats(AlfCovariance* alfCovariance, const AlfF
 
 
 {
-  static int ELocal[MAX_NUM_ALF_LUMA_COEFF][MaxAlfNumClippingValues];
+  // [bin][coeff]: the outer products below run over contiguous coefficients, local to be usable from several threads
+  int ELocal[MaxAlfNumClippingValues][MAX_NUM_ALF_LUMA_COEFF];
 
   const int numBins = AlfNumClippingValues[channel];
+  const int numCoeff = shape.numCoeff;
   int transposeIdx = 0;
   int classIdx = 0;
 
@@ -2341,34 +2402,45 @@ void EncAdaptiveLoopFilter::getBlkStats(AlfCovariance* alfCovariance, const AlfF
       }
       int yLocal = org[j] - rec[j];
       calcCovariance(ELocal, rec + j, recStride, shape, transposeIdx, channel, vbDistance);
-      for( int k = 0; k < shape.numCoeff; k++ )
+      // upper triangle l >= k of every bin pair, each element receives the same sums in the same order as before
+      AlfCovariance& cov = alfCovariance[classIdx];
+      for( int b0 = 0; b0 < numBins; b0++ )
       {
-        for( int l = k; l < shape.numCoeff; l++ )
+        for( int b1 = 0; b1 < numBins; b1++ )
         {
-          for( int b0 = 0; b0 < numBins; b0++ )
+          const int* e1 = ELocal[b1];
+          for( int k = 0; k < numCoeff; k++ )
           {
-            for( int b1 = 0; b1 < numBins; b1++ )
+            const int e0 = ELocal[b0][k];
+            double*   E  = cov.E[b0][b1][k];
+            if (m_alfWSSD)
             {
-              if (m_alfWSSD)
+              for( int l = k; l < numCoeff; l++ )
               {
-                alfCovariance[classIdx].E[b0][b1][k][l] += weight * (double)(ELocal[k][b0] * ELocal[l][b1]);
+                E[l] += weight * (double)(e0 * e1[l]);
               }
-              else
+            }
+            else
+            {
+              for( int l = k; l < numCoeff; l++ )
               {
-                alfCovariance[classIdx].E[b0][b1][k][l] += ELocal[k][b0] * ELocal[l][b1];
+                E[l] += e0 * e1[l];
               }
             }
           }
         }
-        for( int b = 0; b < numBins; b++ )
+      }
+      for( int b = 0; b < numBins; b++ )
+      {
+        for( int k = 0; k < numCoeff; k++ )
         {
           if (m_alfWSSD)
           {
-            alfCovariance[classIdx].y[b][k] += weight * (double)(ELocal[k][b] * yLocal);
+            cov.y[b][k] += weight * (double)(ELocal[b][k] * yLocal);
           }
           else
           {
-            alfCovariance[classIdx].y[b][k] += ELocal[k][b] * yLocal;
+            cov.y[b][k] += ELocal[b][k] * yLocal;
           }
         }
       }
@@ -2404,7 +2476,7 @@ void EncAdaptiveLoopFilter::getBlkStats(AlfCovariance* alfCovariance, const AlfF
   }
 }
 
-void EncAdaptiveLoopFilter::calcCovariance(int ELocal[MAX_NUM_ALF_LUMA_COEFF][MaxAlfNumClippingValues], const Pel *rec, const int stride, const AlfFilterShape& shape, const int transposeIdx, const ChannelType channel, int vbDistance)
+void EncAdaptiveLoopFilter::calcCovariance(int ELocal[MaxAlfNumClippingValues][MAX_NUM_ALF_LUMA_COEFF], const Pel *rec, const int stride, const AlfFilterShape& shape, const int transposeIdx, const ChannelType channel, int vbDistance)
 {
   int clipTopRow = -4;
   int clipBotRow = 4;
@@ -2437,7 +2509,7 @@ void EncAdaptiveLoopFilter::calcCovariance(int ELocal[MAX_NUM_ALF_LUMA_COEFF][Ma
       {
         for( int b = 0; b < numBins; b++ )
         {
-          ELocal[filterPattern[k]][b] += clipALF(clip[b], curr, rec0[j], rec1[-j]);
+          ELocal[b][filterPattern[k]] += clipALF(clip[b], curr, rec0[j], rec1[-j]);
         }
       }
     }
@@ -2445,7 +2517,7 @@ void EncAdaptiveLoopFilter::calcCovariance(int ELocal[MAX_NUM_ALF_LUMA_COEFF][Ma
     {
       for( int b = 0; b < numBins; b++ )
       {
-        ELocal[filterPattern[k]][b] += clipALF(clip[b], curr, rec[j], rec[-j]);
+        ELocal[b][filterPattern[k]] += clipALF(clip[b], curr, rec[j], rec[-j]);
       }
     }
   }
@@ -2459,7 +2531,7 @@ void EncAdaptiveLoopFilter::calcCovariance(int ELocal[MAX_NUM_ALF_LUMA_COEFF][Ma
       {
         for (int b = 0; b < numBins; b++)
         {
-          ELocal[filterPattern[k]][b] += clipALF(clip[b], curr, rec0[std::max(i, clipTopRow) * stride], rec1[-std::max(i, -clipBotRow) * stride]);
+          ELocal[b][filterPattern[k]] += clipALF(clip[b], curr, rec0[std::max(i, clipTopRow) * stride], rec1[-std::max(i, -clipBotRow) * stride]);
         }
     }
     }
@@ -2467,7 +2539,7 @@ void EncAdaptiveLoopFilter::calcCovariance(int ELocal[MAX_NUM_ALF_LUMA_COEFF][Ma
     {
       for (int b = 0; b < numBins; b++)
       {
-        ELocal[filterPattern[k]][b] += clipALF(clip[b], curr, rec[std::max(i, clipTopRow) * stride], rec[-std::max(i, -clipBotRow) * stride]);
+        ELocal[b][filterPattern[k]] += clipALF(clip[b], curr, rec[std::max(i, clipTopRow) * stride], rec[-std::max(i, -clipBotRow) * stride]);
       }
     }
   }
@@ -2482,7 +2554,7 @@ void EncAdaptiveLoopFilter::calcCovariance(int ELocal[MAX_NUM_ALF_LUMA_COEFF][Ma
       {
         for( int b = 0; b < numBins; b++ )
         {
-          ELocal[filterPattern[k]][b] += clipALF(clip[b], curr, rec0[j], rec1[-j]);
+          ELocal[b][filterPattern[k]] += clipALF(clip[b], curr, rec0[j], rec1[-j]);
         }
       }
     }
@@ -2490,7 +2562,7 @@ void EncAdaptiveLoopFilter::calcCovariance(int ELocal[MAX_NUM_ALF_LUMA_COEFF][Ma
     {
       for( int b = 0; b < numBins; b++ )
       {
-        ELocal[filterPattern[k]][b] += clipALF(clip[b], curr, rec[j], rec[-j]);
+        ELocal[b][filterPattern[k]] += clipALF(clip[b], curr, rec[j], rec[-j]);
       }
     }
   }
@@ -2504,7 +2576,7 @@ void EncAdaptiveLoopFilter::calcCovariance(int ELocal[MAX_NUM_ALF_LUMA_COEFF][Ma
       {
         for (int b = 0; b < numBins; b++)
         {
-          ELocal[filterPattern[k]][b] += clipALF(clip[b], curr, rec0[std::max(i, clipTopRow) * stride], rec1[-std::max(i, -clipBotRow) * stride]);
+          ELocal[b][filterPattern[k]] += clipALF(clip[b], curr, rec0[std::max(i, clipTopRow) * stride], rec1[-std::max(i, -clipBotRow) * stride]);
         }
       }
     }
@@ -2512,14 +2584,14 @@ void EncAdaptiveLoopFilter::calcCovariance(int ELocal[MAX_NUM_ALF_LUMA_COEFF][Ma
     {
       for (int b = 0; b < numBins; b++)
       {
-        ELocal[filterPattern[k]][b] += clipALF(clip[b], curr, rec[std::max(i, clipTopRow) * stride], rec[-std::max(i, -clipBotRow) * stride]);
+        ELocal[b][filterPattern[k]] += clipALF(clip[b], curr, rec[std::max(i, clipTopRow) * stride], rec[-std::max(i, -clipBotRow) * stride]);
       }
     }
 
   }
   for( int b = 0; b < numBins; b++ )
   {
-    ELocal[filterPattern[k]][b] += curr;
+    ELocal[b][filterPattern[k]] += curr;
   }
 }
 
@@ -2568,6 +2640,16 @@ void EncAdaptiveLoopFilter::copyCtuEnableFlag( uint8_t** ctuFlagsDst, uint8_t**
   }
 }
 
+bool EncAdaptiveLoopFilter::isSameCtuEnableFlag( uint8_t** ctuFlagsA, uint8_t** ctuFlagsB, ChannelType channel )
+{
+  if( isLuma( channel ) )
+  {
+    return !memcmp( ctuFlagsA[COMPONENT_Y], ctuFlagsB[COMPONENT_Y], sizeof( uint8_t ) * m_numCTUsInPic );
+  }
+  return !memcmp( ctuFlagsA[COMPONENT_Cb], ctuFlagsB[COMPONENT_Cb], sizeof( uint8_t ) * m_numCTUsInPic )
+      && !memcmp( ctuFlagsA[COMPONENT_Cr], ctuFlagsB[COMPONENT_Cr], sizeof( uint8_t ) * m_numCTUsInPic );
+}
+
 void EncAdaptiveLoopFilter::setCtuEnableFlag( uint8_t** ctuFlags, ChannelType channel, uint8_t val )
 {
   if( isLuma( channel ) )
@@ -2625,6 +2707,34 @@ void  EncAdaptiveLoopFilter::initDistortion()
     }
   }
 }
+double EncAdaptiveLoopFilter::getCtbDistortionFixedFilterSet( const int ctbIdx, const int filterSetIdx )
+{
+  double dist = m_ctbDistortionUnfilter[COMPONENT_Y][ctbIdx];
+  for (int classIdx = 0; classIdx < MAX_NUM_ALF_CLASSES; classIdx++)
+  {
+    int filterIdx = m_classToFilterMapping[filterSetIdx][classIdx];
+    dist += m_alfCovariance[COMPONENT_Y][0][ctbIdx][classIdx].calcErrorForCoeffs(m_clipDefaultEnc, m_fixedFilterSetCoeff[filterIdx], MAX_NUM_ALF_LUMA_COEFF, m_NUM_BITS);
+  }
+  return dist;
+}
+
+double EncAdaptiveLoopFilter::getCtbDistortionFilterSet( const int ctbIdx, const short* pCoeff, const short* pClipp )
+{
+  int filterTmp[MAX_NUM_ALF_LUMA_COEFF];
+  int clipTmp[MAX_NUM_ALF_LUMA_COEFF];
+  double dist = m_ctbDistortionUnfilter[COMPONENT_Y][ctbIdx];
+  for (int classIdx = 0; classIdx < MAX_NUM_ALF_CLASSES; classIdx++)
+  {
+    for (int i = 0; i < MAX_NUM_ALF_LUMA_COEFF; i++)
+    {
+      filterTmp[i] = pCoeff[classIdx * MAX_NUM_ALF_LUMA_COEFF + i];
+      clipTmp[i] = pClipp[classIdx * MAX_NUM_ALF_LUMA_COEFF + i];
+    }
+    dist += m_alfCovariance[COMPONENT_Y][0][ctbIdx][classIdx].calcErrorForCoeffs(clipTmp, filterTmp, MAX_NUM_ALF_LUMA_COEFF, m_NUM_BITS);
+  }
+  return dist;
+}
+
 void  EncAdaptiveLoopFilter::alfEncoderCtb(CodingStructure& cs, AlfParam& alfParamNewFilters
 #if ENABLE_QPA
   , const double lambdaChromaWeight
@@ -2656,6 +2766,21 @@ void  EncAdaptiveLoopFilter::alfEncoderCtb(CodingStructure& cs, AlfParam& alfPar
   double costMin = MAX_DOUBLE;
   reconstructCoeffAPSs(cs, true, false, true);
 
+  // The distortions of the fixed and the previously signalled filter sets do not depend on the
+  // APS configuration under test, so they are derived once per CTU and reused by all passes
+  const int numCachedFilterSets = NUM_FIXED_FILTER_SETS + (int)apsIds.size();
+  const int numThreads = getNumStatsThreads( m_numCTUsInPic );
+#pragma omp parallel for schedule(dynamic) num_threads(numThreads) if(numThreads > 1)
+  for (int ctbIdx = 0; ctbIdx < m_numCTUsInPic; ctbIdx++)
+  {
+    double* ctbDist = m_ctbDistortionFilterSet + ctbIdx * (NUM_FIXED_FILTER_SETS + ALF_CTB_MAX_NUM_APS);
+    for (int filterSetIdx = 0; filterSetIdx < numCachedFilterSets; filterSetIdx++)
+    {
+      ctbDist[filterSetIdx] = filterSetIdx < NUM_FIXED_FILTER_SETS ? getCtbDistortionFixedFilterSet(ctbIdx, filterSetIdx)
+                                                                   : getCtbDistortionFilterSet(ctbIdx, m_coeffApsLuma[filterSetIdx - NUM_FIXED_FILTER_SETS], m_clippApsLuma[filterSetIdx - NUM_FIXED_FILTER_SETS]);
+    }
+  }
+
   int numLoops = hasNewFilters[CHANNEL_TYPE_LUMA] ? 2 : 1;
   for (int useNewFilter = 0; useNewFilter < numLoops; useNewFilter++)
   {
@@ -2767,6 +2892,7 @@ void  EncAdaptiveLoopFilter::alfEncoderCtb(CodingStructure& cs, AlfParam& alfPar
         for (int ctbIdx = 0; ctbIdx < m_numCTUsInPic; ctbIdx++)
         {
           double distUnfilterCtb = m_ctbDistortionUnfilter[COMPONENT_Y][ctbIdx];
+          const double* ctbDist = m_ctbDistortionFilterSet + ctbIdx * (NUM_FIXED_FILTER_SETS + ALF_CTB_MAX_NUM_APS);
           //ctb on
           m_ctuEnableFlag[COMPONENT_Y][ctbIdx] = 1;
           double         costOn = MAX_DOUBLE;
@@ -2782,40 +2908,18 @@ void  EncAdaptiveLoopFilter::alfEncoderCtb(CodingStructure& cs, AlfParam& alfPar
             m_CABACEstimator->codeAlfCtuFilterIndex(cs, ctbIdx, &m_alfParamTemp.enabledFlag[COMPONENT_Y]);
             double rateOn = FRAC_BITS_SCALE * m_CABACEstimator->getEstFracBits();
             //distortion
-            double dist = distUnfilterCtb;
-            for (int classIdx = 0; classIdx < MAX_NUM_ALF_CLASSES; classIdx++)
+            double dist;
+            if (filterSetIdx < NUM_FIXED_FILTER_SETS)
             {
-              if (filterSetIdx < NUM_FIXED_FILTER_SETS)
-              {
-                int filterIdx = m_classToFilterMapping[filterSetIdx][classIdx];
-                dist += m_alfCovariance[COMPONENT_Y][0][ctbIdx][classIdx].calcErrorForCoeffs(m_clipDefaultEnc, m_fixedFilterSetCoeff[filterIdx], MAX_NUM_ALF_LUMA_COEFF, m_NUM_BITS);
-              }
-              else
-              {
-                short *pCoeff;
-                short *pClipp;
-                if (useNewFilter && filterSetIdx == NUM_FIXED_FILTER_SETS)
-                {
-                  pCoeff = m_coeffFinal;
-                  pClipp = m_clippFinal;
-                }
-                else if (useNewFilter)
-                {
-                  pCoeff = m_coeffApsLuma[filterSetIdx - 1 - NUM_FIXED_FILTER_SETS];
-                  pClipp = m_clippApsLuma[filterSetIdx - 1 - NUM_FIXED_FILTER_SETS];
-                }
-                else
-                {
-                  pCoeff = m_coeffApsLuma[filterSetIdx - NUM_FIXED_FILTER_SETS];
-                  pClipp = m_clippApsLuma[filterSetIdx - NUM_FIXED_FILTER_SETS];
-                }
-                for (int i = 0; i < MAX_NUM_ALF_LUMA_COEFF; i++)
-                {
-                  m_filterTmp[i] = pCoeff[classIdx * MAX_NUM_ALF_LUMA_COEFF + i];
-                  m_clipTmp[i] = pClipp[classIdx * MAX_NUM_ALF_LUMA_COEFF + i];
-                }
-                dist += m_alfCovariance[COMPONENT_Y][0][ctbIdx][classIdx].calcErrorForCoeffs(m_clipTmp, m_filterTmp, MAX_NUM_ALF_LUMA_COEFF, m_NUM_BITS);
-              }
+              dist = ctbDist[filterSetIdx];
+            }
+            else if (useNewFilter && filterSetIdx == NUM_FIXED_FILTER_SETS)
+            {
+              dist = getCtbDistortionFilterSet(ctbIdx, m_coeffFinal, m_clippFinal);
+            }
+            else
+            {
+              dist = ctbDist[filterSetIdx - useNewFilter];
             }
             //cost
             double costOnTmp = dist + m_lambda[COMPONENT_Y] * rateOn;
@@ -3303,6 +3407,12 @@ void EncAdaptiveLoopFilter::copyCtuAlternativeChroma( uint8_t* ctuAltsDst[MAX_NU
   std::copy_n( ctuAltsSrc[COMPONENT_Cr], m_numCTUsInPic, ctuAltsDst[COMPONENT_Cr] );
 }
 
+bool EncAdaptiveLoopFilter::isSameCtuAlternativeChroma( uint8_t* ctuAltsA[MAX_NUM_COMPONENT], uint8_t* ctuAltsB[MAX_NUM_COMPONENT] )
+{
+  return std::equal( ctuAltsA[COMPONENT_Cb], ctuAltsA[COMPONENT_Cb] + m_numCTUsInPic, ctuAltsB[COMPONENT_Cb] )
+      && std::equal( ctuAltsA[COMPONENT_Cr], ctuAltsA[COMPONENT_Cr] + m_numCTUsInPic, ctuAltsB[COMPONENT_Cr] );
+}
+
 void EncAdaptiveLoopFilter::setCtuAlternativeChroma( uint8_t* ctuAlts[MAX_NUM_COMPONENT], uint8_t val )
 {
   std::fill_n( ctuAlts[COMPONENT_Cb], m_numCTUsInPic, val );
@@ -3372,8 +3482,8 @@ void EncAdaptiveLoopFilter::deriveCcAlfFilterCoeff( ComponentID compID, const Pe
   using TE = double[MAX_NUM_ALF_LUMA_COEFF][MAX_NUM_ALF_LUMA_COEFF];
   using Ty = double[MAX_NUM_ALF_LUMA_COEFF];
 
-  static double filterCoeffDbl[MAX_NUM_CC_ALF_CHROMA_COEFF];
-  static int    filterCoeffInt[MAX_NUM_CC_ALF_CHROMA_COEFF];
+  static thread_local double filterCoeffDbl[MAX_NUM_CC_ALF_CHROMA_COEFF];
+  static thread_local int    filterCoeffInt[MAX_NUM_CC_ALF_CHROMA_COEFF];
 
   TE        kE;
   Ty        ky;
@@ -3739,9 +3849,9 @@ void EncAdaptiveLoopFilter::deriveCcAlfFilter( CodingStructure& cs, ComponentID
                                  cs.pcv->maxCUHeightLog2 - scaleY, unfilteredDistortion);
   double bestUnfilteredTotalCost = 1 * m_lambda[compID] + unfilteredDistortion;   // 1 bit is for gating flag
 
-  static bool  ccAlfFilterIdxEnabled[MAX_NUM_CC_ALF_FILTERS];
-  static short ccAlfFilterCoeff[MAX_NUM_CC_ALF_FILTERS][MAX_NUM_CC_ALF_CHROMA_COEFF];
-  static uint8_t ccAlfFilterCount     = MAX_NUM_CC_ALF_FILTERS;
+  static thread_local bool  ccAlfFilterIdxEnabled[MAX_NUM_CC_ALF_FILTERS];
+  static thread_local short ccAlfFilterCoeff[MAX_NUM_CC_ALF_FILTERS][MAX_NUM_CC_ALF_CHROMA_COEFF];
+  static thread_local uint8_t ccAlfFilterCount     = MAX_NUM_CC_ALF_FILTERS;
   double bestFilteredTotalCost        = MAX_DOUBLE;
   bool   bestreuseTemporalFilterCoeff = false;
   std::vector<int> apsIds             = getAvailableCcAlfApsIds(cs, compID);
@@ -3996,96 +4106,127 @@ void EncAdaptiveLoopFilter::deriveStatsForCcAlfFiltering(const PelUnitBuf &orgYu
     m_alfCovarianceFrameCcAlf[compIdx - 1][shape][filterIdx].reset();
   }
 
-  int                  ctuRsAddr = 0;
   const PreCalcValues &pcv       = *cs.pcv;
   bool                 clipTop = false, clipBottom = false, clipLeft = false, clipRight = false;
   int                  numHorVirBndry = 0, numVerVirBndry = 0;
   int                  horVirBndryPos[] = { 0, 0, 0 };
   int                  verVirBndryPos[] = { 0, 0, 0 };
 
-  for (int yPos = 0; yPos < m_picHeight; yPos += m_maxCUHeight)
+  // CTUs crossed by virtual boundaries use the shared padding buffer m_tempBuf2, they are done in the sequential pass
+  std::vector<bool> isCrossed(m_numCTUsInPic, false);
+  for (int ctuRsAddr = 0; ctuRsAddr < m_numCTUsInPic; ctuRsAddr++)
   {
-    for (int xPos = 0; xPos < m_picWidth; xPos += m_maxCUWidth)
+    if (m_trainingCovControl[ctuRsAddr] == filterIdc)
     {
-      if (m_trainingCovControl[ctuRsAddr] == filterIdc)
-      {
-        const int width             = (xPos + m_maxCUWidth > m_picWidth) ? (m_picWidth - xPos) : m_maxCUWidth;
-        const int height            = (yPos + m_maxCUHeight > m_picHeight) ? (m_picHeight - yPos) : m_maxCUHeight;
-        int       rasterSliceAlfPad = 0;
-        if (isCrossedByVirtualBoundaries(cs, xPos, yPos, width, height, clipTop, clipBottom, clipLeft, clipRight,
-                                         numHorVirBndry, numVerVirBndry, horVirBndryPos, verVirBndryPos,
-                                         rasterSliceAlfPad))
-        {
-          int yStart = yPos;
-          for (int i = 0; i <= numHorVirBndry; i++)
-          {
-            const int  yEnd   = i == numHorVirBndry ? yPos + height : horVirBndryPos[i];
-            const int  h      = yEnd - yStart;
-            const bool clipT  = (i == 0 && clipTop) || (i > 0) || (yStart == 0);
-            const bool clipB  = (i == numHorVirBndry && clipBottom) || (i < numHorVirBndry) || (yEnd == pcv.lumaHeight);
-            int        xStart = xPos;
-            for (int j = 0; j <= numVerVirBndry; j++)
-            {
-              const int  xEnd   = j == numVerVirBndry ? xPos + width : verVirBndryPos[j];
-              const int  w      = xEnd - xStart;
-              const bool clipL  = (j == 0 && clipLeft) || (j > 0) || (xStart == 0);
-              const bool clipR  = (j == numVerVirBndry && clipRight) || (j < numVerVirBndry) || (xEnd == pcv.lumaWidth);
-              const int  wBuf   = w + (clipL ? 0 : MAX_ALF_PADDING_SIZE) + (clipR ? 0 : MAX_ALF_PADDING_SIZE);
-              const int  hBuf   = h + (clipT ? 0 : MAX_ALF_PADDING_SIZE) + (clipB ? 0 : MAX_ALF_PADDING_SIZE);
-              PelUnitBuf recBuf = m_tempBuf2.subBuf(UnitArea(cs.area.chromaFormat, Area(0, 0, wBuf, hBuf)));
-              recBuf.copyFrom(recYuv.subBuf(
-                UnitArea(cs.area.chromaFormat, Area(xStart - (clipL ? 0 : MAX_ALF_PADDING_SIZE),
-                                                    yStart - (clipT ? 0 : MAX_ALF_PADDING_SIZE), wBuf, hBuf))));
-              // pad top-left unavailable samples for raster slice
-              if (xStart == xPos && yStart == yPos && (rasterSliceAlfPad & 1))
-              {
-                recBuf.padBorderPel(MAX_ALF_PADDING_SIZE, 1);
-              }
-
-              // pad bottom-right unavailable samples for raster slice
-              if (xEnd == xPos + width && yEnd == yPos + height && (rasterSliceAlfPad & 2))
-              {
-                recBuf.padBorderPel(MAX_ALF_PADDING_SIZE, 2);
-              }
-              recBuf.extendBorderPel(MAX_ALF_PADDING_SIZE);
-              recBuf = recBuf.subBuf(UnitArea(
-                cs.area.chromaFormat, Area(clipL ? 0 : MAX_ALF_PADDING_SIZE, clipT ? 0 : MAX_ALF_PADDING_SIZE, w, h)));
+      const int xPos              = (ctuRsAddr % m_numCTUsInWidth) * m_maxCUWidth;
+      const int yPos              = (ctuRsAddr / m_numCTUsInWidth) * m_maxCUHeight;
+      const int width             = (xPos + m_maxCUWidth > m_picWidth) ? (m_picWidth - xPos) : m_maxCUWidth;
+      const int height            = (yPos + m_maxCUHeight > m_picHeight) ? (m_picHeight - yPos) : m_maxCUHeight;
+      int       rasterSliceAlfPad = 0;
+      isCrossed[ctuRsAddr] = isCrossedByVirtualBoundaries(cs, xPos, yPos, width, height, clipTop, clipBottom, clipLeft,
+                                                          clipRight, numHorVirBndry, numVerVirBndry, horVirBndryPos,
+                                                          verVirBndryPos, rasterSliceAlfPad);
+    }
+  }
 
-              const UnitArea area(m_chromaFormat, Area(0, 0, w, h));
-              const UnitArea areaDst(m_chromaFormat, Area(xStart, yStart, w, h));
+  const ComponentID compID = ComponentID(compIdx);
 
-              const ComponentID compID = ComponentID(compIdx);
+  const int numThreads = getNumStatsThreads(m_numCTUsInPic);
+#pragma omp parallel for schedule(dynamic) num_threads(numThreads) if(numThreads > 1)
+  for (int ctuRsAddr = 0; ctuRsAddr < m_numCTUsInPic; ctuRsAddr++)
+  {
+    if (m_trainingCovControl[ctuRsAddr] != filterIdc || isCrossed[ctuRsAddr])
+    {
+      continue;
+    }
+    const int      xPos   = (ctuRsAddr % m_numCTUsInWidth) * m_maxCUWidth;
+    const int      yPos   = (ctuRsAddr / m_numCTUsInWidth) * m_maxCUHeight;
+    const int      width  = (xPos + m_maxCUWidth > m_picWidth) ? (m_picWidth - xPos) : m_maxCUWidth;
+    const int      height = (yPos + m_maxCUHeight > m_picHeight) ? (m_picHeight - yPos) : m_maxCUHeight;
+    const UnitArea area(m_chromaFormat, Area(xPos, yPos, width, height));
 
-              for (int shape = 0; shape != m_filterShapesCcAlf[compIdx - 1].size(); shape++)
-              {
-                getBlkStatsCcAlf(m_alfCovarianceCcAlf[compIdx - 1][0][filterIdx][ctuRsAddr],
-                                 m_filterShapesCcAlf[compIdx - 1][shape], orgYuv, recBuf, areaDst, area, compID, yPos);
-                m_alfCovarianceFrameCcAlf[compIdx - 1][shape][filterIdx] +=
-                  m_alfCovarianceCcAlf[compIdx - 1][shape][filterIdx][ctuRsAddr];
-              }
+    for (int shape = 0; shape != m_filterShapesCcAlf[compIdx - 1].size(); shape++)
+    {
+      getBlkStatsCcAlf(m_alfCovarianceCcAlf[compIdx - 1][0][filterIdx][ctuRsAddr],
+                       m_filterShapesCcAlf[compIdx - 1][shape], orgYuv, recYuv, area, area, compID, yPos);
+    }
+  }
 
-              xStart = xEnd;
-            }
+  // sequential pass in raster order, the frame statistics are summed in the same order for any number of threads
+  for (int ctuRsAddr = 0; ctuRsAddr < m_numCTUsInPic; ctuRsAddr++)
+  {
+    if (m_trainingCovControl[ctuRsAddr] != filterIdc)
+    {
+      continue;
+    }
+    if (isCrossed[ctuRsAddr])
+    {
+      const int xPos              = (ctuRsAddr % m_numCTUsInWidth) * m_maxCUWidth;
+      const int yPos              = (ctuRsAddr / m_numCTUsInWidth) * m_maxCUHeight;
+      const int width             = (xPos + m_maxCUWidth > m_picWidth) ? (m_picWidth - xPos) : m_maxCUWidth;
+      const int height            = (yPos + m_maxCUHeight > m_picHeight) ? (m_picHeight - yPos) : m_maxCUHeight;
+      int       rasterSliceAlfPad = 0;
+      isCrossedByVirtualBoundaries(cs, xPos, yPos, width, height, clipTop, clipBottom, clipLeft, clipRight,
+                                   numHorVirBndry, numVerVirBndry, horVirBndryPos, verVirBndryPos, rasterSliceAlfPad);
+      int yStart = yPos;
+      for (int i = 0; i <= numHorVirBndry; i++)
+      {
+        const int  yEnd   = i == numHorVirBndry ? yPos + height : horVirBndryPos[i];
+        const int  h      = yEnd - yStart;
+        const bool clipT  = (i == 0 && clipTop) || (i > 0) || (yStart == 0);
+        const bool clipB  = (i == numHorVirBndry && clipBottom) || (i < numHorVirBndry) || (yEnd == pcv.lumaHeight);
+        int        xStart = xPos;
+        for (int j = 0; j <= numVerVirBndry; j++)
+        {
+          const int  xEnd   = j == numVerVirBndry ? xPos + width : verVirBndryPos[j];
+          const int  w      = xEnd - xStart;
+          const bool clipL  = (j == 0 && clipLeft) || (j > 0) || (xStart == 0);
+          const bool clipR  = (j == numVerVirBndry && clipRight) || (j < numVerVirBndry) || (xEnd == pcv.lumaWidth);
+          const int  wBuf   = w + (clipL ? 0 : MAX_ALF_PADDING_SIZE) + (clipR ? 0 : MAX_ALF_PADDING_SIZE);
+          const int  hBuf   = h + (clipT ? 0 : MAX_ALF_PADDING_SIZE) + (clipB ? 0 : MAX_ALF_PADDING_SIZE);
+          PelUnitBuf recBuf = m_tempBuf2.subBuf(UnitArea(cs.area.chromaFormat, Area(0, 0, wBuf, hBuf)));
+          recBuf.copyFrom(recYuv.subBuf(
+            UnitArea(cs.area.chromaFormat, Area(xStart - (clipL ? 0 : MAX_ALF_PADDING_SIZE),
+                                                yStart - (clipT ? 0 : MAX_ALF_PADDING_SIZE), wBuf, hBuf))));
+          // pad top-left unavailable samples for raster slice
+          if (xStart == xPos && yStart == yPos && (rasterSliceAlfPad & 1))
+          {
+            recBuf.padBorderPel(MAX_ALF_PADDING_SIZE, 1);
+          }
 
-            yStart = yEnd;
+          // pad bottom-right unavailable samples for raster slice
+          if (xEnd == xPos + width && yEnd == yPos + height && (rasterSliceAlfPad & 2))
+          {
+            recBuf.padBorderPel(MAX_ALF_PADDING_SIZE, 2);
           }
-        }
-        else
-        {
-          const UnitArea area(m_chromaFormat, Area(xPos, yPos, width, height));
+          recBuf.extendBorderPel(MAX_ALF_PADDING_SIZE);
+          recBuf = recBuf.subBuf(UnitArea(
+            cs.area.chromaFormat, Area(clipL ? 0 : MAX_ALF_PADDING_SIZE, clipT ? 0 : MAX_ALF_PADDING_SIZE, w, h)));
 
-          const ComponentID compID = ComponentID(compIdx);
+          const UnitArea area(m_chromaFormat, Area(0, 0, w, h));
+          const UnitArea areaDst(m_chromaFormat, Area(xStart, yStart, w, h));
 
           for (int shape = 0; shape != m_filterShapesCcAlf[compIdx - 1].size(); shape++)
           {
             getBlkStatsCcAlf(m_alfCovarianceCcAlf[compIdx - 1][0][filterIdx][ctuRsAddr],
-                             m_filterShapesCcAlf[compIdx - 1][shape], orgYuv, recYuv, area, area, compID, yPos);
+                             m_filterShapesCcAlf[compIdx - 1][shape], orgYuv, recBuf, areaDst, area, compID, yPos);
             m_alfCovarianceFrameCcAlf[compIdx - 1][shape][filterIdx] +=
               m_alfCovarianceCcAlf[compIdx - 1][shape][filterIdx][ctuRsAddr];
           }
+
+          xStart = xEnd;
         }
+
+        yStart = yEnd;
+      }
+    }
+    else
+    {
+      for (int shape = 0; shape != m_filterShapesCcAlf[compIdx - 1].size(); shape++)
+      {
+        m_alfCovarianceFrameCcAlf[compIdx - 1][shape][filterIdx] +=
+          m_alfCovarianceCcAlf[compIdx - 1][shape][filterIdx][ctuRsAddr];
       }
-      ctuRsAddr++;
     }
   }
 }
@@ -229,7 +229,7 @@ class EncAdaptiveLoopFilter : public AdaptiveLoopFilter
 {
 public:
   inline void           setAlfWSSD(int alfWSSD) { m_alfWSSD = alfWSSD; }
-  static std::vector<double>  m_lumaLevelToWeightPLUT;
+  std::vector<double>         m_lumaLevelToWeightPLUT;
   inline std::vector<double>& getLumaLevelWeightTable() { return m_lumaLevelToWeightPLUT; }
 
 private:
@@ -240,6 +240,8 @@ private:
   uint8_t*               m_ctuEnableFlagTmp[MAX_NUM_COMPONENT];
   uint8_t*               m_ctuEnableFlagTmp2[MAX_NUM_COMPONENT];
   uint8_t*               m_ctuAlternativeTmp[MAX_NUM_COMPONENT];
+  uint8_t*               m_ctuEnableFlagDerived[MAX_NUM_COMPONENT];   // CTU decisions the current filters were derived from
+  uint8_t*               m_ctuAlternativeDerived[MAX_NUM_COMPONENT];
 #if JVET_Q0795_CCALF
   AlfCovariance***       m_alfCovarianceCcAlf[2];           // [compIdx-1][shapeIdx][ctbAddr][filterIdx]
   AlfCovariance**        m_alfCovarianceFrameCcAlf[2];      // [compIdx-1][shapeIdx][filterIdx]
@@ -260,7 +262,7 @@ private:
   short                  m_filterIndices[MAX_NUM_ALF_CLASSES][MAX_NUM_ALF_CLASSES];
   unsigned               m_bitsNewFilter[MAX_NUM_CHANNEL_TYPE];
   int&                   m_apsIdStart;
-  double                 *m_ctbDistortionFixedFilter;
+  double                 *m_ctbDistortionFilterSet;                   // [ctbAddr][fixed filter sets + APS filter sets]
   double                 *m_ctbDistortionUnfilter[MAX_NUM_COMPONENT];
   std::vector<short>     m_alfCtbFilterSetIndexTmp;
   AlfParam               m_alfParamTempNL;
@@ -326,7 +328,7 @@ private:
   void   getFrameStat( AlfCovariance* frameCov, AlfCovariance** ctbCov, uint8_t* ctbEnableFlags, uint8_t* ctbAltIdx, const int numClasses, int altIdx );
   void   deriveStatsForFiltering( PelUnitBuf& orgYuv, PelUnitBuf& recYuv, CodingStructure& cs );
   void   getBlkStats(AlfCovariance* alfCovariace, const AlfFilterShape& shape, AlfClassifier** classifier, Pel* org, const int orgStride, Pel* rec, const int recStride, const CompArea& areaDst, const CompArea& area, const ChannelType channel, int vbCTUHeight, int vbPos);
-  void   calcCovariance(int ELocal[MAX_NUM_ALF_LUMA_COEFF][MaxAlfNumClippingValues], const Pel *rec, const int stride, const AlfFilterShape& shape, const int transposeIdx, const ChannelType channel, int vbDistance);
+  void   calcCovariance(int ELocal[MaxAlfNumClippingValues][MAX_NUM_ALF_LUMA_COEFF], const Pel *rec, const int stride, const AlfFilterShape& shape, const int transposeIdx, const ChannelType channel, int vbDistance);
 #if JVET_Q0795_CCALF
   void   deriveStatsForCcAlfFiltering(const PelUnitBuf &orgYuv, const PelUnitBuf &recYuv, const int compIdx,
                                       const int maskStride, const uint8_t filterIdc, CodingStructure &cs);
@@ -366,14 +368,18 @@ private:
   double getUnfilteredDistortion( AlfCovariance* cov, ChannelType channel );
   double getUnfilteredDistortion( AlfCovariance* cov, const int numClasses );
   double getFilteredDistortion( AlfCovariance* cov, const int numClasses, const int numFiltersMinus1, const int numCoeff );
+  double getCtbDistortionFixedFilterSet( const int ctbIdx, const int filterSetIdx );
+  double getCtbDistortionFilterSet( const int ctbIdx, const short* pCoeff, const short* pClipp );
 
   void setEnableFlag( AlfParam& alfSlicePara, ChannelType channel, bool val );
   void setEnableFlag( AlfParam& alfSlicePara, ChannelType channel, uint8_t** ctuFlags );
   void setCtuEnableFlag( uint8_t** ctuFlags, ChannelType channel, uint8_t val );
   void copyCtuEnableFlag( uint8_t** ctuFlagsDst, uint8_t** ctuFlagsSrc, ChannelType channel );
+  bool isSameCtuEnableFlag( uint8_t** ctuFlagsA, uint8_t** ctuFlagsB, ChannelType channel );
   void initCtuAlternativeChroma( uint8_t* ctuAlts[MAX_NUM_COMPONENT] );
   void setCtuAlternativeChroma( uint8_t* ctuAlts[MAX_NUM_COMPONENT], uint8_t val );
   void copyCtuAlternativeChroma( uint8_t* ctuAltsDst[MAX_NUM_COMPONENT], uint8_t* ctuAltsSrc[MAX_NUM_COMPONENT] );
+  bool isSameCtuAlternativeChroma( uint8_t* ctuAltsA[MAX_NUM_COMPONENT], uint8_t* ctuAltsB[MAX_NUM_COMPONENT] );
   int getMaxNumAlternativesChroma( );
 #if JVET_Q0795_CCALF
   int  getCoeffRateCcAlf(short chromaCoeff[MAX_NUM_CC_ALF_FILTERS][MAX_NUM_CC_ALF_CHROMA_COEFF], bool filterEnabled[MAX_NUM_CC_ALF_FILTERS], uint8_t filterCount, ComponentID compID);
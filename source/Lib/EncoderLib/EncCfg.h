@@ -502,6 +502,7 @@ protected:
 #endif
   int*      m_aidQP;
   uint32_t      m_uiDeltaQpRD;
+  bool      m_deltaQpRDEarlyTerm;
   bool      m_bFastDeltaQP;
   bool      m_ISP;
   bool      m_useFastISP;
@@ -1380,6 +1381,7 @@ public:
 
   void      setdQPs                         ( int*  p )     { m_aidQP       = p; }
   void      setDeltaQpRD                    ( uint32_t  u )     {m_uiDeltaQpRD  = u; }
+  void      setDeltaQpRDEarlyTerm           ( bool  b )     {m_deltaQpRDEarlyTerm = b; }
   void      setFastDeltaQp                  ( bool  b )     {m_bFastDeltaQP = b; }
   int       getBitDepth                     (const ChannelType chType) const { return m_bitDepth[chType]; }
   int*      getBitDepth                     ()      { return m_bitDepth; }
@@ -1444,6 +1446,7 @@ public:
 
   const int* getdQPs                        () const { return m_aidQP;       }
   uint32_t      getDeltaQpRD                    () const { return m_uiDeltaQpRD; }
+  bool      getDeltaQpRDEarlyTerm           () const { return m_deltaQpRDEarlyTerm; }
   bool      getFastDeltaQp                  () const { return m_bFastDeltaQP; }
 
   //====== Tiles and Slices ========
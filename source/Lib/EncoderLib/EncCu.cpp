@@ -321,6 +321,12 @@ void EncCu::compressCtu( CodingStructure& cs, const UnitArea& area, const unsign
 {
   m_modeCtrl->initCTUEncoding( *cs.slice );
   cs.treeType = TREE_D;
+#if ENABLE_CS_COPY_STATS
+  CSCopyStats::addCtu();
+#endif
+#if ENABLE_CTX_COPY_STATS
+  CtxCopyStats::addCtu();
+#endif
 
 #if JVET_Q0504_PLT_NON444
   cs.slice->m_mapPltCost[0].clear();
@@ -995,7 +1001,7 @@ void EncCu::xCompressCU( CodingStructure*& tempCS, CodingStructure*& bestCS, Par
           break;
         }
       }
-      if (splitmode != bestCS->cus[0]->splitSeries)
+      if (bestCS->cus.size() != 0 && splitmode != bestCS->cus[0]->splitSeries)
       {
         splitmode = bestCS->cus[0]->splitSeries;
         const CodingUnit&     cu = *bestCS->cus.front();
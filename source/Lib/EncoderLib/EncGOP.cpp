@@ -42,6 +42,7 @@
 #include "EncLib.h"
 #include "EncGOP.h"
 #include "Analyze.h"
+#include "EncRCLookahead.h"
 #include "libmd5/MD5.h"
 #include "CommonLib/SEI.h"
 #include "CommonLib/NAL.h"
@@ -61,6 +62,10 @@
 
 #include "DecoderLib/DecLib.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #define ENCODE_SUB_SET 0
 
 using namespace std;
@@ -315,7 +320,7 @@ int EncGOP::xWriteVPS (AccessUnit &accessUnit, const VPS *vps)
   CHECK( nalu.m_temporalId, "The value of TemporalId of VPS NAL units shall be equal to 0" );
   m_HLSWriter->codeVPS( vps );
   accessUnit.push_back(new NALUnitEBSP(nalu));
-  return (int)(accessUnit.back()->m_nalUnitData.str().size()) * 8;
+  return (int)accessUnit.back()->getSize() * 8;
 }
 #if JVET_Q0117_PARAMETER_SETS_CLEANUP
 int EncGOP::xWriteDCI(AccessUnit& accessUnit, const DCI* dci)
@@ -325,7 +330,7 @@ int EncGOP::xWriteDCI(AccessUnit& accessUnit, const DCI* dci)
   CHECK(nalu.m_temporalId, "The value of TemporalId of DCI NAL units shall be equal to 0");
   m_HLSWriter->codeDCI(dci);
   accessUnit.push_back(new NALUnitEBSP(nalu));
-  return (int)(accessUnit.back()->m_nalUnitData.str().size()) * 8;
+  return (int)accessUnit.back()->getSize() * 8;
 }
 #else
 int EncGOP::xWriteDPS (AccessUnit &accessUnit, const DPS *dps)
@@ -337,7 +342,7 @@ int EncGOP::xWriteDPS (AccessUnit &accessUnit, const DPS *dps)
     CHECK( nalu.m_temporalId, "The value of TemporalId of DPS NAL units shall be equal to 0" );
     m_HLSWriter->codeDPS( dps );
     accessUnit.push_back(new NALUnitEBSP(nalu));
-    return (int)(accessUnit.back()->m_nalUnitData.str().size()) * 8;
+    return (int)accessUnit.back()->getSize() * 8;
   }
   else
   {
@@ -354,7 +359,7 @@ int EncGOP::xWriteSPS( AccessUnit &accessUnit, const SPS *sps, const int layerId
   CHECK( nalu.m_temporalId, "The value of TemporalId of SPS NAL units shall be equal to 0" );
   m_HLSWriter->codeSPS( sps );
   accessUnit.push_back(new NALUnitEBSP(nalu));
-  return (int)(accessUnit.back()->m_nalUnitData.str().size()) * 8;
+  return (int)accessUnit.back()->getSize() * 8;
 
 }
 
@@ -366,7 +371,7 @@ int EncGOP::xWritePPS( AccessUnit &accessUnit, const PPS *pps, const int layerId
   CHECK( nalu.m_temporalId < accessUnit.temporalId, "TemporalId shall be greater than or equal to the TemporalId of the layer access unit containing the NAL unit" );
   m_HLSWriter->codePPS( pps );
   accessUnit.push_back(new NALUnitEBSP(nalu));
-  return (int)(accessUnit.back()->m_nalUnitData.str().size()) * 8;
+  return (int)accessUnit.back()->getSize() * 8;
 }
 
 int EncGOP::xWriteAPS( AccessUnit &accessUnit, APS *aps, const int layerId, const bool isPrefixNUT )
@@ -379,7 +384,7 @@ int EncGOP::xWriteAPS( AccessUnit &accessUnit, APS *aps, const int layerId, cons
   CHECK( nalu.m_temporalId < accessUnit.temporalId, "TemporalId shall be greater than or equal to the TemporalId of the layer access unit containing the NAL unit" );
   m_HLSWriter->codeAPS(aps);
   accessUnit.push_back(new NALUnitEBSP(nalu));
-  return (int)(accessUnit.back()->m_nalUnitData.str().size()) * 8;
+  return (int)accessUnit.back()->getSize() * 8;
 }
 
 #if ENABLING_MULTI_SPS
@@ -443,7 +448,7 @@ int EncGOP::xWritePicHeader( AccessUnit &accessUnit, PicHeader *picHeader )
   m_HLSWriter->codePictureHeader( picHeader );
 #endif
   accessUnit.push_back(new NALUnitEBSP(nalu));
-  return (int)(accessUnit.back()->m_nalUnitData.str().size()) * 8;
+  return (int)accessUnit.back()->getSize() * 8;
 }
 
 void EncGOP::xWriteAccessUnitDelimiter (AccessUnit &accessUnit, Slice *slice)
@@ -1099,7 +1104,7 @@ void EncGOP::xUpdateDuData(AccessUnit &testAU, std::deque<DUData> &duData)
   uint32_t numRBSPBytes = 0;
   for (AccessUnit::const_iterator it = testAU.begin(); it != testAU.end(); it++)
   {
-    numRBSPBytes += uint32_t((*it)->m_nalUnitData.str().size());
+    numRBSPBytes += (*it)->getSize();
   }
   duData[0].accumBitsDU += ( numRBSPBytes << 3 );
   duData[0].accumNalsDU += numNalUnits;
@@ -1538,7 +1543,7 @@ void trySkipOrDecodePicture( bool& decPic, bool& encPic, const EncCfg& cfg, Pict
   // check if we should decode a leading bitstream
   if( !cfg.getDecodeBitstream( 0 ).empty() )
   {
-    static bool bDecode1stPart = true; /* TODO: MT */
+    static thread_local bool bDecode1stPart = true;
     if( bDecode1stPart )
     {
       if( cfg.getForceDecodeBitstream1() )
@@ -1631,7 +1636,7 @@ void trySkipOrDecodePicture( bool& decPic, bool& encPic, const EncCfg& cfg, Pict
   }
 
   // this is the forward to poc section
-  static bool bHitFastForwardPOC = false; /* TODO: MT */
+  static thread_local bool bHitFastForwardPOC = false;
   if( bHitFastForwardPOC || isPicEncoded( cfg.getFastForwardToPOC(), pcPic->getPOC(), pcPic->layer, cfg.getGOPSize(), cfg.getIntraPeriod() ) )
   {
     bHitFastForwardPOC |= cfg.getFastForwardToPOC() == pcPic->getPOC(); // once we hit the poc we continue encoding
@@ -1734,7 +1739,15 @@ void EncGOP::xPicInitRateControl(int &estimatedBits, int gopId, double &lambda,
   {
     frameLevel = 0;
   }
-  m_pcRateCtrl->initRCPic( frameLevel );
+  std::vector<double> ctuCosts;
+  if( m_pcEncLib->getRCLookahead() && m_pcEncLib->getRCLookahead()->getCtuCosts( pic->getPOC(), ctuCosts ) )
+  {
+    m_pcRateCtrl->initRCPic( frameLevel, &ctuCosts );
+  }
+  else
+  {
+    m_pcRateCtrl->initRCPic( frameLevel );
+  }
   estimatedBits = m_pcRateCtrl->getRCPic()->getTargetBits();
 
 #if U0132_TARGET_BITS_SATURATION
@@ -1986,8 +1999,6 @@ void EncGOP::compressGOP( int iPOCLast, int iNumPicRcvd, PicList& rcListPic,
   Picture*        pcPic = NULL;
   PicHeader*      picHeader = NULL;
   Slice*      pcSlice;
-  OutputBitstream  *pcBitstreamRedirect;
-  pcBitstreamRedirect = new OutputBitstream;
   AccessUnit::iterator  itLocationToPushSliceHeaderNALU; // used to store location where NALU containing slice header is to be inserted
   Picture* scaledRefPic[MAX_NUM_REF] = {};
 
@@ -2087,7 +2098,7 @@ void EncGOP::compressGOP( int iPOCLast, int iNumPicRcvd, PicList& rcListPic,
     // th this is a hot fix for the choma qp control
     if( m_pcEncLib->getWCGChromaQPControl().isEnabled() && m_pcEncLib->getSwitchPOC() != -1 )
     {
-      static int usePPS = 0; /* TODO: MT */
+      static thread_local int usePPS = 0;
       if( pocCurr == m_pcEncLib->getSwitchPOC() )
       {
         usePPS = 1;
@@ -2711,7 +2722,9 @@ void EncGOP::compressGOP( int iPOCLast, int iNumPicRcvd, PicList& rcListPic,
     const int numSubstreamRows     = pcSlice->getPPS()->getEntropyCodingSyncEnabledFlag() ? pcPic->cs->pcv->heightInCtus : (pcSlice->getPPS()->getNumTileRows());
 #endif
     const int numSubstreams        = std::max<int> (numSubstreamRows * numSubstreamsColumns, (int) pcPic->cs->pps->getNumSlicesInPic());
-    std::vector<OutputBitstream> substreamsOut(numSubstreams);
+    // the substream buffers are kept across pictures, so their capacity follows the largest coded slices
+    std::vector<OutputBitstream>& substreamsOut = m_substreamsOut;
+    substreamsOut.resize(numSubstreams);
 
 #if ENABLE_QPA
     pcPic->m_uEnerHpCtu.resize (numberOfCtusInFrame);
@@ -3319,33 +3332,25 @@ void EncGOP::compressGOP( int iPOCLast, int iNumPicRcvd, PicList& rcListPic,
           binCountsInNalUnits+=numBinsCoded;
         }
         {
-          // Construct the final bitstream by concatenating substreams.
-          // The final bitstream is either nalu.m_Bitstream or pcBitstreamRedirect;
+          // Construct the final bitstream by appending the substreams to the NAL unit.
           // Complete the slice header info.
           m_HLSWriter->setBitstream( &nalu.m_Bitstream );
           m_HLSWriter->codeTilesWPPEntryPoint( pcSlice );
 
-          // Append substreams...
-          OutputBitstream *pcOut = pcBitstreamRedirect;
 #if JVET_Q0151_Q0205_ENTRYPOINTS
           const int numSubstreamsToCode = pcSlice->getNumberOfSubstream() + 1;
 #else
           const int numSubstreamsToCode  = pcSlice->getNumberOfSubstreamSizes()+1;
 #endif
-
-          for ( uint32_t ui = 0 ; ui < numSubstreamsToCode; ui++ )
-          {
-            pcOut->addSubstream(&(substreamsOut[ui]));
-          }
+          xAttachSliceDataToNalUnit(nalu, &(substreamsOut[0]), numSubstreamsToCode);
         }
 
         // If current NALU is the first NALU of slice (containing slice header) and more NALUs exist (due to multiple dependent slices) then buffer it.
         // If current NALU is the last NALU of slice and a NALU was buffered, then (a) Write current NALU (b) Update an write buffered NALU at approproate location in NALU list.
         bool bNALUAlignedWrittenToList    = false; // used to ensure current NALU is not written more than once to the NALU list.
-        xAttachSliceDataToNalUnit(nalu, pcBitstreamRedirect);
         accessUnit.push_back(new NALUnitEBSP(nalu));
-        actualTotalBits += uint32_t(accessUnit.back()->m_nalUnitData.str().size()) * 8;
-        numBytesInVclNalUnits += (std::size_t)(accessUnit.back()->m_nalUnitData.str().size());
+        actualTotalBits += accessUnit.back()->getSize() * 8;
+        numBytesInVclNalUnits += (std::size_t)accessUnit.back()->getSize();
         bNALUAlignedWrittenToList = true;
 
         if (!bNALUAlignedWrittenToList)
@@ -3363,7 +3368,7 @@ void EncGOP::compressGOP( int iPOCLast, int iNumPicRcvd, PicList& rcListPic,
           uint32_t numRBSPBytes = 0;
           for (AccessUnit::const_iterator it = accessUnit.begin(); it != accessUnit.end(); it++)
           {
-            numRBSPBytes += uint32_t((*it)->m_nalUnitData.str().size());
+            numRBSPBytes += (*it)->getSize();
             numNalus ++;
           }
           duData.push_back(DUData());
@@ -3489,8 +3494,6 @@ void EncGOP::compressGOP( int iPOCLast, int iNumPicRcvd, PicList& rcListPic,
     pcPic->cs->releaseIntermediateData();
   } // iGOPid-loop
 
-  delete pcBitstreamRedirect;
-
   CHECK( m_iNumPicCoded > 1, "Unspecified error" );
 }
 
@@ -3716,31 +3719,13 @@ static inline double calcWeightedSquaredError(const CPelBuf& org,        const C
 
   const int hAct = offsetY + (uint32_t)blockHeight < imageHeight ? blockHeight : blockHeight - 1;
   const int wAct = offsetX + (uint32_t)blockWidth  < imageWidth  ? blockWidth  : blockWidth  - 1;
-  uint64_t ssErr = 0; // sum of squared diffs
-  uint64_t saAct = 0; // sum of abs. activity
   double msAct;
-  int x, y;
 
   // calculate image differences and activity
-  for (y = 0; y < blockHeight; y++)  // error
-  {
-    for (x = 0; x < blockWidth; x++)
-    {
-      const     int64_t iDiff = (int64_t)o[y*O + x] - (int64_t)r[y*R + x];
-      ssErr += uint64_t(iDiff * iDiff);
-    }
-  }
+  const uint64_t ssErr = g_pelBufOP.calcSSE(o, O, r, R, blockWidth, blockHeight); // sum of squared diffs
   if (wAct <= xAct || hAct <= yAct) return (double)ssErr;
 
-  for (y = yAct; y < hAct; y++)   // activity
-  {
-    for (x = xAct; x < wAct; x++)
-    {
-      const int f = 12 * (int)o[y*O + x] - 2 * ((int)o[y*O + x-1] + (int)o[y*O + x+1] + (int)o[(y-1)*O + x] + (int)o[(y+1)*O + x])
-                       - (int)o[(y-1)*O + x-1] - (int)o[(y-1)*O + x+1] - (int)o[(y+1)*O + x-1] - (int)o[(y+1)*O + x+1];
-      saAct += abs(f);
-    }
-  }
+  const uint64_t saAct = g_pelBufOP.calcHPActivity(o + yAct * O + xAct, O, wAct - xAct, hAct - yAct); // sum of abs. activity
 
   // calculate weight (mean squared activity)
   msAct = (double)saAct / (double(wAct - xAct) * double(hAct - yAct));
@@ -3757,6 +3742,16 @@ static inline double calcWeightedSquaredError(const CPelBuf& org,        const C
 }
 #endif // ENABLE_QPA
 
+/** number of threads for measuring the distortion of the planes concurrently, limited by the available OpenMP threads */
+static int getNumDistortionThreads(const int numComp)
+{
+#ifdef _OPENMP
+  return std::max(1, std::min(numComp, omp_get_max_threads()));
+#else
+  return 1;
+#endif
+}
+
 uint64_t EncGOP::xFindDistortionPlane(const CPelBuf& pic0, const CPelBuf& pic1, const uint32_t rshift
 #if ENABLE_QPA
                                     , const uint32_t chromaShiftHor /*= 0*/, const uint32_t chromaShiftVer /*= 0*/
@@ -3785,18 +3780,7 @@ uint64_t EncGOP::xFindDistortionPlane(const CPelBuf& pic0, const CPelBuf& pic1,
 
       if (B < 4) // image is too small to use WPSNR, resort to traditional PSNR
       {
-        uiTotalDiff = 0;
-        for (y = 0; y < H; y++)
-        {
-          for (x = 0; x < W; x++)
-          {
-            const           int64_t iDiff = (int64_t)pSrc0[x] - (int64_t)pSrc1[x];
-            uiTotalDiff += uint64_t(iDiff * iDiff);
-          }
-          pSrc0 += pic0.stride;
-          pSrc1 += pic1.stride;
-        }
-        return uiTotalDiff;
+        return g_pelBufOP.calcSSE(pSrc0, pic0.stride, pSrc1, pic1.stride, W, H);
       }
 
       double wmse = 0.0, sumAct = 0.0; // compute activity normalized SNR value
@@ -3833,17 +3817,7 @@ uint64_t EncGOP::xFindDistortionPlane(const CPelBuf& pic0, const CPelBuf& pic1,
   }
   else
   {
-    uiTotalDiff = 0;
-    for (int y = 0; y < pic0.height; y++)
-    {
-      for (int x = 0; x < pic0.width; x++)
-      {
-        Intermediate_Int iTemp = pSrc0[x] - pSrc1[x];
-        uiTotalDiff += uint64_t(iTemp * iTemp);
-      }
-      pSrc0 += pic0.stride;
-      pSrc1 += pic1.stride;
-    }
+    uiTotalDiff = g_pelBufOP.calcSSE(pSrc0, pic0.stride, pSrc1, pic1.stride, pic0.width, pic0.height);
   }
 
   return uiTotalDiff;
@@ -4049,15 +4023,23 @@ void EncGOP::xCalculateAddPSNR(Picture* pcPic, PelUnitBuf cPicD, const AccessUni
     Picture::rescalePicture( scalingRatio, picC, pcPic->getScalingWindow(), upscaledRec, pps->getScalingWindow(), format, sps.getBitDepths(), false, false, sps.getHorCollocatedChromaFlag(), sps.getVerCollocatedChromaFlag() );
   }
 
-  for (int comp = 0; comp < ::getNumberValidComponents(formatD); comp++)
+  const int numComp    = ::getNumberValidComponents(formatD);
+  const int numThreads = getNumDistortionThreads(numComp);
+
+  for (int comp = 0; comp < numComp; comp++)
+  {
+    CHECK(!( picC.get(ComponentID(comp)).width  == org.get(ComponentID(comp)).width), "Unspecified error");
+    CHECK(!( picC.get(ComponentID(comp)).height == org.get(ComponentID(comp)).height), "Unspecified error");
+  }
+
+  // the planes are measured concurrently, each one writes only its own entries of the result arrays
+#pragma omp parallel for num_threads(numThreads) if(numThreads > 1)
+  for (int comp = 0; comp < numComp; comp++)
   {
     const ComponentID compID = ComponentID(comp);
     const CPelBuf&    p = picC.get(compID);
     const CPelBuf&    o = org.get(compID);
 
-    CHECK(!( p.width  == o.width), "Unspecified error");
-    CHECK(!( p.height == o.height), "Unspecified error");
-
     int padX = m_pcEncLib->getPad( 0 );
     int padY = m_pcEncLib->getPad( 1 );
 
@@ -4139,7 +4121,7 @@ void EncGOP::xCalculateAddPSNR(Picture* pcPic, PelUnitBuf cPicD, const AccessUni
   uint32_t numRBSPBytes = 0;
   for (AccessUnit::const_iterator it = accessUnit.begin(); it != accessUnit.end(); it++)
   {
-    uint32_t numRBSPBytes_nal = uint32_t((*it)->m_nalUnitData.str().size());
+    uint32_t numRBSPBytes_nal = (*it)->getSize();
     if (m_pcCfg->getSummaryVerboseness() > 0)
     {
       msg( NOTICE, "*** %6s numBytesInNALunit: %u\n", nalUnitTypeToString((*it)->m_nalUnitType), numRBSPBytes_nal);
@@ -4685,22 +4667,33 @@ double EncGOP::xCalculateRVM()
   return( dRVM );
 }
 
-/** Attaches the input bitstream to the stream in the output NAL unit
-    Updates rNalu to contain concatenated bitstream. rpcBitstreamRedirect is cleared at the end of this function call.
- *  \param codedSliceData contains the coded slice data (bitstream) to be concatenated to rNalu
+/** Attaches the coded substreams to the stream in the output NAL unit
+    Updates rNalu to contain concatenated bitstream. The NAL unit buffer is sized once for the complete slice,
+    the substreams are then appended with byte-aligned copies.
  *  \param rNalu          target NAL unit
+ *  \param substreams     coded slice data (substreams) to be concatenated to rNalu
+ *  \param numSubstreams  number of substreams
  */
-void EncGOP::xAttachSliceDataToNalUnit (OutputNALUnit& rNalu, OutputBitstream* codedSliceData)
+void EncGOP::xAttachSliceDataToNalUnit (OutputNALUnit& rNalu, OutputBitstream* substreams, int numSubstreams)
 {
   // Byte-align
   rNalu.m_Bitstream.writeByteAlignment();   // Slice header byte-alignment
 
+  uint32_t numBytes = rNalu.m_Bitstream.getByteStreamLength();
+  for (int i = 0; i < numSubstreams; i++)
+  {
+    numBytes += (substreams[i].getNumberOfWrittenBits() + 7) >> 3;
+  }
+  rNalu.m_Bitstream.reserve(numBytes);
+
   // Perform bitstream concatenation
-  if (codedSliceData->getNumberOfWrittenBits() > 0)
+  for (int i = 0; i < numSubstreams; i++)
   {
-    rNalu.m_Bitstream.addSubstream(codedSliceData);
+    if (substreams[i].getNumberOfWrittenBits() > 0)
+    {
+      rNalu.m_Bitstream.addSubstream(&substreams[i]);
+    }
   }
-  codedSliceData->clear();
 }
 
 
@@ -182,6 +182,7 @@ private:
   bool                    m_bInitAMaxBT;
 
   AUWriterIf*             m_AUWriterIf;
+  std::vector<OutputBitstream> m_substreamsOut;   ///< slice substream buffers, reused across pictures
 
 #if JVET_O0756_CALCULATE_HDRMETRICS
 
@@ -214,7 +215,7 @@ public:
                     , bool isEncodeLtRef
                     , const int picIdInGOP
   );
-  void  xAttachSliceDataToNalUnit (OutputNALUnit& rNalu, OutputBitstream* pcBitstreamRedirect);
+  void  xAttachSliceDataToNalUnit (OutputNALUnit& rNalu, OutputBitstream* substreams, int numSubstreams);
 
 
   int   getGOPSize()          { return  m_iGopSize;  }
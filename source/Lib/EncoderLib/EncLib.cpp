@@ -38,6 +38,7 @@
 
 #include "EncModeCtrl.h"
 #include "AQp.h"
+#include "EncRCLookahead.h"
 #include "EncCu.h"
 
 #include "CommonLib/Picture.h"
@@ -64,6 +65,7 @@ EncLib::EncLib( EncLibCommon* encLibCommon )
   , m_spsMap( encLibCommon->getSpsMap() )
   , m_ppsMap( encLibCommon->getPpsMap() )
   , m_apsMap( encLibCommon->getApsMap() )
+  , m_rcLookahead( nullptr )
   , m_AUWriterIf( nullptr )
 #if JVET_J0090_MEMORY_BANDWITH_MEASURE
   , m_cacheModel()
@@ -84,6 +86,9 @@ EncLib::EncLib( EncLibCommon* encLibCommon )
 #if ENABLE_SIMD_OPT_BUFFER
   g_pelBufOP.initPelBufOpsX86();
 #endif
+#if ENABLE_SIMD_OPT_BITSTREAM
+  g_bitstreamOps.initBitstreamOpsX86();
+#endif
 
 #if JVET_O0756_CALCULATE_HDRMETRICS
   m_metricTime = std::chrono::milliseconds(0);
@@ -765,6 +770,11 @@ bool EncLib::encodePrep( bool flush, PelStorage* pcPicYuvOrg, PelStorage* cPicYu
     {
       AQpPreanalyzer::preanalyze( pcPicCurr );
     }
+
+    if( m_rcLookahead )
+    {
+      m_rcLookahead->advance( m_iPOCLast );
+    }
   }
 
   if( ( m_iNumPicRcvd == 0 ) || ( !flush && ( m_iPOCLast != 0 ) && ( m_iNumPicRcvd != m_iGOPSize ) && ( m_iGOPSize != 0 ) ) )
@@ -773,7 +783,26 @@ bool EncLib::encodePrep( bool flush, PelStorage* pcPicYuvOrg, PelStorage* cPicYu
     return true;
   }
 
-  if( m_RCEnableRateControl )
+  if( m_RCEnableRateControl && m_rcLookahead )
+  {
+    // lookahead costs of the GOP pictures in the order they are coded, pictures past the last received one are not coded
+    std::vector<double> picCosts;
+    for( int gopId = 0; gopId < m_iGOPSize && (int)picCosts.size() < m_iNumPicRcvd; gopId++ )
+    {
+      const int poc = m_iPOCLast == 0 ? 0 : m_iPOCLast - m_iNumPicRcvd + getGOPEntry( gopId ).m_POC;
+      if( poc <= m_iPOCLast )
+      {
+        picCosts.push_back( m_rcLookahead->getPicCost( poc ) );
+      }
+    }
+    picCosts.resize( m_iNumPicRcvd, 0.0 );
+
+    // reference cost of the smoothing window before the GOP and the lookahead window after it
+    const double refCost = m_rcLookahead->getAverageCost( m_iPOCLast - m_iNumPicRcvd + 1 - g_RCSmoothWindowSize, m_iPOCLast + m_rcLookahead->getLookaheadFrames() );
+
+    m_cRateCtrl.initRCGOP( m_iNumPicRcvd, &picCosts, refCost );
+  }
+  else if( m_RCEnableRateControl )
   {
     m_cRateCtrl.initRCGOP( m_iNumPicRcvd );
   }
@@ -2382,7 +2411,7 @@ int EncCfg::getQPForPicture(const uint32_t gopIndex, const Slice *pSlice) const
     qp = getBaseQP();
 
     // switch at specific qp and keep this qp offset
-    static int appliedSwitchDQQ = 0; /* TODO: MT */
+    static thread_local int appliedSwitchDQQ = 0;
     if( pSlice->getPOC() == getSwitchPOC() )
     {
       appliedSwitchDQQ = getSwitchDQP();
@@ -59,6 +59,7 @@
 #include "RateCtrl.h"
 
 class EncLibCommon;
+class EncRCLookahead;
 
 //! \ingroup EncoderLib
 //! \{
@@ -131,6 +132,7 @@ private:
 #endif
   // quality control
   RateCtrl                  m_cRateCtrl;                          ///< Rate control class
+  EncRCLookahead*           m_rcLookahead;                        ///< lookahead analysis for rate control, owned by the application
 
   AUWriterIf*               m_AUWriterIf;
 
@@ -240,6 +242,8 @@ public:
   CtxCache*               getCtxCache           ()              { return  &m_CtxCache;             }
 #endif
   RateCtrl*               getRateCtrl           ()              { return  &m_cRateCtrl;            }
+  EncRCLookahead*         getRCLookahead        ()              { return   m_rcLookahead;          }
+  void                    setRCLookahead        ( EncRCLookahead* p ) { m_rcLookahead = p;         }
 
 
   void                    getActiveRefPicListNumForPOC(const SPS *sps, int POCCurr, int GOPid, uint32_t *activeL0, uint32_t *activeL1);
@@ -296,7 +300,19 @@ public:
                int& iNumEncoded, bool isTff );
 
 
-  void printSummary( bool isField ) { m_cGOPEncoder.printOutSummary( m_uiNumAllPicCoded, isField, m_printMSEBasedSequencePSNR, m_printSequenceMSE, m_printHexPsnr, m_rprEnabled, m_spsMap.getFirstPS()->getBitDepths() ); }
+  void printSummary( bool isField )
+  {
+    m_cGOPEncoder.printOutSummary( m_uiNumAllPicCoded, isField, m_printMSEBasedSequencePSNR, m_printSequenceMSE, m_printHexPsnr, m_rprEnabled, m_spsMap.getFirstPS()->getBitDepths() );
+#if ENABLE_QUANT_ZERO_TU_STATS
+    QuantZeroTUStats::report();
+#endif
+#if ENABLE_CS_COPY_STATS
+    CSCopyStats::report();
+#endif
+#if ENABLE_CTX_COPY_STATS
+    CtxCopyStats::report();
+#endif
+  }
 
   int getLayerId() const { return m_layerId; }
 #if JVET_Q0814_DPB
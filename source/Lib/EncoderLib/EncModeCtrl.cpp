@@ -1901,12 +1901,7 @@ bool EncModeCtrlMTnoRQT::tryMode( const EncTestMode& encTestmode, const CodingSt
     CHECK( encTestmode.type != ETM_POST_DONT_SPLIT, "Unknown mode" );
     if ((cuECtx.get<double>(BEST_NO_IMV_COST) == (MAX_DOUBLE * .5) || cuECtx.get<bool>(IS_REUSING_CU)) && !slice.isIntra())
     {
-      unsigned idx1, idx2, idx3, idx4;
-      getAreaIdx(partitioner.currArea().Y(), *slice.getPPS()->pcv, idx1, idx2, idx3, idx4);
-      if (g_isReusedUniMVsFilled[idx1][idx2][idx3][idx4])
-      {
-        m_pcInterSearch->insertUniMvCands(partitioner.currArea().Y(), g_reusedUniMVs[idx1][idx2][idx3][idx4]);
-      }
+      m_pcInterSearch->insertReusedUniMvCands(partitioner.currArea().Y(), *slice.getPPS()->pcv);
     }
     if( !bestCS || ( bestCS && isModeSplit( bestMode ) ) )
     {
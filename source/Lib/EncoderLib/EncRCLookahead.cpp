@@ -0,0 +1,470 @@
+/* The copyright in this software is being made available under the BSD
+* License, included below. This software may be subject to other third party
+* and contributor rights, including patent rights, and no such rights are
+* granted under this license.
+*
+* Copyright (c) 2010-2020, ITU/ISO/IEC
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*  * Redistributions of source code must retain the above copyright notice,
+*    this list of conditions and the following disclaimer.
+*  * Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+*    be used to endorse or promote products derived from this software without
+*    specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+* THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/** \file     EncRCLookahead.cpp
+    \brief    lookahead analysis for rate control
+*/
+
+#include "EncRCLookahead.h"
+#include "CommonLib/Mv.h"
+
+//! \ingroup EncoderLib
+//! \{
+
+// ====================================================================================================================
+// Constructor / destructor / initialization / destroy
+// ====================================================================================================================
+
+const int EncRCLookahead::m_blkSize     = 8;
+const int EncRCLookahead::m_searchRange = 16;
+const int EncRCLookahead::m_margin      = 24;
+const int EncRCLookahead::m_historySize = 128;
+
+EncRCLookahead::EncRCLookahead()
+  : m_frameSkip                   ( 0 )
+  , m_temporalSubsampleRatio      ( 1 )
+  , m_sourceWidth                 ( 0 )
+  , m_sourceHeight                ( 0 )
+  , m_clipInputVideoToRec709Range ( false )
+  , m_chromaFormatIDC             ( NUM_CHROMA_FORMAT )
+  , m_inputChromaFormatIDC        ( NUM_CHROMA_FORMAT )
+  , m_inputColourSpaceConvert     ( NUMBER_INPUT_COLOUR_SPACE_CONVERSIONS )
+  , m_ctuSize                     ( 0 )
+  , m_numFrames                   ( 0 )
+  , m_lookaheadFrames             ( 0 )
+  , m_receivedPoc                 ( -1 )
+  , m_analysedPoc                 ( -1 )
+  , m_finished                    ( true )
+  , m_stop                        ( false )
+{
+}
+
+EncRCLookahead::~EncRCLookahead()
+{
+  destroy();
+}
+
+void EncRCLookahead::init( const int frameSkip,
+                           const int temporalSubsampleRatio,
+                           const int inputBitDepth[MAX_NUM_CHANNEL_TYPE],
+                           const int msbExtendedBitDepth[MAX_NUM_CHANNEL_TYPE],
+                           const int internalBitDepth[MAX_NUM_CHANNEL_TYPE],
+                           const int width,
+                           const int height,
+                           const int *pad,
+                           const bool rec709,
+                           const std::string &filename,
+                           const ChromaFormat chromaFormat,
+                           const ChromaFormat inputChromaFormat,
+                           const InputColourSpaceConversion colorSpaceConv,
+                           const int ctuSize,
+                           const int numFrames,
+                           const int lookaheadFrames )
+{
+  destroy();
+
+  m_frameSkip              = frameSkip;
+  m_temporalSubsampleRatio = temporalSubsampleRatio;
+  for( int i = 0; i < MAX_NUM_CHANNEL_TYPE; i++ )
+  {
+    m_inputBitDepth[i]       = inputBitDepth[i];
+    m_MSBExtendedBitDepth[i] = msbExtendedBitDepth[i];
+    m_internalBitDepth[i]    = internalBitDepth[i];
+  }
+  m_sourceWidth  = width;
+  m_sourceHeight = height;
+  for( int i = 0; i < 2; i++ )
+  {
+    m_pad[i] = pad[i];
+  }
+  m_clipInputVideoToRec709Range = rec709;
+  m_inputFileName               = filename;
+  m_chromaFormatIDC             = chromaFormat;
+  m_inputChromaFormatIDC        = inputChromaFormat;
+  m_inputColourSpaceConvert     = colorSpaceConv;
+  m_ctuSize                     = ctuSize;
+  m_numFrames                   = numFrames;
+  m_lookaheadFrames             = lookaheadFrames;
+
+  m_receivedPoc = -1;
+  m_analysedPoc = -1;
+  m_finished    = false;
+  m_stop        = false;
+
+  m_thread = std::thread( &EncRCLookahead::xAnalyseFrames, this );
+}
+
+void EncRCLookahead::destroy()
+{
+  {
+    std::unique_lock<std::mutex> lock( m_mutex );
+    m_stop = true;
+  }
+  m_cond.notify_all();
+
+  if( m_thread.joinable() )
+  {
+    m_thread.join();
+  }
+  m_pics.clear();
+}
+
+// ====================================================================================================================
+// Public member functions
+// ====================================================================================================================
+
+void EncRCLookahead::advance( int poc )
+{
+  {
+    std::unique_lock<std::mutex> lock( m_mutex );
+    m_receivedPoc = std::max( m_receivedPoc, poc );
+
+    // the rate control looks back at most one smoothing window, older results are dropped
+    m_pics.erase( m_pics.begin(), m_pics.lower_bound( m_receivedPoc - m_historySize ) );
+  }
+  m_cond.notify_all();
+}
+
+double EncRCLookahead::getPicCost( int poc )
+{
+  std::unique_lock<std::mutex> lock( m_mutex );
+  return xWaitForPic( poc, lock ) ? m_pics[poc].getCost() : 0.0;
+}
+
+double EncRCLookahead::getAverageCost( int firstPoc, int lastPoc )
+{
+  std::unique_lock<std::mutex> lock( m_mutex );
+
+  double sumCost = 0.0;
+  int    numPics = 0;
+  for( int poc = std::max( 0, firstPoc ); poc <= lastPoc; poc++ )
+  {
+    if( xWaitForPic( poc, lock ) )
+    {
+      sumCost += m_pics[poc].getCost();
+      numPics++;
+    }
+  }
+  return numPics > 0 ? sumCost / numPics : 0.0;
+}
+
+bool EncRCLookahead::getCtuCosts( int poc, std::vector<double>& ctuCosts )
+{
+  std::unique_lock<std::mutex> lock( m_mutex );
+  if( !xWaitForPic( poc, lock ) )
+  {
+    return false;
+  }
+  ctuCosts = m_pics[poc].ctuCost;
+  return true;
+}
+
+// ====================================================================================================================
+// Private member functions
+// ====================================================================================================================
+
+bool EncRCLookahead::xWaitForPic( int poc, std::unique_lock<std::mutex>& lock )
+{
+  // pictures beyond the lookahead window are not analysed before the encoder advances
+  if( poc < 0 || poc >= m_numFrames || poc > m_receivedPoc + m_lookaheadFrames )
+  {
+    return false;
+  }
+  m_cond.wait( lock, [&] { return m_finished || m_analysedPoc >= poc; } );
+  return m_pics.find( poc ) != m_pics.end();
+}
+
+void EncRCLookahead::xAnalyseFrames()
+{
+  VideoIOYuv yuvFrames;
+  yuvFrames.open( m_inputFileName, false, m_inputBitDepth, m_MSBExtendedBitDepth, m_internalBitDepth );
+  yuvFrames.skipFrames( m_frameSkip, m_sourceWidth - m_pad[0], m_sourceHeight - m_pad[1], m_inputChromaFormatIDC );
+
+  const Area area( 0, 0, m_sourceWidth, m_sourceHeight );
+  PelStorage srcPic;
+  PelStorage dummyPicBufferTO; // Only used temporary in yuvFrames.read
+  srcPic.create( m_chromaFormatIDC, area );
+  dummyPicBufferTO.create( m_chromaFormatIDC, area );
+
+  PelStorage subsampled[2];
+  int        pad[2] = { m_pad[0], m_pad[1] };
+
+  for( int poc = 0; poc < m_numFrames; poc++ )
+  {
+    {
+      std::unique_lock<std::mutex> lock( m_mutex );
+      m_cond.wait( lock, [&] { return m_stop || poc <= m_receivedPoc + m_lookaheadFrames; } );
+      if( m_stop )
+      {
+        break;
+      }
+    }
+
+    if( poc > 0 && m_temporalSubsampleRatio > 1 )
+    {
+      yuvFrames.skipFrames( m_temporalSubsampleRatio - 1, m_sourceWidth - m_pad[0], m_sourceHeight - m_pad[1], m_inputChromaFormatIDC );
+    }
+    if( !yuvFrames.read( srcPic, dummyPicBufferTO, m_inputColourSpaceConvert, pad, m_inputChromaFormatIDC, m_clipInputVideoToRec709Range ) )
+    {
+      break; // eof or read fail
+    }
+
+    PelStorage& curPic  = subsampled[poc & 1];
+    PelStorage& prevPic = subsampled[1 - ( poc & 1 )];
+    xSubsampleLuma( srcPic.Y(), curPic );
+
+    RCLookaheadPic pic;
+    xEstimateCosts( curPic, poc > 0 ? &prevPic : nullptr, pic );
+
+    {
+      std::unique_lock<std::mutex> lock( m_mutex );
+      m_pics[poc]   = std::move( pic );
+      m_analysedPoc = poc;
+    }
+    m_cond.notify_all();
+  }
+
+  yuvFrames.close();
+  srcPic.destroy();
+  dummyPicBufferTO.destroy();
+  subsampled[0].destroy();
+  subsampled[1].destroy();
+
+  {
+    std::unique_lock<std::mutex> lock( m_mutex );
+    m_finished = true;
+  }
+  m_cond.notify_all();
+}
+
+void EncRCLookahead::xSubsampleLuma( const CPelBuf& src, PelStorage& dst ) const
+{
+  // the subsampled picture is padded to full blocks and gets a margin for the motion search
+  const int width  = ( ( ( src.width  + 1 ) >> 1 ) + m_blkSize - 1 ) / m_blkSize * m_blkSize;
+  const int height = ( ( ( src.height + 1 ) >> 1 ) + m_blkSize - 1 ) / m_blkSize * m_blkSize;
+
+  if( dst.bufs.empty() )
+  {
+    dst.create( CHROMA_400, Area( 0, 0, width, height ), 0, m_margin );
+  }
+
+  PelBuf dstBuf = dst.Y();
+  for( int y = 0; y < height; y++ )
+  {
+    const Pel* src0 = src.bufAt( 0, std::min<int>( 2 * y,     src.height - 1 ) );
+    const Pel* src1 = src.bufAt( 0, std::min<int>( 2 * y + 1, src.height - 1 ) );
+    Pel*       dstLine = dstBuf.bufAt( 0, y );
+
+    for( int x = 0; x < width; x++ )
+    {
+      const int x0 = std::min<int>( 2 * x,     src.width - 1 );
+      const int x1 = std::min<int>( 2 * x + 1, src.width - 1 );
+      dstLine[x] = ( src0[x0] + src0[x1] + src1[x0] + src1[x1] + 2 ) >> 2;
+    }
+  }
+  dst.extendBorderPel( m_margin, m_margin );
+}
+
+int EncRCLookahead::xBlockSAD( const Pel* cur, const Pel* ref, const int stride ) const
+{
+  int sad = 0;
+  for( int y = 0; y < m_blkSize; y++, cur += stride, ref += stride )
+  {
+    for( int x = 0; x < m_blkSize; x++ )
+    {
+      sad += abs( cur[x] - ref[x] );
+    }
+  }
+  return sad;
+}
+
+/** 8x8 Hadamard cost of cur - ref, without ref the DC coefficient is left out like in the intra cost of calCostSliceI
+ */
+int EncRCLookahead::xBlockHAD( const Pel* cur, const Pel* ref, const int stride ) const
+{
+  int m[8][8];
+  for( int y = 0; y < 8; y++ )
+  {
+    for( int x = 0; x < 8; x++ )
+    {
+      m[y][x] = cur[y * stride + x] - ( ref ? ref[y * stride + x] : 0 );
+    }
+  }
+
+  for( int step = 4; step > 0; step >>= 1 )
+  {
+    for( int y = 0; y < 8; y++ )
+    {
+      for( int x = 0; x < 8; x++ )
+      {
+        if( !( x & step ) )
+        {
+          const int a = m[y][x];
+          const int b = m[y][x + step];
+          m[y][x]        = a + b;
+          m[y][x + step] = a - b;
+        }
+      }
+    }
+  }
+  for( int step = 4; step > 0; step >>= 1 )
+  {
+    for( int y = 0; y < 8; y++ )
+    {
+      if( !( y & step ) )
+      {
+        for( int x = 0; x < 8; x++ )
+        {
+          const int a = m[y][x];
+          const int b = m[y + step][x];
+          m[y][x]        = a + b;
+          m[y + step][x] = a - b;
+        }
+      }
+    }
+  }
+
+  int sumHad = 0;
+  for( int y = 0; y < 8; y++ )
+  {
+    for( int x = 0; x < 8; x++ )
+    {
+      sumHad += abs( m[y][x] );
+    }
+  }
+  if( !ref )
+  {
+    sumHad -= abs( m[0][0] );
+  }
+  return ( sumHad + 2 ) >> 2;
+}
+
+void EncRCLookahead::xEstimateCosts( const PelStorage& cur, const PelStorage* prev, RCLookaheadPic& pic ) const
+{
+  const CPelBuf curBuf       = cur.Y();
+  const int     stride       = curBuf.stride;
+  const int     widthInBlks  = curBuf.width  / m_blkSize;
+  const int     heightInBlks = curBuf.height / m_blkSize;
+  const int     ctuSizeSub   = m_ctuSize >> 1;
+  const int     widthInCtus  = ( m_sourceWidth  + m_ctuSize - 1 ) / m_ctuSize;
+  const int     heightInCtus = ( m_sourceHeight + m_ctuSize - 1 ) / m_ctuSize;
+
+  pic.intraCost = 0.0;
+  pic.interCost = 0.0;
+  pic.ctuCost.assign( widthInCtus * heightInCtus, 0.0 );
+
+  std::vector<Mv> mvs( widthInBlks * heightInBlks );
+
+  for( int by = 0; by < heightInBlks; by++ )
+  {
+    for( int bx = 0; bx < widthInBlks; bx++ )
+    {
+      const Pel* org       = curBuf.bufAt( bx * m_blkSize, by * m_blkSize );
+      const int  intraCost = xBlockHAD( org, nullptr, stride );
+      int        interCost = intraCost;
+
+      if( prev )
+      {
+        const Pel* ref = prev->Y().bufAt( bx * m_blkSize, by * m_blkSize );
+
+        // start from the zero vector and the vectors of the causal neighbours, then refine with a cross search
+        Mv  bestMv;
+        int bestSad = xBlockSAD( org, ref, stride );
+
+        Mv cands[3];
+        int numCands = 0;
+        if( bx > 0 )
+        {
+          cands[numCands++] = mvs[by * widthInBlks + bx - 1];
+        }
+        if( by > 0 )
+        {
+          cands[numCands++] = mvs[( by - 1 ) * widthInBlks + bx];
+          if( bx + 1 < widthInBlks )
+          {
+            cands[numCands++] = mvs[( by - 1 ) * widthInBlks + bx + 1];
+          }
+        }
+        for( int i = 0; i < numCands; i++ )
+        {
+          if( cands[i] != bestMv )
+          {
+            const int sad = xBlockSAD( org, ref + cands[i].ver * stride + cands[i].hor, stride );
+            if( sad < bestSad )
+            {
+              bestSad = sad;
+              bestMv  = cands[i];
+            }
+          }
+        }
+
+        static const int crossX[4] = { -1, 1, 0, 0 };
+        static const int crossY[4] = { 0, 0, -1, 1 };
+        for( int iter = 0; iter < m_searchRange; iter++ )
+        {
+          const Mv center = bestMv;
+          for( int i = 0; i < 4; i++ )
+          {
+            const Mv mv( center.hor + crossX[i], center.ver + crossY[i] );
+            if( abs( mv.hor ) <= m_searchRange && abs( mv.ver ) <= m_searchRange )
+            {
+              const int sad = xBlockSAD( org, ref + mv.ver * stride + mv.hor, stride );
+              if( sad < bestSad )
+              {
+                bestSad = sad;
+                bestMv  = mv;
+              }
+            }
+          }
+          if( bestMv == center )
+          {
+            break;
+          }
+        }
+
+        mvs[by * widthInBlks + bx] = bestMv;
+        interCost = xBlockHAD( org, ref + bestMv.ver * stride + bestMv.hor, stride );
+      }
+
+      pic.intraCost += intraCost;
+      pic.interCost += interCost;
+
+      const int ctuX = std::min( bx * m_blkSize / ctuSizeSub, widthInCtus  - 1 );
+      const int ctuY = std::min( by * m_blkSize / ctuSizeSub, heightInCtus - 1 );
+      pic.ctuCost[ctuY * widthInCtus + ctuX] += std::min( intraCost, interCost );
+    }
+  }
+}
+
+//! \}
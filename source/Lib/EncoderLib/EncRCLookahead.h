@@ -0,0 +1,146 @@
+/* The copyright in this software is being made available under the BSD
+* License, included below. This software may be subject to other third party
+* and contributor rights, including patent rights, and no such rights are
+* granted under this license.
+*
+* Copyright (c) 2010-2020, ITU/ISO/IEC
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+*  * Redistributions of source code must retain the above copyright notice,
+*    this list of conditions and the following disclaimer.
+*  * Redistributions in binary form must reproduce the above copyright notice,
+*    this list of conditions and the following disclaimer in the documentation
+*    and/or other materials provided with the distribution.
+*  * Neither the name of the ITU/ISO/IEC nor the names of its contributors may
+*    be used to endorse or promote products derived from this software without
+*    specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+* ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS
+* BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+* CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+* SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+* INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+* CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+* ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF
+* THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/** \file     EncRCLookahead.h
+    \brief    lookahead analysis for rate control (header)
+*/
+
+#ifndef __ENCRCLOOKAHEAD__
+#define __ENCRCLOOKAHEAD__
+
+#include "CommonLib/CommonDef.h"
+#include "CommonLib/Unit.h"
+#include "CommonLib/Buffer.h"
+#include "Utilities/VideoIOYuv.h"
+
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//! \ingroup EncoderLib
+//! \{
+
+// ====================================================================================================================
+// Class definition
+// ====================================================================================================================
+
+/// complexity estimate of one input picture, computed on the 2:1 downsampled luma
+struct RCLookaheadPic
+{
+  double              intraCost;    ///< Hadamard cost of the picture without its block DC
+  double              interCost;    ///< motion compensated Hadamard cost against the previous input picture
+  std::vector<double> ctuCost;      ///< min( intra, inter ) block costs summed per CTU in raster order
+
+  double getCost() const { return std::min( intraCost, interCost ); }
+};
+
+/// reads the input file ahead of the encoder in a separate thread and estimates the coding cost of each picture
+class EncRCLookahead
+{
+public:
+  EncRCLookahead();
+  ~EncRCLookahead();
+
+  void init( const int frameSkip,
+             const int temporalSubsampleRatio,
+             const int inputBitDepth[MAX_NUM_CHANNEL_TYPE],
+             const int msbExtendedBitDepth[MAX_NUM_CHANNEL_TYPE],
+             const int internalBitDepth[MAX_NUM_CHANNEL_TYPE],
+             const int width,
+             const int height,
+             const int *pad,
+             const bool rec709,
+             const std::string &filename,
+             const ChromaFormat chromaFormat,
+             const ChromaFormat inputChromaFormat,
+             const InputColourSpaceConversion colorSpaceConv,
+             const int ctuSize,
+             const int numFrames,
+             const int lookaheadFrames );
+  void destroy();
+
+  /// the encoder received input picture poc, the analysis may run up to poc + lookaheadFrames
+  void   advance           ( int poc );
+  /// cost of picture poc, waits until it is analysed (0 if not available)
+  double getPicCost        ( int poc );
+  /// average cost of the pictures firstPoc to lastPoc that exist in the input
+  double getAverageCost    ( int firstPoc, int lastPoc );
+  bool   getCtuCosts       ( int poc, std::vector<double>& ctuCosts );
+  int    getLookaheadFrames() const { return m_lookaheadFrames; }
+
+private:
+  static const int m_blkSize;
+  static const int m_searchRange;
+  static const int m_margin;
+  static const int m_historySize;
+
+  void xAnalyseFrames  ();
+  bool xWaitForPic     ( int poc, std::unique_lock<std::mutex>& lock );
+  void xSubsampleLuma  ( const CPelBuf& src, PelStorage& dst ) const;
+  int  xBlockSAD       ( const Pel* cur, const Pel* ref, const int stride ) const;
+  int  xBlockHAD       ( const Pel* cur, const Pel* ref, const int stride ) const;
+  void xEstimateCosts  ( const PelStorage& cur, const PelStorage* prev, RCLookaheadPic& pic ) const;
+
+  int                         m_frameSkip;
+  int                         m_temporalSubsampleRatio;
+  int                         m_inputBitDepth[MAX_NUM_CHANNEL_TYPE];
+  int                         m_MSBExtendedBitDepth[MAX_NUM_CHANNEL_TYPE];
+  int                         m_internalBitDepth[MAX_NUM_CHANNEL_TYPE];
+  int                         m_sourceWidth;
+  int                         m_sourceHeight;
+  int                         m_pad[2];
+  bool                        m_clipInputVideoToRec709Range;
+  std::string                 m_inputFileName;
+  ChromaFormat                m_chromaFormatIDC;
+  ChromaFormat                m_inputChromaFormatIDC;
+  InputColourSpaceConversion  m_inputColourSpaceConvert;
+  int                         m_ctuSize;
+  int                         m_numFrames;
+  int                         m_lookaheadFrames;
+
+  std::thread                 m_thread;
+  std::mutex                  m_mutex;
+  std::condition_variable     m_cond;
+  std::map<int, RCLookaheadPic> m_pics;
+  int                         m_receivedPoc;
+  int                         m_analysedPoc;
+  bool                        m_finished;
+  bool                        m_stop;
+};
+
+//! \}
+
+#endif // __ENCRCLOOKAHEAD__
@@ -670,7 +670,6 @@ void EncSlice::initEncSlice(Picture* pcPic, const int pocLast, const int pocCurr
 
   if( ( m_pcCfg->getIBCHashSearch() && m_pcCfg->getIBCMode() ) || m_pcCfg->getAllowDisFracMMVD() )
   {
-    m_pcCuEncoder->getIbcHashMap().destroy();
     m_pcCuEncoder->getIbcHashMap().init( pcPic->cs->pps->getPicWidthInLumaSamples(), pcPic->cs->pps->getPicHeightInLumaSamples() );
   }
 }
@@ -1149,9 +1148,21 @@ void EncSlice::precompressSlice( Picture* pcPic )
     dFrameLambda = 0.68 * pow (2, (m_viRdPicQp[0] - SHIFT_QP) / 3.0);
   }
 
+  // the candidates alternate between decreasing (odd index) and increasing (even index) QP offsets, with early
+  // termination a direction is abandoned once a step in it does not lower the cost
+  const bool earlyTerm        = m_pcCfg->getDeltaQpRDEarlyTerm();
+  double     dPicRdCostDir[2] = { MAX_DOUBLE, MAX_DOUBLE };
+  bool       dirStopped   [2] = { false, false };
+
   // for each QP candidate
   for ( uint32_t uiQpIdx = 0; uiQpIdx < 2 * m_pcCfg->getDeltaQpRD() + 1; uiQpIdx++ )
   {
+    const int dir = uiQpIdx & 1;
+    if( earlyTerm && uiQpIdx > 0 && dirStopped[dir] )
+    {
+      continue;
+    }
+
     pcSlice       ->setSliceQp             ( m_viRdPicQp    [uiQpIdx] );
     setUpLambda(pcSlice, m_vdRdPicLambda[uiQpIdx], m_viRdPicQp    [uiQpIdx]);
 
@@ -1174,6 +1185,16 @@ void EncSlice::precompressSlice( Picture* pcPic )
       uiQpIdxBest    = uiQpIdx;
       dPicRdCostBest = dPicRdCost;
     }
+
+    if( uiQpIdx == 0 )
+    {
+      dPicRdCostDir[0] = dPicRdCostDir[1] = dPicRdCost;
+    }
+    else
+    {
+      dirStopped   [dir] = dPicRdCost >= dPicRdCostDir[dir];
+      dPicRdCostDir[dir] = dPicRdCost;
+    }
   }
 
   // set best values
@@ -1321,7 +1342,7 @@ void EncSlice::compressSlice( Picture* pcPic, const bool bCompressEntireSlice, c
 #endif
   m_pcInterSearch->resetAffineMVList();
   m_pcInterSearch->resetUniMvList();
-  ::memset(g_isReusedUniMVsFilled, 0, sizeof(g_isReusedUniMVsFilled));
+  m_pcInterSearch->resetReusedUniMvs();
   encodeCtus( pcPic, bCompressEntireSlice, bFastDeltaQP, m_pcLib );
   if (checkPLTRatio) m_pcLib->checkPltStats( pcPic );
 }
@@ -1443,7 +1464,11 @@ void EncSlice::encodeCtus( Picture* pcPic, const bool bCompressEntireSlice, cons
   if ( pcSlice->getSPS()->getFpelMmvdEnabledFlag() ||
       (pcSlice->getSPS()->getIBCFlag() && m_pcCuEncoder->getEncCfg()->getIBCHashSearch()))
   {
-    m_pcCuEncoder->getIbcHashMap().rebuildPicHashMap(cs.picture->getTrueOrigBuf());
+    // the map covers the whole original picture, it is built once and reused by the other slices and QP trials
+    if (!m_pcCuEncoder->getIbcHashMap().isPicHashMapValid())
+    {
+      m_pcCuEncoder->getIbcHashMap().rebuildPicHashMap(cs.picture->getTrueOrigBuf());
+    }
     if (m_pcCfg->getIntraPeriod() != -1)
     {
       int hashBlkHitPerc = m_pcCuEncoder->getIbcHashMap().calHashBlkMatchPerc(cs.area.Y());
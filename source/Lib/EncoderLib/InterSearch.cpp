@@ -125,6 +125,8 @@ InterSearch::InterSearch()
   m_uniMvList = nullptr;
   m_uniMvListSize = 0;
   m_uniMvListIdx = 0;
+  m_reusedUniMVs = nullptr;
+  m_isReusedUniMVsFilled = nullptr;
   m_histBestSbt    = MAX_UCHAR;
   m_histBestMtsIdx = MAX_UCHAR;
 
@@ -177,6 +179,10 @@ void InterSearch::destroy()
   }
   m_uniMvListIdx = 0;
   m_uniMvListSize = 0;
+  delete[] m_reusedUniMVs;
+  m_reusedUniMVs = nullptr;
+  delete[] m_isReusedUniMVsFilled;
+  m_isReusedUniMVsFilled = nullptr;
   m_isInitialized = false;
 }
 
@@ -283,9 +289,24 @@ void InterSearch::init( EncCfg*        pcEncCfg,
   }
   m_uniMvListIdx = 0;
   m_uniMvListSize = 0;
+  if( !m_reusedUniMVs )
+  {
+    m_reusedUniMVs         = new Mv[32][32][8][8][2][33];
+    m_isReusedUniMVsFilled = new bool[32][32][8][8]();
+  }
   m_isInitialized = true;
 }
 
+void InterSearch::insertReusedUniMvCands( const CompArea& blkArea, const PreCalcValues& pcv )
+{
+  unsigned idx1, idx2, idx3, idx4;
+  getAreaIdx( blkArea, pcv, idx1, idx2, idx3, idx4 );
+  if( m_isReusedUniMVsFilled[idx1][idx2][idx3][idx4] )
+  {
+    insertUniMvCands( blkArea, m_reusedUniMVs[idx1][idx2][idx3][idx4] );
+  }
+}
+
 void InterSearch::resetSavedAffineMotion()
 {
   for ( int i = 0; i < 2; i++ )
@@ -2470,8 +2491,8 @@ void InterSearch::predInterSearch(CodingUnit& cu, Partitioner& partitioner)
 
         unsigned idx1, idx2, idx3, idx4;
         getAreaIdx(cu.Y(), *cu.slice->getPPS()->pcv, idx1, idx2, idx3, idx4);
-        ::memcpy(&(g_reusedUniMVs[idx1][idx2][idx3][idx4][0][0]), cMvTemp, 2 * 33 * sizeof(Mv));
-        g_isReusedUniMVsFilled[idx1][idx2][idx3][idx4] = true;
+        ::memcpy(&(m_reusedUniMVs[idx1][idx2][idx3][idx4][0][0]), cMvTemp, 2 * 33 * sizeof(Mv));
+        m_isReusedUniMVsFilled[idx1][idx2][idx3][idx4] = true;
       }
       //  Bi-predictive Motion estimation
       if( ( cs.slice->isInterB() ) && ( PU::isBipredRestriction( pu ) == false )
@@ -126,6 +126,8 @@ private:
   int             m_uniMvListIdx;
   int             m_uniMvListSize;
   int             m_uniMvListMaxSize;
+  Mv            (*m_reusedUniMVs)[32][8][8][2][33];   ///< uni-prediction MVs per block area, kept per encoder so that encoders can run concurrently
+  bool          (*m_isReusedUniMVsFilled)[32][8][8];
   Distortion      m_hevcCost;
   EncAffineMotion m_affineMotion;
   PatentBvCand    m_defaultCachedBvs;
@@ -272,6 +274,8 @@ public:
       m_uniMvListIdx = (m_uniMvListIdx + 1) % (m_uniMvListMaxSize);
     }
   }
+  void resetReusedUniMvs() { ::memset( m_isReusedUniMVsFilled, 0, 32 * sizeof( *m_isReusedUniMVsFilled ) ); }
+  void insertReusedUniMvCands( const CompArea& blkArea, const PreCalcValues& pcv );
   void savePrevUniMvInfo(CompArea blkArea, BlkUniMvInfo &tmpUniMvInfo, bool& isUniMvInfoSaved)
   {
     int j = 0;
@@ -87,42 +87,39 @@ void write(ostream& out, OutputNALUnit& nalu)
    *  - 0x00000302
    *  - 0x00000303
    */
-  vector<uint8_t>& rbsp   = nalu.m_Bitstream.getFIFO();
+  const vector<uint8_t>& rbsp = nalu.m_Bitstream.getFIFO();
+  const char*   data   = reinterpret_cast<const char*>(rbsp.data());
+  const size_t  size   = rbsp.size();
+  size_t        pos    = 0;  // first byte not yet written
+  size_t        scan   = 0;  // first byte that may start a zero pair
 
-  vector<uint8_t> outputBuffer;
-  outputBuffer.resize(rbsp.size()*2+1); //there can never be enough emulation_prevention_three_bytes to require this much space
-  std::size_t outputAmount = 0;
-  int         zeroCount    = 0;
-  for (vector<uint8_t>::iterator it = rbsp.begin(); it != rbsp.end(); it++)
+  // jump from one 00 00 pair to the next, the bytes in between are written in one go
+  while (scan < size)
   {
-    const uint8_t v=(*it);
-    if (zeroCount==2 && v<=3)
+    const size_t zeroPos = scan + g_bitstreamOps.findZeroPair(rbsp.data() + scan, size - scan);
+    if (zeroPos + 2 >= size)
     {
-      outputBuffer[outputAmount++]=emulation_prevention_three_byte;
-      zeroCount=0;
+      break;
     }
-
-    if (v==0)
-    {
-      zeroCount++;
-    }
-    else
+    if (rbsp[zeroPos + 2] <= 3)
     {
-      zeroCount=0;
+      out.write(data + pos, zeroPos + 2 - pos);
+      out.put(emulation_prevention_three_byte);
+      pos = zeroPos + 2;
     }
-    outputBuffer[outputAmount++]=v;
+    scan = zeroPos + 2;
   }
+  out.write(data + pos, size - pos);
 
   /* 7.4.1.1
    * ... when the last byte of the RBSP data is equal to 0x00 (which can
    * only occur when the RBSP ends in a cabac_zero_word), a final byte equal
    * to 0x03 is appended to the end of the data.
    */
-  if (zeroCount>0)
+  if (size > 0 && rbsp[size - 1] == 0)
   {
-    outputBuffer[outputAmount++]=emulation_prevention_three_byte;
+    out.put(emulation_prevention_three_byte);
   }
-  out.write(reinterpret_cast<const char*>(&(*outputBuffer.begin())), outputAmount);
 }
 
 //! \}
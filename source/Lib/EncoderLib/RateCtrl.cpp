@@ -308,6 +308,8 @@ EncRCGOP::EncRCGOP()
   m_bitsLeft   = 0;
   m_minEstLambda = 0.0;
   m_maxEstLambda = 0.0;
+  m_gopCost      = 0.0;
+  m_refCost      = 0.0;
 }
 
 EncRCGOP::~EncRCGOP()
@@ -315,9 +317,38 @@ EncRCGOP::~EncRCGOP()
   destroy();
 }
 
-void EncRCGOP::create( EncRCSeq* encRCSeq, int numPic )
+void EncRCGOP::create( EncRCSeq* encRCSeq, int numPic, const std::vector<double>* picCosts, double refCost )
 {
   destroy();
+
+  // lookahead costs of the pictures in coding order, zero for pictures without an estimate
+  m_gopCost = 0.0;
+  m_refCost = refCost;
+  if ( picCosts != NULL )
+  {
+    int numKnownPics = 0;
+    for ( int i=0; i<numPic; i++ )
+    {
+      if ( (*picCosts)[i] > 0.0 )
+      {
+        m_gopCost += (*picCosts)[i];
+        numKnownPics++;
+      }
+    }
+    if ( numKnownPics > 0 )
+    {
+      m_gopCost /= numKnownPics;
+      m_picCostWeight.resize( numPic, 1.0 );
+      for ( int i=0; i<numPic; i++ )
+      {
+        if ( (*picCosts)[i] > 0.0 )
+        {
+          m_picCostWeight[i] = Clip3( g_RCLookaheadMinRatio, g_RCLookaheadMaxRatio, pow( (*picCosts)[i] / m_gopCost, g_RCLookaheadPicExponent ) );
+        }
+      }
+    }
+  }
+
   int targetBits = xEstGOPTargetBits( encRCSeq, numPic );
 
   if ( encRCSeq->getAdaptiveBits() > 0 && encRCSeq->getLastLambda() > 0.1 )
@@ -461,15 +492,15 @@ void EncRCGOP::create( EncRCSeq* encRCSeq, int numPic )
 
   m_picTargetBitInGOP = new int[numPic];
   int i;
-  int totalPicRatio = 0;
-  int currPicRatio = 0;
+  double totalPicRatio = 0;
+  double currPicRatio = 0;
   for ( i=0; i<numPic; i++ )
   {
-    totalPicRatio += encRCSeq->getBitRatio( i );
+    totalPicRatio += encRCSeq->getBitRatio( i ) * getPicCostWeight( i );
   }
   for ( i=0; i<numPic; i++ )
   {
-    currPicRatio = encRCSeq->getBitRatio( i );
+    currPicRatio = encRCSeq->getBitRatio( i ) * getPicCostWeight( i );
     m_picTargetBitInGOP[i] = (int)( ((double)targetBits) * currPicRatio / totalPicRatio );
   }
 
@@ -541,6 +572,7 @@ void EncRCGOP::destroy()
     delete[] m_picTargetBitInGOP;
     m_picTargetBitInGOP = NULL;
   }
+  m_picCostWeight.clear();
 }
 
 void EncRCGOP::updateAfterPicture( int bitsCost )
@@ -556,6 +588,12 @@ int EncRCGOP::xEstGOPTargetBits( EncRCSeq* encRCSeq, int GOPSize )
   int currentTargetBitsPerPic = (int)( ( encRCSeq->getBitsLeft() - averageTargetBitsPerPic * (encRCSeq->getFramesLeft() - realInfluencePicture) ) / realInfluencePicture );
   int targetBits = currentTargetBitsPerPic * GOPSize;
 
+  if ( m_gopCost > 0.0 && m_refCost > 0.0 )
+  {
+    // spend more on a GOP that is costlier than its surrounding window, the smoothing window pays it back
+    targetBits = int( targetBits * Clip3( g_RCLookaheadMinRatio, g_RCLookaheadMaxRatio, pow( m_gopCost / m_refCost, g_RCLookaheadGOPExponent ) ) );
+  }
+
   if ( targetBits < 200 )
   {
     targetBits = 200;   // at least allocate 200 bits for one GOP
@@ -603,11 +641,11 @@ int EncRCPic::xEstPicTargetBits( EncRCSeq* encRCSeq, EncRCGOP* encRCGOP )
 
   int i;
   int currPicPosition = encRCGOP->getNumPic()-encRCGOP->getPicLeft();
-  int currPicRatio    = encRCSeq->getBitRatio( currPicPosition );
-  int totalPicRatio   = 0;
+  double currPicRatio = encRCSeq->getBitRatio( currPicPosition ) * encRCGOP->getPicCostWeight( currPicPosition );
+  double totalPicRatio = 0;
   for ( i=currPicPosition; i<encRCGOP->getNumPic(); i++ )
   {
-    totalPicRatio += encRCSeq->getBitRatio( i );
+    totalPicRatio += encRCSeq->getBitRatio( i ) * encRCGOP->getPicCostWeight( i );
   }
 
   targetBits  = int( ((double)GOPbitsLeft) * currPicRatio / totalPicRatio );
@@ -702,7 +740,7 @@ void EncRCPic::addToPictureLsit( list<EncRCPic*>& listPreviousPictures )
   listPreviousPictures.push_back( this );
 }
 
-void EncRCPic::create( EncRCSeq* encRCSeq, EncRCGOP* encRCGOP, int frameLevel, list<EncRCPic*>& listPreviousPictures )
+void EncRCPic::create( EncRCSeq* encRCSeq, EncRCGOP* encRCGOP, int frameLevel, list<EncRCPic*>& listPreviousPictures, const std::vector<double>* ctuCosts )
 {
   destroy();
   m_encRCSeq = encRCSeq;
@@ -757,6 +795,12 @@ void EncRCPic::create( EncRCSeq* encRCSeq, EncRCGOP* encRCGOP, int frameLevel, l
       m_LCUs[LCUIdx].m_numberOfPixel = currWidth * currHeight;
     }
   }
+  m_ctuCosts.clear();
+  if ( ctuCosts != NULL )
+  {
+    CHECK( (int)ctuCosts->size() != m_numberOfLCU, "Lookahead CTU costs do not match the number of CTUs" );
+    m_ctuCosts = *ctuCosts;
+  }
   m_picActualHeaderBits = 0;
   m_picActualBits       = 0;
   m_picQP               = 0;
@@ -879,9 +923,19 @@ double EncRCPic::estimatePicLambda( list<EncRCPic*>& listPreviousPictures, bool
     }
     totalWeight += m_LCUs[i].m_bitWeight;
   }
+  double totalCtuCost = 0.0;
+  for ( int i=0; i<(int)m_ctuCosts.size(); i++ )
+  {
+    totalCtuCost += m_ctuCosts[i];
+  }
   for ( int i=0; i<m_numberOfLCU; i++ )
   {
     double BUTargetBits = m_targetBits * m_LCUs[i].m_bitWeight / totalWeight;
+    if ( totalCtuCost > 0.0 )
+    {
+      // blend the model based allocation with the share of the CTU in the lookahead cost of the picture
+      BUTargetBits = ( 1.0 - g_RCLookaheadCtuWeight ) * BUTargetBits + g_RCLookaheadCtuWeight * m_targetBits * m_ctuCosts[i] / totalCtuCost;
+    }
     m_LCUs[i].m_bitWeight = BUTargetBits;
   }
 
@@ -1811,16 +1865,16 @@ void RateCtrl::init(int totalFrames, int targetBitrate, int frameRate, int GOPSi
   delete[] GOPID2Level;
 }
 
-void RateCtrl::initRCPic( int frameLevel )
+void RateCtrl::initRCPic( int frameLevel, const std::vector<double>* ctuCosts )
 {
   m_encRCPic = new EncRCPic;
-  m_encRCPic->create( m_encRCSeq, m_encRCGOP, frameLevel, m_listRCPictures );
+  m_encRCPic->create( m_encRCSeq, m_encRCGOP, frameLevel, m_listRCPictures, ctuCosts );
 }
 
-void RateCtrl::initRCGOP( int numberOfPictures )
+void RateCtrl::initRCGOP( int numberOfPictures, const std::vector<double>* picCosts, double refCost )
 {
   m_encRCGOP = new EncRCGOP;
-  m_encRCGOP->create( m_encRCSeq, numberOfPictures );
+  m_encRCGOP->create( m_encRCSeq, numberOfPictures, picCosts, refCost );
 }
 
 #if U0132_TARGET_BITS_SATURATION
@@ -69,6 +69,11 @@ const double g_RCAlphaMinValue = 0.05;
 const double g_RCAlphaMaxValue = 500.0;
 const double g_RCBetaMinValue  = -3.0;
 const double g_RCBetaMaxValue  = -0.1;
+const double g_RCLookaheadGOPExponent = 0.5;   // GOP target bits scale with (GOP cost / window cost)^exponent
+const double g_RCLookaheadPicExponent = 0.5;   // picture bit ratios scale with (picture cost / GOP cost)^exponent
+const double g_RCLookaheadMinRatio    = 0.5;
+const double g_RCLookaheadMaxRatio    = 2.0;
+const double g_RCLookaheadCtuWeight   = 0.5;   // share of the CTU bit allocation that follows the lookahead CTU costs
 
 #define ALPHA     6.7542;
 #define BETA1     1.2517
@@ -193,7 +198,7 @@ public:
   ~EncRCGOP();
 
 public:
-  void create( EncRCSeq* encRCSeq, int numPic );
+  void create( EncRCSeq* encRCSeq, int numPic, const std::vector<double>* picCosts = NULL, double refCost = 0.0 );
   void destroy();
   void updateAfterPicture( int bitsCost );
 
@@ -211,10 +216,14 @@ public:
   int  getTargetBitInGOP( int i ) { return m_picTargetBitInGOP[i]; }
   double getMinEstLambda()        { return m_minEstLambda; }
   double getMaxEstLambda()        { return m_maxEstLambda; }
+  double getPicCostWeight( int i ) { return m_picCostWeight.empty() ? 1.0 : m_picCostWeight[i]; }
 
 private:
   EncRCSeq* m_encRCSeq;
   int* m_picTargetBitInGOP;
+  std::vector<double> m_picCostWeight;    // lookahead weights of the bit ratios in coding order, empty without lookahead
+  double m_gopCost;
+  double m_refCost;
   int m_numPic;
   int m_targetBits;
   int m_picLeft;
@@ -230,7 +239,7 @@ public:
   ~EncRCPic();
 
 public:
-  void create( EncRCSeq* encRCSeq, EncRCGOP* encRCGOP, int frameLevel, list<EncRCPic*>& listPreviousPictures );
+  void create( EncRCSeq* encRCSeq, EncRCGOP* encRCGOP, int frameLevel, list<EncRCPic*>& listPreviousPictures, const std::vector<double>* ctuCosts = NULL );
   void destroy();
 
   int    estimatePicQP    ( double lambda, list<EncRCPic*>& listPreviousPictures );
@@ -318,6 +327,7 @@ private:
   int m_pixelsLeft;
 
   TRCLCU* m_LCUs;
+  std::vector<double> m_ctuCosts;   // lookahead cost per CTU, empty without lookahead
   int m_picActualHeaderBits;    // only SH and potential APS
   double m_totalCostIntra;
   double m_remainingCostIntra;
@@ -337,8 +347,8 @@ public:
 public:
   void init(int totalFrames, int targetBitrate, int frameRate, int GOPSize, int picWidth, int picHeight, int LCUWidth, int LCUHeight, int bitDepth, int keepHierBits, bool useLCUSeparateModel, GOPEntry GOPList[MAX_GOP]);
   void destroy();
-  void initRCPic( int frameLevel );
-  void initRCGOP( int numberOfPictures );
+  void initRCPic( int frameLevel, const std::vector<double>* ctuCosts = NULL );
+  void initRCGOP( int numberOfPictures, const std::vector<double>* picCosts = NULL, double refCost = 0.0 );
   void destroyRCGOP();
 
 public: